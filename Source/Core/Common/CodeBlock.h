@@ -91,6 +91,8 @@ public:
     Common::UnWriteProtectMemory(region, region_size, allow_execute);
   }
   void ResetCodePtr() { T::SetCodePtr(region, region + region_size); }
+  u8* GetRegion() const { return region; }
+  size_t GetRegionSize() const { return region_size; }
   size_t GetSpaceLeft() const
   {
     ASSERT(static_cast<size_t>(T::GetCodePtr() - region) < region_size);
@@ -9,68 +9,34 @@
 
 namespace Common
 {
+// Indexed by sign | (mantissa != 0) << 1 | (exponent == 0) << 2 | (exponent == max) << 3. Looking
+// the class up avoids the data-dependent branches of classifying the value step by step, which
+// mispredict often when the interpreter is running code that mixes zeroes and normal numbers.
+static constexpr std::array<u8, 16> s_fp_class_table = {{
+    PPC_FPCLASS_PN, PPC_FPCLASS_NN, PPC_FPCLASS_PN, PPC_FPCLASS_NN,          // Normalized
+    PPC_FPCLASS_PZ, PPC_FPCLASS_NZ, PPC_FPCLASS_PD, PPC_FPCLASS_ND,          // Zero exponent
+    PPC_FPCLASS_PINF, PPC_FPCLASS_NINF, PPC_FPCLASS_QNAN, PPC_FPCLASS_QNAN,  // Max exponent
+    PPC_FPCLASS_QNAN, PPC_FPCLASS_QNAN, PPC_FPCLASS_QNAN, PPC_FPCLASS_QNAN,  // Unreachable
+}};
+
 u32 ClassifyDouble(double dvalue)
 {
   const u64 ivalue = BitCast<u64>(dvalue);
-  const u64 sign = ivalue & DOUBLE_SIGN;
   const u64 exp = ivalue & DOUBLE_EXP;
 
-  if (exp > DOUBLE_ZERO && exp < DOUBLE_EXP)
-  {
-    // Nice normalized number.
-    return sign ? PPC_FPCLASS_NN : PPC_FPCLASS_PN;
-  }
-
-  const u64 mantissa = ivalue & DOUBLE_FRAC;
-  if (mantissa)
-  {
-    if (exp)
-      return PPC_FPCLASS_QNAN;
-
-    // Denormalized number.
-    return sign ? PPC_FPCLASS_ND : PPC_FPCLASS_PD;
-  }
-
-  if (exp)
-  {
-    // Infinite
-    return sign ? PPC_FPCLASS_NINF : PPC_FPCLASS_PINF;
-  }
-
-  // Zero
-  return sign ? PPC_FPCLASS_NZ : PPC_FPCLASS_PZ;
+  const u32 index = static_cast<u32>(ivalue >> 63) | u32((ivalue & DOUBLE_FRAC) != 0) << 1 |
+                    u32(exp == 0) << 2 | u32(exp == DOUBLE_EXP) << 3;
+  return s_fp_class_table[index];
 }
 
 u32 ClassifyFloat(float fvalue)
 {
   const u32 ivalue = BitCast<u32>(fvalue);
-  const u32 sign = ivalue & FLOAT_SIGN;
   const u32 exp = ivalue & FLOAT_EXP;
 
-  if (exp > FLOAT_ZERO && exp < FLOAT_EXP)
-  {
-    // Nice normalized number.
-    return sign ? PPC_FPCLASS_NN : PPC_FPCLASS_PN;
-  }
-
-  const u32 mantissa = ivalue & FLOAT_FRAC;
-  if (mantissa)
-  {
-    if (exp)
-      return PPC_FPCLASS_QNAN;  // Quiet NAN
-
-    // Denormalized number.
-    return sign ? PPC_FPCLASS_ND : PPC_FPCLASS_PD;
-  }
-
-  if (exp)
-  {
-    // Infinite
-    return sign ? PPC_FPCLASS_NINF : PPC_FPCLASS_PINF;
-  }
-
-  // Zero
-  return sign ? PPC_FPCLASS_NZ : PPC_FPCLASS_PZ;
+  const u32 index = (ivalue >> 31) | u32((ivalue & FLOAT_FRAC) != 0) << 1 | u32(exp == 0) << 2 |
+                    u32(exp == FLOAT_EXP) << 3;
+  return s_fp_class_table[index];
 }
 
 const std::array<BaseAndDec, 32> frsqrte_expected = {{
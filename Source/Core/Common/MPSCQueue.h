@@ -0,0 +1,101 @@
+// Copyright 2026 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+// A bounded lockless thread-safe,
+// multiple producer, single consumer queue
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+namespace Common
+{
+template <typename T, size_t Capacity>
+class MPSCQueue
+{
+  static_assert(Capacity != 0 && (Capacity & (Capacity - 1)) == 0,
+                "Capacity must be a power of two");
+
+public:
+  MPSCQueue()
+  {
+    for (size_t i = 0; i < Capacity; ++i)
+      m_slots[i].sequence.store(i, std::memory_order_relaxed);
+  }
+
+  MPSCQueue(const MPSCQueue&) = delete;
+  MPSCQueue& operator=(const MPSCQueue&) = delete;
+
+  // Can be called from any thread. Returns false without blocking if the queue is full.
+  template <typename Arg>
+  bool TryPush(Arg&& t)
+  {
+    size_t position = m_write_position.load(std::memory_order_relaxed);
+    while (true)
+    {
+      Slot& slot = m_slots[position & (Capacity - 1)];
+      const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+      const auto difference = static_cast<std::ptrdiff_t>(sequence - position);
+
+      if (difference == 0)
+      {
+        // The slot is free, try to claim it.
+        if (m_write_position.compare_exchange_weak(position, position + 1,
+                                                   std::memory_order_relaxed))
+        {
+          slot.value = std::forward<Arg>(t);
+          slot.sequence.store(position + 1, std::memory_order_release);
+          return true;
+        }
+      }
+      else if (difference < 0)
+      {
+        // The consumer hasn't freed the slot yet.
+        return false;
+      }
+      else
+      {
+        // Another producer claimed the slot first.
+        position = m_write_position.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  // Must only be called from the consumer thread.
+  bool Empty() const
+  {
+    const Slot& slot = m_slots[m_read_position & (Capacity - 1)];
+    return slot.sequence.load(std::memory_order_acquire) != m_read_position + 1;
+  }
+
+  // Must only be called from the consumer thread.
+  bool Pop(T& t)
+  {
+    Slot& slot = m_slots[m_read_position & (Capacity - 1)];
+    if (slot.sequence.load(std::memory_order_acquire) != m_read_position + 1)
+      return false;
+
+    t = std::move(slot.value);
+    slot.sequence.store(m_read_position + Capacity, std::memory_order_release);
+    ++m_read_position;
+    return true;
+  }
+
+private:
+  struct Slot
+  {
+    // Equals the write position that may claim the slot when it's free, and that position plus
+    // one once the element has been written.
+    std::atomic<size_t> sequence;
+    T value{};
+  };
+
+  std::array<Slot, Capacity> m_slots;
+  // Producers and the consumer write these at a high rate, so keep them on separate cache lines.
+  alignas(64) std::atomic<size_t> m_write_position{0};
+  alignas(64) size_t m_read_position = 0;
+};
+}  // namespace Common
@@ -46,8 +46,10 @@ public:
   /// @param size The amount of bytes that should be allocated in this region.
   /// @param base_name A base name for the shared memory region, if applicable for this platform.
   /// Will be extended with the process ID.
+  /// @param huge_pages Whether to ask the OS to back the segment with transparent huge pages, if
+  /// supported on this platform. See GetHugePageSize().
   ///
-  void GrabSHMSegment(size_t size, std::string_view base_name);
+  void GrabSHMSegment(size_t size, std::string_view base_name, bool huge_pages = false);
 
   ///
   /// Release the memory segment previously allocated with GrabSHMSegment().
@@ -111,6 +113,15 @@ public:
   ///
   void UnmapFromMemoryRegion(void* view, size_t size);
 
+  ///
+  /// Get the size of the huge pages that GrabSHMSegment() can back the memory segment with.
+  /// A view can only use them where its address and its offset within the memory segment are
+  /// both aligned to that size.
+  ///
+  /// @return The size of huge pages, or 0 if they aren't supported on this platform.
+  ///
+  static size_t GetHugePageSize();
+
 private:
 #ifdef _WIN32
   WindowsMemoryRegion* EnsureSplitRegionForMapping(void* address, size_t size);
@@ -124,6 +135,8 @@ private:
   int m_shm_fd = 0;
   void* m_reserved_region = nullptr;
   std::size_t m_reserved_region_size = 0;
+  // Non-zero if the memory segment should be backed by huge pages of that size.
+  std::size_t m_huge_page_size = 0;
 #endif
 };
 
@@ -65,7 +65,7 @@ static int AshmemCreateFileMapping(const char* name, size_t size)
 MemArena::MemArena() = default;
 MemArena::~MemArena() = default;
 
-void MemArena::GrabSHMSegment(size_t size, std::string_view base_name)
+void MemArena::GrabSHMSegment(size_t size, std::string_view base_name, bool huge_pages)
 {
   const std::string name = fmt::format("{}.{}", base_name, getpid());
   m_shm_fd = AshmemCreateFileMapping(name.c_str(), size);
@@ -144,6 +144,11 @@ void MemArena::UnmapFromMemoryRegion(void* view, size_t size)
     NOTICE_LOG_FMT(MEMMAP, "mmap failed");
 }
 
+size_t MemArena::GetHugePageSize()
+{
+  return 0;
+}
+
 LazyMemoryRegion::LazyMemoryRegion() = default;
 
 LazyMemoryRegion::~LazyMemoryRegion()
@@ -5,6 +5,7 @@
 
 #include <cerrno>
 #include <cstddef>
+#include <cstdint>
 #include <cstdlib>
 #include <cstring>
 #include <set>
@@ -16,9 +17,11 @@
 #include <sys/mman.h>
 #include <unistd.h>
 
+#include "Common/Align.h"
 #include "Common/Assert.h"
 #include "Common/CommonFuncs.h"
 #include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
 #include "Common/Logging/Log.h"
 #include "Common/MsgHandler.h"
 #include "Common/StringUtil.h"
@@ -28,8 +31,48 @@ namespace Common
 MemArena::MemArena() = default;
 MemArena::~MemArena() = default;
 
-void MemArena::GrabSHMSegment(size_t size, std::string_view base_name)
+#ifdef __linux__
+// Huge pages only get used for shared memory if the kernel has been configured to allow it.
+static bool AreSHMHugePagesEnabled()
 {
+  std::string shmem_enabled;
+  if (!File::ReadFileToString("/sys/kernel/mm/transparent_hugepage/shmem_enabled", shmem_enabled))
+    return false;
+
+  return shmem_enabled.find("[always]") != std::string::npos ||
+         shmem_enabled.find("[within_size]") != std::string::npos ||
+         shmem_enabled.find("[advise]") != std::string::npos ||
+         shmem_enabled.find("[force]") != std::string::npos;
+}
+#endif
+
+void MemArena::GrabSHMSegment(size_t size, std::string_view base_name, bool huge_pages)
+{
+  m_huge_page_size = 0;
+
+#ifdef __linux__
+  // Unlike memfds, the segments created by shm_open follow the huge page setting of the tmpfs
+  // mounted at /dev/shm, which is never to use them by default.
+  if (huge_pages && GetHugePageSize() != 0)
+  {
+    const std::string memfd_name = fmt::format("{}.{}", base_name, getpid());
+    m_shm_fd = memfd_create(memfd_name.c_str(), MFD_CLOEXEC);
+    if (m_shm_fd != -1)
+    {
+      if (!AreSHMHugePagesEnabled())
+      {
+        WARN_LOG_FMT(MEMMAP, "Huge pages for shared memory are disabled in "
+                             "/sys/kernel/mm/transparent_hugepage/shmem_enabled");
+      }
+      m_huge_page_size = GetHugePageSize();
+      if (ftruncate(m_shm_fd, size) < 0)
+        ERROR_LOG_FMT(MEMMAP, "Failed to allocate low memory space");
+      return;
+    }
+    WARN_LOG_FMT(MEMMAP, "memfd_create failed, not using huge pages: {}", strerror(errno));
+  }
+#endif
+
   const std::string file_name = fmt::format("/{}.{}", base_name, getpid());
   m_shm_fd = shm_open(file_name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
   if (m_shm_fd == -1)
@@ -47,16 +90,61 @@ void MemArena::ReleaseSHMSegment()
   close(m_shm_fd);
 }
 
+// Reserves an address range of the given size that starts at the given offset from an address
+// aligned to alignment.
+static void* ReserveAlignedRegion(size_t size, size_t alignment, size_t offset)
+{
+  const size_t reserved_size = size + alignment;
+  void* reserved = mmap(nullptr, reserved_size, PROT_NONE, MAP_ANON | MAP_PRIVATE, -1, 0);
+  if (reserved == MAP_FAILED)
+    return MAP_FAILED;
+
+  const uintptr_t reserved_start = reinterpret_cast<uintptr_t>(reserved);
+  uintptr_t start = Common::AlignUp(reserved_start, alignment) + offset % alignment;
+  if (start - reserved_start >= alignment)
+    start -= alignment;
+
+  // Give back what we don't need on both sides.
+  if (start != reserved_start)
+    munmap(reserved, start - reserved_start);
+  const uintptr_t end = start + size;
+  const uintptr_t reserved_end = reserved_start + reserved_size;
+  if (end != reserved_end)
+    munmap(reinterpret_cast<void*>(end), reserved_end - end);
+
+  return reinterpret_cast<void*>(start);
+}
+
 void* MemArena::CreateView(s64 offset, size_t size)
 {
-  void* retval = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, m_shm_fd, offset);
+  void* base = nullptr;
+  int flags = MAP_SHARED;
+  if (m_huge_page_size != 0)
+  {
+    // The kernel can only map a huge page where the address and the offset are both aligned.
+    base = ReserveAlignedRegion(size, m_huge_page_size, static_cast<size_t>(offset));
+    if (base == MAP_FAILED)
+    {
+      NOTICE_LOG_FMT(MEMMAP, "mmap failed");
+      return nullptr;
+    }
+    flags |= MAP_FIXED;
+  }
+
+  void* retval = mmap(base, size, PROT_READ | PROT_WRITE, flags, m_shm_fd, offset);
   if (retval == MAP_FAILED)
   {
     NOTICE_LOG_FMT(MEMMAP, "mmap failed");
+    if (base)
+      munmap(base, size);
     return nullptr;
   }
   else
   {
+#ifdef __linux__
+    if (m_huge_page_size != 0)
+      madvise(retval, size, MADV_HUGEPAGE);
+#endif
     return retval;
   }
 }
@@ -69,7 +157,8 @@ void MemArena::ReleaseView(void* view, size_t size)
 u8* MemArena::ReserveMemoryRegion(size_t memory_size)
 {
   const int flags = MAP_ANON | MAP_PRIVATE;
-  void* base = mmap(nullptr, memory_size, PROT_NONE, flags, -1, 0);
+  void* base = m_huge_page_size != 0 ? ReserveAlignedRegion(memory_size, m_huge_page_size, 0) :
+                                       mmap(nullptr, memory_size, PROT_NONE, flags, -1, 0);
   if (base == MAP_FAILED)
   {
     PanicAlertFmt("Failed to map enough memory space: {}", LastStrerrorString());
@@ -99,6 +188,10 @@ void* MemArena::MapInMemoryRegion(s64 offset, size_t size, void* base)
   }
   else
   {
+#ifdef __linux__
+    if (m_huge_page_size != 0)
+      madvise(retval, size, MADV_HUGEPAGE);
+#endif
     return retval;
   }
 }
@@ -110,6 +203,27 @@ void MemArena::UnmapFromMemoryRegion(void* view, size_t size)
     NOTICE_LOG_FMT(MEMMAP, "mmap failed");
 }
 
+size_t MemArena::GetHugePageSize()
+{
+#ifdef __linux__
+  // The size of the huge pages that can be used transparently, which depends on the base page size.
+  static const size_t huge_page_size = [] {
+    std::string size_string;
+    size_t size = 0;
+    if (!File::ReadFileToString("/sys/kernel/mm/transparent_hugepage/hpage_pmd_size",
+                                size_string) ||
+        !TryParse(std::string(StripWhitespace(size_string)), &size))
+    {
+      return size_t(0);
+    }
+    return size;
+  }();
+  return huge_page_size;
+#else
+  return 0;
+#endif
+}
+
 LazyMemoryRegion::LazyMemoryRegion() = default;
 
 LazyMemoryRegion::~LazyMemoryRegion()
@@ -117,7 +117,7 @@ static DWORD GetLowDWORD(u64 value)
   return static_cast<DWORD>(value);
 }
 
-void MemArena::GrabSHMSegment(size_t size, std::string_view base_name)
+void MemArena::GrabSHMSegment(size_t size, std::string_view base_name, bool huge_pages)
 {
   const std::string name = fmt::format("{}.{}", base_name, GetCurrentProcessId());
   m_memory_handle =
@@ -442,6 +442,12 @@ void MemArena::UnmapFromMemoryRegion(void* view, size_t size)
   UnmapViewOfFile(view);
 }
 
+size_t MemArena::GetHugePageSize()
+{
+  // Large pages on Windows need the SeLockMemoryPrivilege, which users normally don't have.
+  return 0;
+}
+
 LazyMemoryRegion::LazyMemoryRegion()
 {
   InitWindowsMemoryFunctions(&m_memory_functions);
@@ -20,6 +20,7 @@
 #include <stdio.h>
 #include <sys/mman.h>
 #include <sys/types.h>
+#include <unistd.h>
 #if defined __APPLE__ || defined __FreeBSD__ || defined __OpenBSD__ || defined __NetBSD__
 #include <sys/sysctl.h>
 #elif defined __HAIKU__
@@ -212,6 +213,25 @@ bool ReadProtectMemory(void* ptr, size_t size)
   return true;
 }
 
+bool UnReadProtectMemory(void* ptr, size_t size)
+{
+#ifdef _WIN32
+  DWORD oldValue;
+  if (!VirtualProtect(ptr, size, PAGE_READWRITE, &oldValue))
+  {
+    PanicAlertFmt("UnReadProtectMemory failed!\nVirtualProtect: {}", GetLastErrorString());
+    return false;
+  }
+#else
+  if (mprotect(ptr, size, PROT_READ | PROT_WRITE) != 0)
+  {
+    PanicAlertFmt("UnReadProtectMemory failed!\nmprotect: {}", LastStrerrorString());
+    return false;
+  }
+#endif
+  return true;
+}
+
 bool WriteProtectMemory(void* ptr, size_t size, bool allowExecute)
 {
 #ifdef _WIN32
@@ -289,4 +309,15 @@ size_t MemPhysical()
 #endif
 }
 
+size_t GetPageSize()
+{
+#ifdef _WIN32
+  SYSTEM_INFO sysinfo;
+  GetSystemInfo(&sysinfo);
+  return sysinfo.dwPageSize;
+#else
+  return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
 }  // namespace Common
@@ -31,8 +31,13 @@ bool FreeMemoryPages(void* ptr, size_t size);
 void* AllocateAlignedMemory(size_t size, size_t alignment);
 void FreeAlignedMemory(void* ptr);
 bool ReadProtectMemory(void* ptr, size_t size);
+// Makes memory which isn't executable readable and writable again. Unlike UnWriteProtectMemory,
+// this also works on macOS on ARM.
+bool UnReadProtectMemory(void* ptr, size_t size);
 bool WriteProtectMemory(void* ptr, size_t size, bool executable = false);
 bool UnWriteProtectMemory(void* ptr, size_t size, bool allowExecute = false);
 size_t MemPhysical();
+// Returns the granularity at which the protection functions above operate.
+size_t GetPageSize();
 
 }  // namespace Common
@@ -38,15 +38,35 @@ const Info<bool> MAIN_SKIP_IPL{{System::Main, "Core", "SkipIPL"}, true};
 const Info<PowerPC::CPUCore> MAIN_CPU_CORE{{System::Main, "Core", "CPUCore"},
                                            PowerPC::DefaultCPUCore()};
 const Info<bool> MAIN_JIT_FOLLOW_BRANCH{{System::Main, "Core", "JITFollowBranch"}, true};
+const Info<bool> MAIN_JIT_INLINE_LEAF_FUNCTIONS{{System::Main, "Core", "JITInlineLeafFunctions"},
+                                               false};
+const Info<bool> MAIN_JIT_BLOCK_DISK_CACHE{{System::Main, "Core", "JITBlockDiskCache"}, false};
+const Info<bool> MAIN_JIT_TIERED_COMPILATION{{System::Main, "Core", "JITTieredCompilation"},
+                                             false};
+const Info<bool> MAIN_JIT_DEFERRED_COMPILATION{{System::Main, "Core", "JITDeferredCompilation"},
+                                               false};
+const Info<bool> MAIN_JIT_LOOP_CARRIED_REGISTERS{{System::Main, "Core", "JITLoopCarriedRegisters"},
+                                                 false};
+const Info<bool> MAIN_JIT_CODE_WRITE_PROTECTION{{System::Main, "Core", "JITCodeWriteProtection"},
+                                                false};
+const Info<int> MAIN_JIT_STATISTICS_DUMP_INTERVAL{
+    {System::Main, "Core", "JITStatisticsDumpInterval"}, 0};
 const Info<bool> MAIN_FASTMEM{{System::Main, "Core", "Fastmem"}, true};
 const Info<bool> MAIN_FASTMEM_ARENA{{System::Main, "Core", "FastmemArena"}, true};
+const Info<bool> MAIN_HUGE_PAGES{{System::Main, "Core", "HugePages"}, false};
 const Info<bool> MAIN_LARGE_ENTRY_POINTS_MAP{{System::Main, "Core", "LargeEntryPointsMap"}, true};
 const Info<bool> MAIN_ACCURATE_CPU_CACHE{{System::Main, "Core", "AccurateCPUCache"}, false};
+const Info<bool> MAIN_HLE_LIBRARY_FUNCTIONS{{System::Main, "Core", "HLELibraryFunctions"},
+                                           false};
 const Info<bool> MAIN_DSP_HLE{{System::Main, "Core", "DSPHLE"}, true};
 const Info<int> MAIN_MAX_FALLBACK{{System::Main, "Core", "MaxFallback"}, 100};
 const Info<int> MAIN_TIMING_VARIANCE{{System::Main, "Core", "TimingVariance"}, 40};
+const Info<bool> MAIN_PRECISE_FRAME_PACING{{System::Main, "Core", "PreciseFramePacing"}, false};
 const Info<bool> MAIN_CPU_THREAD{{System::Main, "Core", "CPUThread"}, true};
 const Info<bool> MAIN_SYNC_ON_SKIP_IDLE{{System::Main, "Core", "SyncOnSkipIdle"}, true};
+const Info<bool> MAIN_CORE_TIMING_PROFILING{{System::Main, "Core", "CoreTimingProfiling"}, false};
+const Info<int> MAIN_CORE_TIMING_PROFILE_DUMP_INTERVAL{
+    {System::Main, "Core", "CoreTimingProfileDumpInterval"}, 0};
 const Info<std::string> MAIN_DEFAULT_ISO{{System::Main, "Core", "DefaultISO"}, ""};
 const Info<bool> MAIN_ENABLE_CHEATS{{System::Main, "Core", "EnableCheats"}, false};
 const Info<int> MAIN_GC_LANGUAGE{{System::Main, "Core", "SelectedLanguage"}, 0};
@@ -55,16 +55,32 @@ namespace Config
 extern const Info<bool> MAIN_SKIP_IPL;
 extern const Info<PowerPC::CPUCore> MAIN_CPU_CORE;
 extern const Info<bool> MAIN_JIT_FOLLOW_BRANCH;
+extern const Info<bool> MAIN_JIT_INLINE_LEAF_FUNCTIONS;
+// Only has an effect together with MAIN_JIT_DEFERRED_COMPILATION.
+extern const Info<bool> MAIN_JIT_BLOCK_DISK_CACHE;
+extern const Info<bool> MAIN_JIT_TIERED_COMPILATION;
+extern const Info<bool> MAIN_JIT_DEFERRED_COMPILATION;
+extern const Info<bool> MAIN_JIT_LOOP_CARRIED_REGISTERS;
+extern const Info<bool> MAIN_JIT_CODE_WRITE_PROTECTION;
+// In seconds of emulated time, 0 disables the dump.
+extern const Info<int> MAIN_JIT_STATISTICS_DUMP_INTERVAL;
 extern const Info<bool> MAIN_FASTMEM;
 extern const Info<bool> MAIN_FASTMEM_ARENA;
+// Backs the emulated RAM with huge pages where supported. Only used on Linux for now.
+extern const Info<bool> MAIN_HUGE_PAGES;
 extern const Info<bool> MAIN_LARGE_ENTRY_POINTS_MAP;
 extern const Info<bool> MAIN_ACCURATE_CPU_CACHE;
+extern const Info<bool> MAIN_HLE_LIBRARY_FUNCTIONS;
 // Should really be in the DSP section, but we're kind of stuck with bad decisions made in the past.
 extern const Info<bool> MAIN_DSP_HLE;
 extern const Info<int> MAIN_MAX_FALLBACK;
 extern const Info<int> MAIN_TIMING_VARIANCE;
+extern const Info<bool> MAIN_PRECISE_FRAME_PACING;
 extern const Info<bool> MAIN_CPU_THREAD;
 extern const Info<bool> MAIN_SYNC_ON_SKIP_IDLE;
+extern const Info<bool> MAIN_CORE_TIMING_PROFILING;
+// In seconds of emulated time, 0 disables the dump. Only used when profiling is enabled.
+extern const Info<int> MAIN_CORE_TIMING_PROFILE_DUMP_INTERVAL;
 extern const Info<std::string> MAIN_DEFAULT_ISO;
 extern const Info<bool> MAIN_ENABLE_CHEATS;
 extern const Info<int> MAIN_GC_LANGUAGE;
@@ -4,6 +4,7 @@
 #include "Core/CoreTiming.h"
 
 #include <algorithm>
+#include <chrono>
 #include <mutex>
 #include <string>
 #include <unordered_map>
@@ -14,7 +15,8 @@
 #include "Common/Assert.h"
 #include "Common/ChunkFile.h"
 #include "Common/Logging/Log.h"
-#include "Common/SPSCQueue.h"
+#include "Common/MPSCQueue.h"
+#include "Common/Thread.h"
 
 #include "Core/AchievementManager.h"
 #include "Core/CPUThreadConfigCallback.h"
@@ -78,7 +80,7 @@ EventType* CoreTimingManager::RegisterEvent(const std::string& name, TimedCallba
              "during Init to avoid breaking save states.",
              name);
 
-  auto info = m_event_types.emplace(name, EventType{callback, nullptr});
+  auto info = m_event_types.emplace(name, EventType{callback, nullptr, 0, 0});
   EventType* event_type = &info.first->second;
   event_type->name = &info.first->first;
   return event_type;
@@ -92,6 +94,9 @@ void CoreTimingManager::UnregisterAllEvents()
 
 void CoreTimingManager::Init()
 {
+  m_throttle_sleep_margin = {};
+  m_timer_resolution_increased = false;
+
   m_registered_config_callback_id =
       CPUThreadConfigCallback::AddConfigChangedCallback([this]() { RefreshConfig(); });
   RefreshConfig();
@@ -118,7 +123,6 @@ void CoreTimingManager::Init()
 
 void CoreTimingManager::Shutdown()
 {
-  std::lock_guard lk(m_ts_write_lock);
   MoveEvents();
   ClearPendingEvents();
   UnregisterAllEvents();
@@ -131,6 +135,7 @@ void CoreTimingManager::RefreshConfig()
       Config::Get(Config::MAIN_OVERCLOCK_ENABLE) ? Config::Get(Config::MAIN_OVERCLOCK) : 1.0f;
   m_config_oc_inv_factor = 1.0f / m_config_oc_factor;
   m_config_sync_on_skip_idle = Config::Get(Config::MAIN_SYNC_ON_SKIP_IDLE);
+  m_config_profiling = Config::Get(Config::MAIN_CORE_TIMING_PROFILING);
 
   // A maximum fallback is used to prevent the system from sleeping for
   // too long or going full speed in an attempt to catch up to timings.
@@ -138,6 +143,9 @@ void CoreTimingManager::RefreshConfig()
 
   m_max_variance = std::chrono::duration_cast<DT>(DT_ms(Config::Get(Config::MAIN_TIMING_VARIANCE)));
 
+  m_config_precise_pacing = Config::Get(Config::MAIN_PRECISE_FRAME_PACING);
+  UpdateThrottleSleepMargin();
+
 #ifdef USE_RETRO_ACHIEVEMENTS
   if (AchievementManager::GetInstance().IsHardcoreModeActive() &&
       Config::Get(Config::MAIN_EMULATION_SPEED) < 1.0f &&
@@ -154,7 +162,6 @@ void CoreTimingManager::RefreshConfig()
 
 void CoreTimingManager::DoState(PointerWrap& p)
 {
-  std::lock_guard lk(m_ts_write_lock);
   p.Do(m_globals.slice_length);
   p.Do(m_globals.global_timer);
   p.Do(m_idled_cycles);
@@ -169,6 +176,15 @@ void CoreTimingManager::DoState(PointerWrap& p)
   p.DoMarker("CoreTimingData");
 
   MoveEvents();
+  if (p.IsReadMode())
+  {
+    for (auto& [name, event_type] : m_event_types)
+      event_type.pending_events = 0;
+  }
+  else if (m_cancelled_events != 0)
+  {
+    CompactEventQueue();
+  }
   p.DoEachElement(m_event_queue, [this](PointerWrap& pw, Event& ev) {
     pw.Do(ev.time);
     pw.Do(ev.fifo_order);
@@ -198,6 +214,8 @@ void CoreTimingManager::DoState(PointerWrap& p)
                      name);
         ev.type = m_ev_lost;
       }
+      ev.generation = ev.type->generation;
+      ev.type->pending_events++;
     }
   });
   p.DoMarker("CoreTimingEvents");
@@ -208,6 +226,7 @@ void CoreTimingManager::DoState(PointerWrap& p)
     // The exact layout of the heap in memory is implementation defined, therefore it is platform
     // and library version specific.
     std::make_heap(m_event_queue.begin(), m_event_queue.end(), std::greater<Event>());
+    m_cancelled_events = 0;
 
     // The stave state has changed the time, so our previous Throttle targets are invalid.
     // Especially when global_time goes down; So we create a fake throttle update.
@@ -236,6 +255,34 @@ u64 CoreTimingManager::GetIdleTicks() const
 void CoreTimingManager::ClearPendingEvents()
 {
   m_event_queue.clear();
+  m_cancelled_events = 0;
+  for (auto& [name, event_type] : m_event_types)
+    event_type.pending_events = 0;
+}
+
+void CoreTimingManager::PushEvent(Event event)
+{
+  event.generation = event.type->generation;
+  event.type->pending_events++;
+  m_event_queue.emplace_back(std::move(event));
+  std::push_heap(m_event_queue.begin(), m_event_queue.end(), std::greater<Event>());
+}
+
+void CoreTimingManager::PopCancelledEvents()
+{
+  while (!m_event_queue.empty() && IsCancelled(m_event_queue.front()))
+  {
+    std::pop_heap(m_event_queue.begin(), m_event_queue.end(), std::greater<Event>());
+    m_event_queue.pop_back();
+    m_cancelled_events--;
+  }
+}
+
+void CoreTimingManager::CompactEventQueue()
+{
+  std::erase_if(m_event_queue, IsCancelled);
+  std::make_heap(m_event_queue.begin(), m_event_queue.end(), std::greater<Event>());
+  m_cancelled_events = 0;
 }
 
 void CoreTimingManager::ScheduleEvent(s64 cycles_into_future, EventType* event_type, u64 userdata,
@@ -264,8 +311,7 @@ void CoreTimingManager::ScheduleEvent(s64 cycles_into_future, EventType* event_t
     if (!m_is_global_timer_sane)
       ForceExceptionCheck(cycles_into_future);
 
-    m_event_queue.emplace_back(Event{timeout, m_event_fifo_id++, userdata, event_type});
-    std::push_heap(m_event_queue.begin(), m_event_queue.end(), std::greater<Event>());
+    PushEvent(Event{timeout, m_event_fifo_id++, userdata, event_type, 0});
   }
   else
   {
@@ -277,22 +323,30 @@ void CoreTimingManager::ScheduleEvent(s64 cycles_into_future, EventType* event_t
                     *event_type->name);
     }
 
-    std::lock_guard lk(m_ts_write_lock);
-    m_ts_queue.Push(Event{m_globals.global_timer + cycles_into_future, 0, userdata, event_type});
+    const Event event{m_globals.global_timer + cycles_into_future, 0, userdata, event_type, 0};
+    if (m_ts_overflow_pending.load(std::memory_order_acquire) || !m_ts_queue.TryPush(event))
+    {
+      std::lock_guard lk(m_ts_overflow_lock);
+      m_ts_overflow_queue.push_back(event);
+      m_ts_overflow_pending.store(true, std::memory_order_release);
+    }
   }
 }
 
 void CoreTimingManager::RemoveEvent(EventType* event_type)
 {
-  auto itr = std::remove_if(m_event_queue.begin(), m_event_queue.end(),
-                            [&](const Event& e) { return e.type == event_type; });
+  if (event_type->pending_events == 0)
+    return;
 
-  // Removing random items breaks the invariant so we have to re-establish it.
-  if (itr != m_event_queue.end())
-  {
-    m_event_queue.erase(itr, m_event_queue.end());
-    std::make_heap(m_event_queue.begin(), m_event_queue.end(), std::greater<Event>());
-  }
+  event_type->generation++;
+  m_cancelled_events += event_type->pending_events;
+  event_type->pending_events = 0;
+
+  // Don't let cancelled events pile up when they're far in the future.
+  if (m_cancelled_events > m_event_queue.size() / 2)
+    CompactEventQueue();
+  else
+    PopCancelledEvents();
 }
 
 void CoreTimingManager::RemoveAllEvents(EventType* event_type)
@@ -319,8 +373,19 @@ void CoreTimingManager::MoveEvents()
   for (Event ev; m_ts_queue.Pop(ev);)
   {
     ev.fifo_order = m_event_fifo_id++;
-    m_event_queue.emplace_back(std::move(ev));
-    std::push_heap(m_event_queue.begin(), m_event_queue.end(), std::greater<Event>());
+    PushEvent(std::move(ev));
+  }
+
+  if (m_ts_overflow_pending.load(std::memory_order_acquire)) [[unlikely]]
+  {
+    std::lock_guard lk(m_ts_overflow_lock);
+    for (Event& ev : m_ts_overflow_queue)
+    {
+      ev.fifo_order = m_event_fifo_id++;
+      PushEvent(std::move(ev));
+    }
+    m_ts_overflow_queue.clear();
+    m_ts_overflow_pending.store(false, std::memory_order_release);
   }
 }
 
@@ -347,9 +412,31 @@ void CoreTimingManager::Advance()
     std::pop_heap(m_event_queue.begin(), m_event_queue.end(), std::greater<Event>());
     m_event_queue.pop_back();
 
+    if (IsCancelled(evt))
+    {
+      m_cancelled_events--;
+      continue;
+    }
+    evt.type->pending_events--;
+
     Throttle(evt.time);
-    evt.type->callback(m_system, evt.userdata, m_globals.global_timer - evt.time);
+
+    const s64 cycles_late = m_globals.global_timer - evt.time;
+    if (!m_config_profiling)
+    {
+      evt.type->callback(m_system, evt.userdata, cycles_late);
+      continue;
+    }
+
+    const TimePoint start = Clock::now();
+    evt.type->callback(m_system, evt.userdata, cycles_late);
+    EventProfile& profile = evt.type->profile;
+    profile.calls++;
+    profile.host_time += Clock::now() - start;
+    profile.total_cycles_late += cycles_late;
+    profile.max_cycles_late = std::max(profile.max_cycles_late, cycles_late);
   }
+  PopCancelledEvents();
 
   m_is_global_timer_sane = false;
 
@@ -369,6 +456,22 @@ void CoreTimingManager::Advance()
   power_pc.CheckExternalExceptions();
 }
 
+static DT MeasureSleepOvershoot()
+{
+  // Use the worst of a few short sleeps, as that's what causes a late frame.
+  constexpr int SAMPLES = 16;
+  constexpr DT SLEEP_TIME = std::chrono::duration_cast<DT>(DT_us(500));
+
+  DT overshoot{};
+  for (int i = 0; i < SAMPLES; ++i)
+  {
+    const TimePoint deadline = Clock::now() + SLEEP_TIME;
+    std::this_thread::sleep_until(deadline);
+    overshoot = std::max<DT>(overshoot, Clock::now() - deadline);
+  }
+  return overshoot;
+}
+
 void CoreTimingManager::Throttle(const s64 target_cycle)
 {
   // Based on number of cycles and emulation speed, increase the target deadline
@@ -410,12 +513,55 @@ void CoreTimingManager::Throttle(const s64 target_cycle)
   // Only sleep if we are behind the deadline
   if (time < m_throttle_deadline)
   {
-    std::this_thread::sleep_until(m_throttle_deadline);
+    SleepUntil(m_throttle_deadline);
 
     // Count amount of time sleeping for analytics
     const TimePoint time_after_sleep = Clock::now();
     g_perf_metrics.CountThrottleSleep(time_after_sleep - time);
+    g_perf_metrics.CountThrottleJitter(time_after_sleep - m_throttle_deadline);
+  }
+}
+
+void CoreTimingManager::SleepUntil(TimePoint deadline)
+{
+  if (!m_config_precise_pacing)
+  {
+    std::this_thread::sleep_until(deadline);
+    return;
   }
+
+  // Sleeping is only as precise as the host's timer, so stop sleeping a bit earlier than the
+  // deadline and spin for the rest.
+  const TimePoint sleep_deadline = deadline - m_throttle_sleep_margin;
+  if (Clock::now() < sleep_deadline)
+    std::this_thread::sleep_until(sleep_deadline);
+
+  while (Clock::now() < deadline)
+    Common::YieldCPU();
+}
+
+void CoreTimingManager::OnTimerResolutionIncreased()
+{
+  m_timer_resolution_increased = true;
+  UpdateThrottleSleepMargin();
+}
+
+void CoreTimingManager::UpdateThrottleSleepMargin()
+{
+  // Measuring takes several milliseconds, so do it up front instead of while throttling, and only
+  // once the timer resolution that will be used for throttling is in effect.
+  if (!m_config_precise_pacing || !m_timer_resolution_increased ||
+      m_throttle_sleep_margin != DT::zero())
+  {
+    return;
+  }
+
+  const DT overshoot = MeasureSleepOvershoot();
+  m_throttle_sleep_margin =
+      std::clamp<DT>(overshoot + overshoot / 4, std::chrono::duration_cast<DT>(DT_us(50)),
+                     std::chrono::duration_cast<DT>(DT_ms(4)));
+  INFO_LOG_FMT(COMMON, "Host sleep overshoot: {} us, using a spin margin of {} us",
+               DT_us(overshoot).count(), DT_us(m_throttle_sleep_margin).count());
 }
 
 void CoreTimingManager::ResetThrottle(s64 cycle)
@@ -443,6 +589,7 @@ bool CoreTimingManager::UseSyncOnSkipIdle() const
 void CoreTimingManager::LogPendingEvents() const
 {
   auto clone = m_event_queue;
+  std::erase_if(clone, IsCancelled);
   std::sort(clone.begin(), clone.end());
   for (const Event& ev : clone)
   {
@@ -486,6 +633,7 @@ std::string CoreTimingManager::GetScheduledEventsSummary() const
   text.reserve(1000);
 
   auto clone = m_event_queue;
+  std::erase_if(clone, IsCancelled);
   std::sort(clone.begin(), clone.end());
   for (const Event& ev : clone)
   {
@@ -494,6 +642,41 @@ std::string CoreTimingManager::GetScheduledEventsSummary() const
   return text;
 }
 
+std::string CoreTimingManager::GetEventProfileSummary() const
+{
+  std::vector<const EventType*> types;
+  for (const auto& [name, event_type] : m_event_types)
+  {
+    if (event_type.profile.calls != 0)
+      types.push_back(&event_type);
+  }
+  if (types.empty())
+    return {};
+
+  std::sort(types.begin(), types.end(), [](const EventType* a, const EventType* b) {
+    return a->profile.host_time > b->profile.host_time;
+  });
+
+  std::string text = "Event profile: name calls host_us avg_host_ns avg_late max_late\n";
+  for (const EventType* event_type : types)
+  {
+    const EventProfile& profile = event_type->profile;
+    const s64 host_ns =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(profile.host_time).count();
+    const s64 calls = static_cast<s64>(profile.calls);
+    text += fmt::format("{} : {} {} {} {} {}\n", *event_type->name, calls, host_ns / 1000,
+                        host_ns / calls, profile.total_cycles_late / calls,
+                        profile.max_cycles_late);
+  }
+  return text;
+}
+
+void CoreTimingManager::ResetEventProfile()
+{
+  for (auto& [name, event_type] : m_event_types)
+    event_type.profile = {};
+}
+
 u32 CoreTimingManager::GetFakeDecStartValue() const
 {
   return m_fake_dec_start_value;
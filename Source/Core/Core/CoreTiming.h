@@ -16,13 +16,14 @@
 // inside callback:
 //   ScheduleEvent(periodInCycles - cyclesLate, callback, "whatever")
 
+#include <atomic>
 #include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
 #include "Common/CommonTypes.h"
-#include "Common/SPSCQueue.h"
+#include "Common/MPSCQueue.h"
 #include "Core/CPUThreadConfigCallback.h"
 
 class PointerWrap;
@@ -46,10 +47,24 @@ struct Globals
 
 typedef void (*TimedCallback)(Core::System& system, u64 userdata, s64 cyclesLate);
 
+// Only gathered while CoreTiming profiling is enabled.
+struct EventProfile
+{
+  u64 calls = 0;
+  DT host_time{};
+  s64 total_cycles_late = 0;
+  s64 max_cycles_late = 0;
+};
+
 struct EventType
 {
   TimedCallback callback;
   const std::string* name;
+  // Bumped by RemoveEvent, which cancels every queued event of this type with an older generation.
+  u64 generation = 0;
+  // Number of queued events of this type that haven't been cancelled.
+  u32 pending_events = 0;
+  EventProfile profile;
 };
 
 struct Event
@@ -58,6 +73,7 @@ struct Event
   u64 fifo_order;
   u64 userdata;
   EventType* type;
+  u64 generation;
 };
 
 enum class FromThread
@@ -105,6 +121,8 @@ public:
                      FromThread from = FromThread::CPU);
 
   // We only permit one event of each type in the queue at a time.
+  // Removal is O(1): the events are only marked as cancelled, and get dropped once they reach the
+  // front of the queue or when enough of them have accumulated.
   void RemoveEvent(EventType* event_type);
   void RemoveAllEvents(EventType* event_type);
 
@@ -127,6 +145,11 @@ public:
 
   std::string GetScheduledEventsSummary() const;
 
+  // Returns the call count, host time spent in the callback and lateness of each event type since
+  // the last reset, sorted by host time. Empty unless CoreTiming profiling is enabled.
+  std::string GetEventProfileSummary() const;
+  void ResetEventProfile();
+
   void AdjustEventQueueTimes(u32 new_ppc_clock, u32 old_ppc_clock);
 
   u32 GetFakeDecStartValue() const;
@@ -147,6 +170,9 @@ public:
   // Never used outside of CoreTiming, however it remains public
   // in order to allow custom throttling implementations to be tested.
   void Throttle(const s64 target_cycle);
+  // Called once the host's timer resolution has been raised for emulation, as the throttler's
+  // sleep margin for precise frame pacing depends on it.
+  void OnTimerResolutionIncreased();
 
   TimePoint GetCPUTimePoint(s64 cyclesLate) const;  // Used by Dolphin Analytics
   bool GetVISkip() const;                           // Used By VideoInterface
@@ -165,12 +191,20 @@ private:
   // STATE_TO_SAVE
   // The queue is a min-heap using std::make_heap/push_heap/pop_heap.
   // We don't use std::priority_queue because we need to be able to serialize, unserialize and
-  // erase arbitrary events (RemoveEvent()) regardless of the queue order. These aren't accomodated
-  // by the standard adaptor class.
+  // iterate over the events regardless of the queue order. These aren't accomodated by the
+  // standard adaptor class.
+  // Cancelled events stay in the heap until they reach the front or get compacted away, and are
+  // never saved.
   std::vector<Event> m_event_queue;
+  size_t m_cancelled_events = 0;
   u64 m_event_fifo_id = 0;
-  std::mutex m_ts_write_lock;
-  Common::SPSCQueue<Event, false> m_ts_queue;
+  // Events scheduled from other threads go through a lock-free ring, so that the CPU thread only
+  // has to check it at each Advance(). When the ring is full, they go to the overflow queue
+  // instead, and keep doing so until it has been drained to preserve their order.
+  Common::MPSCQueue<Event, 512> m_ts_queue;
+  std::mutex m_ts_overflow_lock;
+  std::vector<Event> m_ts_overflow_queue;
+  std::atomic<bool> m_ts_overflow_pending = false;
 
   float m_last_oc_factor = 0.0f;
 
@@ -187,6 +221,8 @@ private:
   float m_config_oc_factor = 0.0f;
   float m_config_oc_inv_factor = 0.0f;
   bool m_config_sync_on_skip_idle = false;
+  bool m_config_profiling = false;
+  bool m_config_precise_pacing = false;
 
   s64 m_throttle_last_cycle = 0;
   TimePoint m_throttle_deadline = Clock::now();
@@ -194,11 +230,23 @@ private:
   s64 m_throttle_min_clock_per_sleep = 0;
   bool m_throttle_disable_vi_int = false;
 
+  // How much earlier than the deadline the throttler wakes up from its sleep when precise pacing
+  // is enabled, to spin the rest of the way. Measured when precise pacing gets enabled.
+  DT m_throttle_sleep_margin = {};
+  bool m_timer_resolution_increased = false;
+
   DT m_max_fallback = {};
   DT m_max_variance = {};
   double m_emulation_speed = 1.0;
 
   void ResetThrottle(s64 cycle);
+  void SleepUntil(TimePoint deadline);
+  void UpdateThrottleSleepMargin();
+
+  static bool IsCancelled(const Event& event) { return event.generation != event.type->generation; }
+  void PushEvent(Event event);
+  void PopCancelledEvents();
+  void CompactEventQueue();
 
   int DowncountToCycles(int downcount) const;
   int CyclesToDowncount(int cycles) const;
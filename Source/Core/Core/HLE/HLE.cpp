@@ -14,6 +14,7 @@
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
 #include "Core/GeckoCode.h"
+#include "Core/HLE/HLE_Lib.h"
 #include "Core/HLE/HLE_Misc.h"
 #include "Core/HLE/HLE_OS.h"
 #include "Core/HW/Memmap.h"
@@ -28,7 +29,7 @@ namespace HLE
 static std::map<u32, u32> s_hooked_addresses;
 
 // clang-format off
-constexpr std::array<Hook, 23> os_patches{{
+constexpr std::array<Hook, 32> os_patches{{
     // Placeholder, os_patches[0] is the "non-existent function" index
     {"FAKE_TO_SKIP_0",               HLE_Misc::UnimplementedFunction,       HookType::Replace, HookFlag::Generic},
 
@@ -58,6 +59,17 @@ constexpr std::array<Hook, 23> os_patches{{
     {"___blank",                     HLE_OS::HLE_GeneralDebugPrint,         HookType::Start,   HookFlag::Debug}, // used for early init things (normally)
     {"__write_console",              HLE_OS::HLE_write_console,             HookType::Start,   HookFlag::Debug}, // used by sysmenu (+more?)
 
+    // Library routines
+    {"memcpy",                       HLE_Lib::Memcpy,                       HookType::Replace, HookFlag::Library},
+    {"memmove",                      HLE_Lib::Memmove,                      HookType::Replace, HookFlag::Library},
+    {"memset",                       HLE_Lib::Memset,                       HookType::Replace, HookFlag::Library},
+    {"strlen",                       HLE_Lib::Strlen,                       HookType::Replace, HookFlag::Library},
+    {"strcmp",                       HLE_Lib::Strcmp,                       HookType::Replace, HookFlag::Library},
+    {"PSMTXIdentity",                HLE_Lib::PSMTXIdentity,                HookType::Replace, HookFlag::Library},
+    {"PSMTXCopy",                    HLE_Lib::PSMTXCopy,                    HookType::Replace, HookFlag::Library},
+    {"PSMTXConcat",                  HLE_Lib::PSMTXConcat,                  HookType::Replace, HookFlag::Library},
+    {"PSMTXMultVec",                 HLE_Lib::PSMTXMultVec,                 HookType::Replace, HookFlag::Library},
+
     {"GeckoCodehandler",             HLE_Misc::GeckoCodeHandlerICacheFlush, HookType::Start,   HookFlag::Fixed},
     {"GeckoHandlerReturnTrampoline", HLE_Misc::GeckoReturnTrampoline,       HookType::Replace, HookFlag::Fixed},
     {"AppLoaderReport",              HLE_OS::HLE_GeneralDebugPrint,         HookType::Start,   HookFlag::Fixed} // apploader needs OSReport-like function
@@ -169,6 +181,9 @@ void Execute(const Core::CPUThreadGuard& guard, u32 current_pc, u32 hook_index)
 void ExecuteFromJIT(u32 current_pc, u32 hook_index, Core::System& system)
 {
   ASSERT(Core::IsCPUThread());
+  // Compiled code only writes back pc when leaving a block, but hooks which fall back to the
+  // original code need to know where it starts.
+  system.GetPPCState().pc = current_pc;
   Core::CPUThreadGuard guard(system);
   Execute(guard, current_pc, hook_index);
 }
@@ -219,6 +234,15 @@ TryReplaceFunctionResult TryReplaceFunction(u32 address, PowerPC::CoreMode mode)
 
 bool IsEnabled(HookFlag flag, PowerPC::CoreMode mode)
 {
+  // The library replacements access memory without raising DSIs, triggering memchecks or going
+  // through the emulated data cache, so they can only be used when none of that can happen.
+  if (flag == HLE::HookFlag::Library)
+  {
+    return Config::Get(Config::MAIN_HLE_LIBRARY_FUNCTIONS) && !Config::IsDebuggingEnabled() &&
+           !Config::Get(Config::MAIN_ACCURATE_CPU_CACHE) &&
+           !Core::System::GetInstance().IsMMUMode();
+  }
+
   return flag != HLE::HookFlag::Debug || Config::IsDebuggingEnabled() ||
          mode == PowerPC::CoreMode::Interpreter;
 }
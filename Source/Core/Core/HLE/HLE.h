@@ -34,6 +34,7 @@ enum class HookFlag
   Generic,  // Miscellaneous function
   Debug,    // Debug output function
   Fixed,    // An arbitrary hook mapped to a fixed address instead of a symbol
+  Library,  // Native replacement of a hot library routine
 };
 
 struct Hook
@@ -0,0 +1,501 @@
+// Copyright 2026 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "Core/HLE/HLE_Lib.h"
+
+#include <algorithm>
+#include <cstring>
+#include <optional>
+
+#include "Common/BitUtils.h"
+#include "Common/CommonTypes.h"
+#include "Core/Core.h"
+#include "Core/HW/Memmap.h"
+#include "Core/PowerPC/Interpreter/Interpreter.h"
+#include "Core/PowerPC/Interpreter/Interpreter_FPUtils.h"
+#include "Core/PowerPC/JitInterface.h"
+#include "Core/PowerPC/MMU.h"
+#include "Core/PowerPC/PowerPC.h"
+#include "Core/System.h"
+
+namespace HLE_Lib
+{
+namespace
+{
+constexpr u32 GUEST_PAGE_SIZE = 0x1000;
+constexpr u32 EXRAM_BASE = 0x10000000;
+
+u32 BytesLeftInPage(u32 address)
+{
+  return GUEST_PAGE_SIZE - (address & (GUEST_PAGE_SIZE - 1));
+}
+
+// Returns a host pointer to a range of effective addresses if all of it translates to one
+// contiguous range of MEM1 or MEM2, which is the case for nearly every buffer games pass to these
+// routines. Anything else (the locked L1 cache, MMIO, untranslated pages) has to go through the
+// MMU one access at a time.
+u8* GetHostPointer(Core::System& system, u32 address, u32 size, u32* physical_address)
+{
+  auto& mmu = system.GetMMU();
+  auto& memory = system.GetMemory();
+
+  const std::optional<u32> start = mmu.GetTranslatedAddress(address);
+  if (!start)
+    return nullptr;
+
+  // Within a page addresses translate linearly, so only the page boundaries have to be checked.
+  for (u32 offset = BytesLeftInPage(address); offset < size; offset += GUEST_PAGE_SIZE)
+  {
+    const std::optional<u32> page = mmu.GetTranslatedAddress(address + offset);
+    if (!page || *page != *start + offset)
+      return nullptr;
+  }
+
+  u8* pointer;
+  u32 bytes_left;
+  if (*start < memory.GetRamSizeReal())
+  {
+    pointer = memory.GetRAM() + *start;
+    bytes_left = memory.GetRamSizeReal() - *start;
+  }
+  else if (memory.GetEXRAM() && *start >= EXRAM_BASE &&
+           *start - EXRAM_BASE < memory.GetExRamSizeReal())
+  {
+    pointer = memory.GetEXRAM() + (*start - EXRAM_BASE);
+    bytes_left = memory.GetExRamSizeReal() - (*start - EXRAM_BASE);
+  }
+  else
+  {
+    return nullptr;
+  }
+
+  if (size > bytes_left)
+    return nullptr;
+
+  *physical_address = *start;
+  return pointer;
+}
+
+// Writes through a host pointer bypass the write protection of compiled code, so tell the JIT
+// about them the same way the MMU does for its own slow path writes.
+void InvalidateOverwrittenCode(Core::System& system, u32 physical_address, u32 size)
+{
+  auto& memory = system.GetMemory();
+  const u32 end = physical_address + size;
+  for (u32 page = physical_address & ~(GUEST_PAGE_SIZE - 1); page < end; page += GUEST_PAGE_SIZE)
+  {
+    if (memory.IsProtectedCode(page))
+    {
+      system.GetJitInterface().InvalidateOverwrittenCode(physical_address, size);
+      return;
+    }
+  }
+}
+
+void CopyMemory(Core::System& system, u32 dst, u32 src, u32 size)
+{
+  if (size == 0)
+    return;
+
+  u32 dst_physical;
+  u32 src_physical;
+  u8* const dst_pointer = GetHostPointer(system, dst, size, &dst_physical);
+  const u8* const src_pointer = GetHostPointer(system, src, size, &src_physical);
+  if (dst_pointer && src_pointer)
+  {
+    std::memmove(dst_pointer, src_pointer, size);
+    InvalidateOverwrittenCode(system, dst_physical, size);
+    return;
+  }
+
+  // The MSL memcpy copies backwards when the destination comes after the source, so overlapping
+  // copies behave like memmove for both routines.
+  auto& mmu = system.GetMMU();
+  if (dst > src)
+  {
+    for (u32 i = size; i-- > 0;)
+      mmu.Write_U8(mmu.Read_U8(src + i), dst + i);
+  }
+  else
+  {
+    for (u32 i = 0; i < size; ++i)
+      mmu.Write_U8(mmu.Read_U8(src + i), dst + i);
+  }
+}
+
+// The paired single arithmetic used by the MTX routines. Each operation rounds and updates FPSCR
+// exactly like the interpreter does for the instruction of the same name, and the routines below
+// issue them in the same order as the SDK's hand-written assembly, so their results are bit for bit
+// the same as running the original code.
+//
+// That only holds when the original code would run without exceptions and its psq_l/psq_st would
+// transfer plain floats, which is what the SDK sets GQR0 up for. Otherwise the routines fall back
+// to the original code.
+bool CanReplaceMatrixRoutine(const PowerPC::PowerPCState& ppc_state)
+{
+  return GQR(ppc_state, 0) == 0 && ppc_state.msr.FP && HID2(ppc_state).PSE &&
+         HID2(ppc_state).LSQE;
+}
+
+// Runs the routine at pc through the interpreter. The MTX routines are straight-line code, so this
+// is done as soon as the code leaves the sequence, either by returning or by taking an exception.
+void RunOriginalCode(Core::System& system)
+{
+  auto& ppc_state = system.GetPPCState();
+  auto& interpreter = system.GetInterpreter();
+  u32 next_pc;
+  do
+  {
+    next_pc = ppc_state.pc + 4;
+    interpreter.ExecuteInstruction();
+  } while (ppc_state.pc == next_pc);
+}
+
+struct Pair
+{
+  double ps0;
+  double ps1;
+};
+
+Pair LoadPair(PowerPC::MMU& mmu, u32 address)
+{
+  const u64 value = mmu.Read_U64(address);
+  return {Common::BitCast<double>(ConvertToDouble(u32(value >> 32))),
+          Common::BitCast<double>(ConvertToDouble(u32(value)))};
+}
+
+Pair LoadSingle(PowerPC::MMU& mmu, u32 address)
+{
+  return {Common::BitCast<double>(ConvertToDouble(mmu.Read_U32(address))), 1.0};
+}
+
+void StorePair(PowerPC::MMU& mmu, const Pair& value, u32 address)
+{
+  const u32 ps0 = ConvertToSingleFTZ(Common::BitCast<u64>(value.ps0));
+  const u32 ps1 = ConvertToSingleFTZ(Common::BitCast<u64>(value.ps1));
+  mmu.Write_U64(u64{ps0} << 32 | ps1, address);
+}
+
+void StoreSingle(PowerPC::MMU& mmu, double value, u32 address)
+{
+  mmu.Write_U32(ConvertToSingleFTZ(Common::BitCast<u64>(value)), address);
+}
+
+float Mul(PowerPC::PowerPCState& ppc_state, double a, double c)
+{
+  return ForceSingle(ppc_state.fpscr, NI_mul(ppc_state, a, c).value);
+}
+
+float Madd(PowerPC::PowerPCState& ppc_state, double a, double c, double b)
+{
+  return ForceSingle(ppc_state.fpscr, NI_madd(ppc_state, a, c, b).value);
+}
+
+Pair SetResult(PowerPC::PowerPCState& ppc_state, float ps0, float ps1)
+{
+  ppc_state.UpdateFPRFSingle(ps0);
+  return {ps0, ps1};
+}
+
+Pair PSMul(PowerPC::PowerPCState& ppc_state, const Pair& a, const Pair& c)
+{
+  return SetResult(ppc_state, Mul(ppc_state, a.ps0, Force25Bit(c.ps0)),
+                   Mul(ppc_state, a.ps1, Force25Bit(c.ps1)));
+}
+
+Pair PSMadd(PowerPC::PowerPCState& ppc_state, const Pair& a, const Pair& c, const Pair& b)
+{
+  return SetResult(ppc_state, Madd(ppc_state, a.ps0, Force25Bit(c.ps0), b.ps0),
+                   Madd(ppc_state, a.ps1, Force25Bit(c.ps1), b.ps1));
+}
+
+Pair PSMuls0(PowerPC::PowerPCState& ppc_state, const Pair& a, const Pair& c)
+{
+  const double c0 = Force25Bit(c.ps0);
+  return SetResult(ppc_state, Mul(ppc_state, a.ps0, c0), Mul(ppc_state, a.ps1, c0));
+}
+
+Pair PSMadds0(PowerPC::PowerPCState& ppc_state, const Pair& a, const Pair& c, const Pair& b)
+{
+  const double c0 = Force25Bit(c.ps0);
+  return SetResult(ppc_state, Madd(ppc_state, a.ps0, c0, b.ps0), Madd(ppc_state, a.ps1, c0, b.ps1));
+}
+
+Pair PSMadds1(PowerPC::PowerPCState& ppc_state, const Pair& a, const Pair& c, const Pair& b)
+{
+  const double c1 = Force25Bit(c.ps1);
+  return SetResult(ppc_state, Madd(ppc_state, a.ps0, c1, b.ps0), Madd(ppc_state, a.ps1, c1, b.ps1));
+}
+
+// ps_sum0 with frB == frA. The routines only ever store ps0 of the result.
+double PSSum0(PowerPC::PowerPCState& ppc_state, const Pair& a)
+{
+  const float ps0 = ForceSingle(ppc_state.fpscr, NI_add(ppc_state, a.ps0, a.ps1).value);
+  ppc_state.UpdateFPRFSingle(ps0);
+  return ps0;
+}
+}  // namespace
+
+// memcpy(dst, src, n) and memmove(dst, src, n) return dst, which is already in r3.
+void Memcpy(const Core::CPUThreadGuard& guard)
+{
+  auto& system = guard.GetSystem();
+  auto& ppc_state = system.GetPPCState();
+  CopyMemory(system, ppc_state.gpr[3], ppc_state.gpr[4], ppc_state.gpr[5]);
+  ppc_state.npc = LR(ppc_state);
+}
+
+void Memmove(const Core::CPUThreadGuard& guard)
+{
+  Memcpy(guard);
+}
+
+// memset(dst, value, n) also returns dst.
+void Memset(const Core::CPUThreadGuard& guard)
+{
+  auto& system = guard.GetSystem();
+  auto& ppc_state = system.GetPPCState();
+  const u32 dst = ppc_state.gpr[3];
+  const u8 value = static_cast<u8>(ppc_state.gpr[4]);
+  const u32 size = ppc_state.gpr[5];
+
+  u32 dst_physical;
+  if (size != 0)
+  {
+    if (u8* const pointer = GetHostPointer(system, dst, size, &dst_physical))
+    {
+      std::memset(pointer, value, size);
+      InvalidateOverwrittenCode(system, dst_physical, size);
+    }
+    else
+    {
+      auto& mmu = system.GetMMU();
+      for (u32 i = 0; i < size; ++i)
+        mmu.Write_U8(value, dst + i);
+    }
+  }
+
+  ppc_state.npc = LR(ppc_state);
+}
+
+void Strlen(const Core::CPUThreadGuard& guard)
+{
+  auto& system = guard.GetSystem();
+  auto& ppc_state = system.GetPPCState();
+  auto& mmu = system.GetMMU();
+  const u32 string = ppc_state.gpr[3];
+
+  u32 length = 0;
+  while (true)
+  {
+    const u32 address = string + length;
+    const u32 chunk_size = BytesLeftInPage(address);
+    u32 physical_address;
+    if (const u8* const chunk = GetHostPointer(system, address, chunk_size, &physical_address))
+    {
+      const void* const terminator = std::memchr(chunk, 0, chunk_size);
+      if (terminator)
+      {
+        length += static_cast<u32>(static_cast<const u8*>(terminator) - chunk);
+        break;
+      }
+      length += chunk_size;
+    }
+    else
+    {
+      if (mmu.Read_U8(address) == 0)
+        break;
+      ++length;
+    }
+  }
+
+  ppc_state.gpr[3] = length;
+  ppc_state.npc = LR(ppc_state);
+}
+
+// Like the MSL version, returns the difference between the first pair of bytes that don't match.
+void Strcmp(const Core::CPUThreadGuard& guard)
+{
+  auto& system = guard.GetSystem();
+  auto& ppc_state = system.GetPPCState();
+  auto& mmu = system.GetMMU();
+  const u32 left = ppc_state.gpr[3];
+  const u32 right = ppc_state.gpr[4];
+
+  u32 offset = 0;
+  while (true)
+  {
+    const u32 left_address = left + offset;
+    const u32 right_address = right + offset;
+    const u32 chunk_size = std::min(BytesLeftInPage(left_address), BytesLeftInPage(right_address));
+    u32 physical_address;
+    const u8* const left_chunk =
+        GetHostPointer(system, left_address, chunk_size, &physical_address);
+    const u8* const right_chunk =
+        left_chunk ? GetHostPointer(system, right_address, chunk_size, &physical_address) : nullptr;
+
+    const u32 count = right_chunk ? chunk_size : 1;
+    for (u32 i = 0; i < count; ++i)
+    {
+      const u8 l = right_chunk ? left_chunk[i] : mmu.Read_U8(left_address + i);
+      const u8 r = right_chunk ? right_chunk[i] : mmu.Read_U8(right_address + i);
+      if (l != r || l == 0)
+      {
+        ppc_state.gpr[3] = static_cast<u32>(s32{l} - s32{r});
+        ppc_state.npc = LR(ppc_state);
+        return;
+      }
+    }
+    offset += count;
+  }
+}
+
+void PSMTXIdentity(const Core::CPUThreadGuard& guard)
+{
+  auto& system = guard.GetSystem();
+  auto& ppc_state = system.GetPPCState();
+  if (!CanReplaceMatrixRoutine(ppc_state))
+  {
+    RunOriginalCode(system);
+    return;
+  }
+
+  auto& mmu = system.GetMMU();
+  const u32 m = ppc_state.gpr[3];
+
+  constexpr Pair zero{0.0, 0.0};
+  constexpr Pair zero_one{0.0, 1.0};
+  constexpr Pair one_zero{1.0, 0.0};
+  StorePair(mmu, zero, m + 8);
+  StorePair(mmu, zero, m + 24);
+  StorePair(mmu, zero, m + 32);
+  StorePair(mmu, zero_one, m + 16);
+  StorePair(mmu, one_zero, m + 0);
+  StorePair(mmu, one_zero, m + 40);
+
+  ppc_state.npc = LR(ppc_state);
+}
+
+// Going through the FPRs flushes denormals, so this isn't quite a plain memcpy.
+void PSMTXCopy(const Core::CPUThreadGuard& guard)
+{
+  auto& system = guard.GetSystem();
+  auto& ppc_state = system.GetPPCState();
+  if (!CanReplaceMatrixRoutine(ppc_state))
+  {
+    RunOriginalCode(system);
+    return;
+  }
+
+  auto& mmu = system.GetMMU();
+  const u32 src = ppc_state.gpr[3];
+  const u32 dst = ppc_state.gpr[4];
+
+  for (u32 offset = 0; offset < 48; offset += 8)
+    StorePair(mmu, LoadPair(mmu, src + offset), dst + offset);
+
+  ppc_state.npc = LR(ppc_state);
+}
+
+// mAB = mA * mB. All loads happen before the first store, so mAB may alias either input.
+void PSMTXConcat(const Core::CPUThreadGuard& guard)
+{
+  auto& system = guard.GetSystem();
+  auto& ppc_state = system.GetPPCState();
+  if (!CanReplaceMatrixRoutine(ppc_state))
+  {
+    RunOriginalCode(system);
+    return;
+  }
+
+  auto& mmu = system.GetMMU();
+  const u32 a = ppc_state.gpr[3];
+  const u32 b = ppc_state.gpr[4];
+  const u32 ab = ppc_state.gpr[5];
+
+  const Pair a00_a01 = LoadPair(mmu, a + 0);
+  const Pair a02_a03 = LoadPair(mmu, a + 8);
+  const Pair a10_a11 = LoadPair(mmu, a + 16);
+  const Pair a12_a13 = LoadPair(mmu, a + 24);
+  const Pair a20_a21 = LoadPair(mmu, a + 32);
+  const Pair a22_a23 = LoadPair(mmu, a + 40);
+  const Pair b00_b01 = LoadPair(mmu, b + 0);
+  const Pair b02_b03 = LoadPair(mmu, b + 8);
+  const Pair b10_b11 = LoadPair(mmu, b + 16);
+  const Pair b12_b13 = LoadPair(mmu, b + 24);
+  const Pair b20_b21 = LoadPair(mmu, b + 32);
+  const Pair b22_b23 = LoadPair(mmu, b + 40);
+  constexpr Pair unit01{0.0, 1.0};
+
+  Pair d00_d01 = PSMuls0(ppc_state, b00_b01, a00_a01);
+  Pair d02_d03 = PSMuls0(ppc_state, b02_b03, a00_a01);
+  Pair d10_d11 = PSMuls0(ppc_state, b00_b01, a10_a11);
+  Pair d12_d13 = PSMuls0(ppc_state, b02_b03, a10_a11);
+  d00_d01 = PSMadds1(ppc_state, b10_b11, a00_a01, d00_d01);
+  d10_d11 = PSMadds1(ppc_state, b10_b11, a10_a11, d10_d11);
+  d02_d03 = PSMadds1(ppc_state, b12_b13, a00_a01, d02_d03);
+  d12_d13 = PSMadds1(ppc_state, b12_b13, a10_a11, d12_d13);
+  d00_d01 = PSMadds0(ppc_state, b20_b21, a02_a03, d00_d01);
+  d02_d03 = PSMadds0(ppc_state, b22_b23, a02_a03, d02_d03);
+  d10_d11 = PSMadds0(ppc_state, b20_b21, a12_a13, d10_d11);
+  d12_d13 = PSMadds0(ppc_state, b22_b23, a12_a13, d12_d13);
+  StorePair(mmu, d00_d01, ab + 0);
+  Pair d20_d21 = PSMuls0(ppc_state, b00_b01, a20_a21);
+  d02_d03 = PSMadds1(ppc_state, unit01, a02_a03, d02_d03);
+  Pair d22_d23 = PSMuls0(ppc_state, b02_b03, a20_a21);
+  StorePair(mmu, d10_d11, ab + 16);
+  d12_d13 = PSMadds1(ppc_state, unit01, a12_a13, d12_d13);
+  StorePair(mmu, d02_d03, ab + 8);
+  d20_d21 = PSMadds1(ppc_state, b10_b11, a20_a21, d20_d21);
+  d22_d23 = PSMadds1(ppc_state, b12_b13, a20_a21, d22_d23);
+  d20_d21 = PSMadds0(ppc_state, b20_b21, a22_a23, d20_d21);
+  StorePair(mmu, d12_d13, ab + 24);
+  d22_d23 = PSMadds0(ppc_state, b22_b23, a22_a23, d22_d23);
+  StorePair(mmu, d20_d21, ab + 32);
+  d22_d23 = PSMadds1(ppc_state, unit01, a22_a23, d22_d23);
+  StorePair(mmu, d22_d23, ab + 40);
+
+  ppc_state.npc = LR(ppc_state);
+}
+
+// dst = m * src. The matrix loads are interleaved with the stores like in the original, in case
+// dst overlaps m.
+void PSMTXMultVec(const Core::CPUThreadGuard& guard)
+{
+  auto& system = guard.GetSystem();
+  auto& ppc_state = system.GetPPCState();
+  if (!CanReplaceMatrixRoutine(ppc_state))
+  {
+    RunOriginalCode(system);
+    return;
+  }
+
+  auto& mmu = system.GetMMU();
+  const u32 m = ppc_state.gpr[3];
+  const u32 src = ppc_state.gpr[4];
+  const u32 dst = ppc_state.gpr[5];
+
+  const Pair v0_v1 = LoadPair(mmu, src + 0);
+  const Pair m00_m01 = LoadPair(mmu, m + 0);
+  const Pair v2_1 = LoadSingle(mmu, src + 8);
+  Pair t = PSMul(ppc_state, m00_m01, v0_v1);
+  const Pair m02_m03 = LoadPair(mmu, m + 8);
+  t = PSMadd(ppc_state, m02_m03, v2_1, t);
+  const Pair m10_m11 = LoadPair(mmu, m + 16);
+  const double x = PSSum0(ppc_state, t);
+  const Pair m12_m13 = LoadPair(mmu, m + 24);
+  t = PSMul(ppc_state, m10_m11, v0_v1);
+  StoreSingle(mmu, x, dst + 0);
+  t = PSMadd(ppc_state, m12_m13, v2_1, t);
+  const Pair m20_m21 = LoadPair(mmu, m + 32);
+  const double y = PSSum0(ppc_state, t);
+  const Pair m22_m23 = LoadPair(mmu, m + 40);
+  t = PSMul(ppc_state, m20_m21, v0_v1);
+  StoreSingle(mmu, y, dst + 4);
+  t = PSMadd(ppc_state, m22_m23, v2_1, t);
+  const double z = PSSum0(ppc_state, t);
+  StoreSingle(mmu, z, dst + 8);
+
+  ppc_state.npc = LR(ppc_state);
+}
+}  // namespace HLE_Lib
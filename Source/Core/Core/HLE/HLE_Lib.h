@@ -0,0 +1,28 @@
+// Copyright 2026 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+namespace Core
+{
+class CPUThreadGuard;
+};
+
+// Native replacements for hot routines of the C library and the SDK's MTX library, which get
+// hooked when the corresponding symbols are known. They produce the same memory contents and
+// return values as the guest code they replace, but don't model its timing or its use of
+// volatile registers. Where the original code would behave differently because of how the CPU is
+// set up, they run it through the interpreter instead.
+namespace HLE_Lib
+{
+void Memcpy(const Core::CPUThreadGuard& guard);
+void Memmove(const Core::CPUThreadGuard& guard);
+void Memset(const Core::CPUThreadGuard& guard);
+void Strlen(const Core::CPUThreadGuard& guard);
+void Strcmp(const Core::CPUThreadGuard& guard);
+
+void PSMTXIdentity(const Core::CPUThreadGuard& guard);
+void PSMTXCopy(const Core::CPUThreadGuard& guard);
+void PSMTXConcat(const Core::CPUThreadGuard& guard);
+void PSMTXMultVec(const Core::CPUThreadGuard& guard);
+}  // namespace HLE_Lib
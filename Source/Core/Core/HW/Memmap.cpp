@@ -12,12 +12,15 @@
 #include <array>
 #include <cstring>
 #include <memory>
+#include <optional>
 #include <tuple>
 
+#include "Common/Align.h"
 #include "Common/ChunkFile.h"
 #include "Common/CommonTypes.h"
 #include "Common/Logging/Log.h"
 #include "Common/MemArena.h"
+#include "Common/MemoryUtil.h"
 #include "Common/MsgHandler.h"
 #include "Common/Swap.h"
 #include "Core/Config/MainSettings.h"
@@ -109,6 +112,10 @@ void MemoryManager::Init()
   // If MMU is turned off in GameCube mode, turn on fake VMEM hack.
   const bool fake_vmem = !wii && !mmu;
 
+  // Huge pages can only back the parts of the regions that are aligned to them in the segment.
+  const size_t huge_page_size =
+      Config::Get(Config::MAIN_HUGE_PAGES) ? Common::MemArena::GetHugePageSize() : 0;
+
   u32 mem_size = 0;
   for (PhysicalMemoryRegion& region : m_physical_regions)
   {
@@ -117,11 +124,13 @@ void MemoryManager::Init()
     if (!fake_vmem && (region.flags & PhysicalMemoryRegion::FAKE_VMEM))
       continue;
 
+    if (huge_page_size != 0)
+      mem_size = Common::AlignUp(mem_size, huge_page_size);
     region.shm_position = mem_size;
     region.active = true;
     mem_size += region.size;
   }
-  m_arena.GrabSHMSegment(mem_size, "dolphin-emu");
+  m_arena.GrabSHMSegment(mem_size, "dolphin-emu", huge_page_size != 0);
 
   m_physical_page_mappings.fill(nullptr);
 
@@ -228,6 +237,14 @@ bool MemoryManager::InitFastmemArena()
     }
   }
 
+  // Compiled code can only come from MEM1 and MEM2, so only their pages need to be tracked.
+  const PhysicalMemoryRegion& last_ram_region =
+      m_physical_regions[3].active ? m_physical_regions[3] : m_physical_regions[0];
+  m_code_page_shift = MathUtil::IntLog2(Common::GetPageSize());
+  m_protected_code_pages.assign(
+      (last_ram_region.physical_address + last_ram_region.size) >> m_code_page_shift, false);
+  m_protected_code_page_count = 0;
+
   m_is_fastmem_arena_initialized = true;
   m_fastmem_arena_size = memory_size;
   return true;
@@ -245,7 +262,7 @@ void MemoryManager::UpdateLogicalMemory(const PowerPC::BatTable& dbat_table)
 
   for (u32 i = 0; i < dbat_table.size(); ++i)
   {
-    if (dbat_table[i] & PowerPC::BAT_PHYSICAL_BIT)
+    if (dbat_table[i] & (PowerPC::BAT_PHYSICAL_BIT | PowerPC::BAT_MEMCHECK_BIT))
     {
       u32 logical_address = i << PowerPC::BAT_INDEX_SHIFT;
       // TODO: Merge adjacent mappings to make this faster.
@@ -279,15 +296,220 @@ void MemoryManager::UpdateLogicalMemory(const PowerPC::BatTable& dbat_table)
                   intersection_start, mapped_size, logical_address);
               exit(0);
             }
-            m_logical_mapped_entries.push_back({mapped_pointer, mapped_size});
+            m_logical_mapped_entries.push_back({mapped_pointer, mapped_size, intersection_start});
           }
 
-          m_logical_page_mappings[i] =
-              *physical_region.out_pointer + intersection_start - mapping_address;
+          // The page mappings are used without checking for memchecks, so leave watched pages
+          // out of them.
+          if (dbat_table[i] & PowerPC::BAT_PHYSICAL_BIT)
+          {
+            m_logical_page_mappings[i] =
+                *physical_region.out_pointer + intersection_start - mapping_address;
+          }
         }
       }
     }
   }
+
+  if (m_is_fastmem_arena_initialized)
+  {
+    ProtectCodeInLogicalMemory();
+    ProtectWatchedMemory();
+  }
+}
+
+bool MemoryManager::WriteProtectCode(u32 physical_address)
+{
+  const u32 page = physical_address >> m_code_page_shift;
+  if (page >= m_protected_code_pages.size() || m_protected_code_pages[page])
+    return false;
+
+  m_protected_code_pages[page] = true;
+  m_protected_code_page_count++;
+  SetCodePageProtection(page << m_code_page_shift, true);
+  return true;
+}
+
+std::optional<u32> MemoryManager::UnprotectCodeAt(const u8* fastmem_address)
+{
+  if (m_protected_code_page_count == 0)
+    return std::nullopt;
+
+  std::optional<u32> physical_address;
+  if (fastmem_address >= m_physical_base && fastmem_address < m_physical_base + 0x1'0000'0000)
+  {
+    physical_address = static_cast<u32>(fastmem_address - m_physical_base);
+  }
+  else
+  {
+    for (const LogicalMemoryView& entry : m_logical_mapped_entries)
+    {
+      const u8* mapped_pointer = static_cast<const u8*>(entry.mapped_pointer);
+      if (fastmem_address >= mapped_pointer && fastmem_address < mapped_pointer + entry.mapped_size)
+      {
+        physical_address =
+            entry.physical_address + static_cast<u32>(fastmem_address - mapped_pointer);
+        break;
+      }
+    }
+  }
+
+  if (!physical_address || !IsProtectedCode(*physical_address))
+    return std::nullopt;
+
+  const u32 page = *physical_address >> m_code_page_shift;
+  m_protected_code_pages[page] = false;
+  m_protected_code_page_count--;
+  SetCodePageProtection(page << m_code_page_shift, false);
+
+  // The page may also contain memory watched by a memcheck.
+  if (m_system.GetPowerPC().GetMemChecks().HasAny())
+    ProtectWatchedMemory();
+
+  return page << m_code_page_shift;
+}
+
+void MemoryManager::UnprotectAllCode()
+{
+  if (m_protected_code_page_count == 0)
+    return;
+
+  for (const PhysicalMemoryRegion& region : m_physical_regions)
+  {
+    if (region.active)
+      Common::UnWriteProtectMemory(m_physical_base + region.physical_address, region.size);
+  }
+  for (const LogicalMemoryView& entry : m_logical_mapped_entries)
+    Common::UnWriteProtectMemory(entry.mapped_pointer, entry.mapped_size);
+
+  m_protected_code_pages.assign(m_protected_code_pages.size(), false);
+  m_protected_code_page_count = 0;
+
+  ProtectWatchedMemory();
+}
+
+void MemoryManager::SetCodePageProtection(u32 physical_page, bool write_protect)
+{
+  const size_t page_size = size_t{1} << m_code_page_shift;
+  const auto apply = [&](u8* host_page) {
+    if (write_protect)
+      Common::WriteProtectMemory(host_page, page_size);
+    else
+      Common::UnWriteProtectMemory(host_page, page_size);
+  };
+
+  apply(m_physical_base + physical_page);
+  for (const LogicalMemoryView& entry : m_logical_mapped_entries)
+  {
+    if (physical_page >= entry.physical_address &&
+        physical_page - entry.physical_address < entry.mapped_size)
+    {
+      apply(static_cast<u8*>(entry.mapped_pointer) + (physical_page - entry.physical_address));
+    }
+  }
+}
+
+void MemoryManager::ProtectCodeInLogicalMemory()
+{
+  // Remapping the logical view drops all protections in it.
+  if (m_protected_code_page_count == 0)
+    return;
+
+  const u32 page_size = u32{1} << m_code_page_shift;
+  for (const LogicalMemoryView& entry : m_logical_mapped_entries)
+  {
+    for (u32 offset = 0; offset < entry.mapped_size; offset += page_size)
+    {
+      if (IsProtectedCode(entry.physical_address + offset))
+        Common::WriteProtectMemory(static_cast<u8*>(entry.mapped_pointer) + offset, page_size);
+    }
+  }
+}
+
+void MemoryManager::ProtectWatchedMemory()
+{
+  // Instead of keeping watched memory out of the fastmem arena entirely (which would force every
+  // access to the surrounding BAT pages, or with address translation disabled every access at all,
+  // through the slow path), only the host pages containing watched addresses get protected. Fast
+  // accesses to them fault and get backpatched into slow accesses, which handle the memchecks.
+  // Watched pages of the logical views are restored by mapping the views anew when memchecks
+  // change, but those of the physical views have to be restored here. UnWriteProtectMemory can't be
+  // used for that, as it's a no-op on macOS on ARM.
+  for (const LogicalMemoryView& entry : m_protected_physical_entries)
+  {
+    Common::UnReadProtectMemory(entry.mapped_pointer, entry.mapped_size);
+
+    // Pages containing compiled code stay write protected.
+    const u32 page_size = u32{1} << m_code_page_shift;
+    for (u32 offset = 0; offset < entry.mapped_size; offset += page_size)
+    {
+      if (IsProtectedCode(entry.physical_address + offset))
+        Common::WriteProtectMemory(static_cast<u8*>(entry.mapped_pointer) + offset, page_size);
+    }
+  }
+  m_protected_physical_entries.clear();
+
+  const auto& mem_checks = m_system.GetPowerPC().GetMemChecks().GetMemChecks();
+  if (mem_checks.empty())
+    return;
+
+  const uintptr_t page_mask = ~(static_cast<uintptr_t>(Common::GetPageSize()) - 1);
+
+  // Protects the host pages containing the watched range which lie within the given mapped view.
+  const auto protect = [page_mask](u8* base, const TMemCheck& mem_check, bool read_protect,
+                                   u8* view_start, u32 view_size,
+                                   u32 view_physical_address) -> std::optional<LogicalMemoryView> {
+    const uintptr_t watch_start = reinterpret_cast<uintptr_t>(base + mem_check.start_address);
+    const uintptr_t watch_end = reinterpret_cast<uintptr_t>(base + mem_check.end_address);
+    u8* start = std::max(view_start, reinterpret_cast<u8*>(watch_start & page_mask));
+    u8* end = std::min(view_start + view_size, reinterpret_cast<u8*>((watch_end | ~page_mask) + 1));
+    if (start >= end)
+      return std::nullopt;
+
+    const u32 size = static_cast<u32>(end - start);
+    if (read_protect)
+      Common::ReadProtectMemory(start, size);
+    else
+      Common::WriteProtectMemory(start, size);
+    return LogicalMemoryView{start, size,
+                             view_physical_address + static_cast<u32>(start - view_start)};
+  };
+
+  // Write-only watches are applied first, so that they can't make pages readable again which are
+  // shared with a read watch.
+  for (const bool read_pass : {false, true})
+  {
+    for (const TMemCheck& mem_check : mem_checks)
+    {
+#if defined(_M_ARM_64) && defined(__APPLE__)
+      // WriteProtectMemory is a no-op on this platform.
+      const bool read_protect = true;
+#else
+      const bool read_protect = mem_check.is_break_on_read || !mem_check.is_break_on_write;
+#endif
+      if (read_protect != read_pass)
+        continue;
+
+      for (const LogicalMemoryView& entry : m_logical_mapped_entries)
+      {
+        protect(m_logical_base, mem_check, read_protect, static_cast<u8*>(entry.mapped_pointer),
+                entry.mapped_size, entry.physical_address);
+      }
+
+      for (const PhysicalMemoryRegion& region : m_physical_regions)
+      {
+        if (!region.active)
+          continue;
+
+        const auto protected_entry =
+            protect(m_physical_base, mem_check, read_protect,
+                    m_physical_base + region.physical_address, region.size,
+                    region.physical_address);
+        if (protected_entry)
+          m_protected_physical_entries.push_back(*protected_entry);
+      }
+    }
+  }
 }
 
 void MemoryManager::DoState(PointerWrap& p)
@@ -370,6 +592,9 @@ void MemoryManager::ShutdownFastmemArena()
     u8* base = m_physical_base + region.physical_address;
     m_arena.UnmapFromMemoryRegion(base, region.size);
   }
+  m_protected_physical_entries.clear();
+  m_protected_code_pages.clear();
+  m_protected_code_page_count = 0;
 
   for (auto& entry : m_logical_mapped_entries)
   {
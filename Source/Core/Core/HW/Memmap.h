@@ -5,6 +5,7 @@
 
 #include <array>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -53,6 +54,7 @@ struct LogicalMemoryView
 {
   void* mapped_pointer;
   u32 mapped_size;
+  u32 physical_address;
 };
 
 class MemoryManager
@@ -100,6 +102,20 @@ public:
 
   void UpdateLogicalMemory(const PowerPC::BatTable& dbat_table);
 
+  // Write protection of the host pages in the fastmem views which back compiled code, so that
+  // stores modifying that code fault instead of going unnoticed. Only MEM1 and MEM2 are covered.
+  // Returns true if the page containing the physical address wasn't protected yet.
+  bool WriteProtectCode(u32 physical_address);
+  // Makes the page containing the given fastmem address writable again if it is protected because
+  // of compiled code, and returns the physical address of its start.
+  std::optional<u32> UnprotectCodeAt(const u8* fastmem_address);
+  void UnprotectAllCode();
+  bool IsProtectedCode(u32 physical_address) const
+  {
+    const u32 page = physical_address >> m_code_page_shift;
+    return page < m_protected_code_pages.size() && m_protected_code_pages[page];
+  }
+
   void Clear();
 
   // Routines to access physically addressed memory, designed for use by
@@ -239,6 +255,15 @@ private:
   std::array<PhysicalMemoryRegion, 4> m_physical_regions{};
 
   std::vector<LogicalMemoryView> m_logical_mapped_entries;
+  // Parts of the physical view which are protected because memchecks watch them. Protections in
+  // the logical view are dropped whenever it gets remapped, so they don't need to be tracked.
+  std::vector<LogicalMemoryView> m_protected_physical_entries;
+
+  // One entry per host page of MEM1 and MEM2, indexed by physical address. Set for pages which are
+  // write protected in all fastmem views because they contain compiled code.
+  std::vector<bool> m_protected_code_pages;
+  u32 m_protected_code_page_count = 0;
+  u32 m_code_page_shift = 0;
 
   std::array<void*, PowerPC::BAT_PAGE_COUNT> m_physical_page_mappings{};
   std::array<void*, PowerPC::BAT_PAGE_COUNT> m_logical_page_mappings{};
@@ -246,5 +271,8 @@ private:
   Core::System& m_system;
 
   void InitMMIO(bool is_wii);
+  void ProtectWatchedMemory();
+  void SetCodePageProtection(u32 physical_page, bool write_protect);
+  void ProtectCodeInLogicalMemory();
 };
 }  // namespace Memory
@@ -47,9 +47,11 @@ IPC_HLE_PERIOD: For the Wii Remote this is the call schedule:
 #include <cfloat>
 #include <cmath>
 #include <cstdlib>
+#include <string>
 
 #include "AudioCommon/Mixer.h"
 #include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
 #include "Common/Logging/Log.h"
 #include "Common/Thread.h"
 #include "Common/Timer.h"
@@ -64,6 +66,7 @@ IPC_HLE_PERIOD: For the Wii Remote this is the call schedule:
 #include "Core/HW/VideoInterface.h"
 #include "Core/IOS/IOS.h"
 #include "Core/PatchEngine.h"
+#include "Core/PowerPC/JitInterface.h"
 #include "Core/PowerPC/PowerPC.h"
 #include "Core/System.h"
 #include "VideoCommon/Fifo.h"
@@ -82,6 +85,8 @@ CoreTiming::EventType* et_GPU_sleeper;
 CoreTiming::EventType* et_perf_tracker;
 // PatchEngine updates every 1/60th of a second by default
 CoreTiming::EventType* et_PatchEngine;
+CoreTiming::EventType* et_JitStatistics;
+CoreTiming::EventType* et_CoreTimingProfile;
 
 u32 s_cpu_core_clock = 486000000u;  // 486 mhz (its not 485, stop bugging me!)
 
@@ -146,6 +151,33 @@ void PerfTrackerCallback(Core::System& system, u64 userdata, s64 cyclesLate)
   core_timing.ScheduleEvent(GetTicksPerSecond() / 100 - cyclesLate, et_perf_tracker);
 }
 
+void JitStatisticsCallback(Core::System& system, u64 userdata, s64 cyclesLate)
+{
+  auto& jit_interface = system.GetJitInterface();
+  const std::string filename = File::GetUserPath(D_DUMP_IDX) + "JitStatistics.json";
+  if (jit_interface.GetCore() && !jit_interface.WriteStatistics(filename))
+    WARN_LOG_FMT(POWERPC, "Failed to write JIT statistics to {}", filename);
+
+  const s64 interval = Config::Get(Config::MAIN_JIT_STATISTICS_DUMP_INTERVAL);
+  if (interval > 0)
+    system.GetCoreTiming().ScheduleEvent(interval * GetTicksPerSecond() - cyclesLate,
+                                         et_JitStatistics);
+}
+
+void CoreTimingProfileCallback(Core::System& system, u64 userdata, s64 cyclesLate)
+{
+  // Each dump only covers the events processed since the previous one.
+  auto& core_timing = system.GetCoreTiming();
+  const std::string summary = core_timing.GetEventProfileSummary();
+  if (!summary.empty())
+    NOTICE_LOG_FMT(POWERPC, "{}", summary);
+  core_timing.ResetEventProfile();
+
+  const s64 interval = Config::Get(Config::MAIN_CORE_TIMING_PROFILE_DUMP_INTERVAL);
+  if (interval > 0)
+    core_timing.ScheduleEvent(interval * GetTicksPerSecond() - cyclesLate, et_CoreTimingProfile);
+}
+
 void VICallback(Core::System& system, u64 userdata, s64 cyclesLate)
 {
   auto& core_timing = system.GetCoreTiming();
@@ -285,6 +317,7 @@ void Init()
   auto& core_timing = system.GetCoreTiming();
   auto& vi = system.GetVideoInterface();
 
+  core_timing.OnTimerResolutionIncreased();
   core_timing.SetFakeTBStartValue(static_cast<u64>(s_cpu_core_clock / TIMER_RATIO) *
                                   static_cast<u64>(ExpansionInterface::CEXIIPL::GetEmulatedTime(
                                       system, ExpansionInterface::CEXIIPL::GC_EPOCH)));
@@ -302,6 +335,8 @@ void Init()
   et_GPU_sleeper = core_timing.RegisterEvent("GPUSleeper", GPUSleepCallback);
   et_perf_tracker = core_timing.RegisterEvent("PerfTracker", PerfTrackerCallback);
   et_PatchEngine = core_timing.RegisterEvent("PatchEngine", PatchEngineCallback);
+  et_JitStatistics = core_timing.RegisterEvent("JitStatistics", JitStatisticsCallback);
+  et_CoreTimingProfile = core_timing.RegisterEvent("CoreTimingProfile", CoreTimingProfileCallback);
 
   core_timing.ScheduleEvent(0, et_perf_tracker);
   core_timing.ScheduleEvent(0, et_GPU_sleeper);
@@ -311,6 +346,21 @@ void Init()
 
   core_timing.ScheduleEvent(vi.GetTicksPerField(), et_PatchEngine);
 
+  const int jit_statistics_dump_interval = Config::Get(Config::MAIN_JIT_STATISTICS_DUMP_INTERVAL);
+  if (jit_statistics_dump_interval > 0)
+  {
+    core_timing.ScheduleEvent(s64{jit_statistics_dump_interval} * GetTicksPerSecond(),
+                              et_JitStatistics);
+  }
+
+  const int core_timing_profile_dump_interval =
+      Config::Get(Config::MAIN_CORE_TIMING_PROFILE_DUMP_INTERVAL);
+  if (Config::Get(Config::MAIN_CORE_TIMING_PROFILING) && core_timing_profile_dump_interval > 0)
+  {
+    core_timing.ScheduleEvent(s64{core_timing_profile_dump_interval} * GetTicksPerSecond(),
+                              et_CoreTimingProfile);
+  }
+
   if (SConfig::GetInstance().bWii)
     core_timing.ScheduleEvent(s_ipc_hle_period, et_IPC_HLE);
 }
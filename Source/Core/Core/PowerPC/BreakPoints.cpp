@@ -139,6 +139,10 @@ void BreakPoints::Add(u32 address, bool temp, bool break_on_hit, bool log_on_hit
   bp.address = address;
   bp.condition = std::move(condition);
 
+  // Compiled code may call the condition of the breakpoint being replaced, so it has to be gone
+  // before that condition gets destroyed.
+  m_system.GetJitInterface().InvalidateICache(address, 4, true);
+
   if (iter != m_breakpoints.end())  // We found an existing breakpoint
   {
     bp.is_enabled = iter->is_enabled;
@@ -148,8 +152,6 @@ void BreakPoints::Add(u32 address, bool temp, bool break_on_hit, bool log_on_hit
   {
     m_breakpoints.emplace_back(std::move(bp));
   }
-
-  m_system.GetJitInterface().InvalidateICache(address, 4, true);
 }
 
 bool BreakPoints::ToggleBreakPoint(u32 address)
@@ -172,8 +174,8 @@ void BreakPoints::Remove(u32 address)
   if (iter == m_breakpoints.cend())
     return;
 
-  m_breakpoints.erase(iter);
   m_system.GetJitInterface().InvalidateICache(address, 4, true);
+  m_breakpoints.erase(iter);
 }
 
 void BreakPoints::Clear()
@@ -3,6 +3,11 @@
 
 #include "Core/PowerPC/CachedInterpreter/CachedInterpreter.h"
 
+#include <bit>
+#include <chrono>
+#include <cstring>
+#include <type_traits>
+
 #include "Common/CommonTypes.h"
 #include "Common/Logging/Log.h"
 #include "Core/ConfigManager.h"
@@ -16,65 +21,8 @@
 #include "Core/PowerPC/PowerPC.h"
 #include "Core/System.h"
 
-struct CachedInterpreter::Instruction
-{
-  using CommonCallback = void (*)(UGeckoInstruction);
-  using ConditionalCallback = bool (*)(u32);
-  using InterpreterCallback = void (*)(Interpreter&, UGeckoInstruction);
-  using CachedInterpreterCallback = void (*)(CachedInterpreter&, UGeckoInstruction);
-  using ConditionalCachedInterpreterCallback = bool (*)(CachedInterpreter&, u32);
-
-  Instruction() {}
-  Instruction(const CommonCallback c, UGeckoInstruction i)
-      : common_callback(c), data(i.hex), type(Type::Common)
-  {
-  }
-
-  Instruction(const ConditionalCallback c, u32 d)
-      : conditional_callback(c), data(d), type(Type::Conditional)
-  {
-  }
-
-  Instruction(const InterpreterCallback c, UGeckoInstruction i)
-      : interpreter_callback(c), data(i.hex), type(Type::Interpreter)
-  {
-  }
-
-  Instruction(const CachedInterpreterCallback c, UGeckoInstruction i)
-      : cached_interpreter_callback(c), data(i.hex), type(Type::CachedInterpreter)
-  {
-  }
-
-  Instruction(const ConditionalCachedInterpreterCallback c, u32 d)
-      : conditional_cached_interpreter_callback(c), data(d),
-        type(Type::ConditionalCachedInterpreter)
-  {
-  }
-
-  enum class Type
-  {
-    Abort,
-    Common,
-    Conditional,
-    Interpreter,
-    CachedInterpreter,
-    ConditionalCachedInterpreter,
-  };
-
-  union
-  {
-    const CommonCallback common_callback = nullptr;
-    const ConditionalCallback conditional_callback;
-    const InterpreterCallback interpreter_callback;
-    const CachedInterpreterCallback cached_interpreter_callback;
-    const ConditionalCachedInterpreterCallback conditional_cached_interpreter_callback;
-  };
-
-  u32 data = 0;
-  Type type = Type::Abort;
-};
-
-CachedInterpreter::CachedInterpreter(Core::System& system) : JitBase(system)
+CachedInterpreter::CachedInterpreter(Core::System& system)
+    : JitBase(system), m_interpreter(system.GetInterpreter())
 {
 }
 
@@ -84,9 +32,12 @@ void CachedInterpreter::Init()
 {
   RefreshConfig();
 
-  m_code.reserve(CODE_SIZE / sizeof(Instruction));
+  m_code.reserve(CODE_SIZE);
 
   jo.enableBlocklink = false;
+  // Blocks continue at the targets of the branches the analyzer follows, see Jit(). Only calls to
+  // leaf functions are followed, since that's needed for detecting the idle loops around them.
+  analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_LEAF_FUNCTION_INLINE);
 
   m_block_cache.Init();
 
@@ -102,53 +53,37 @@ void CachedInterpreter::Shutdown()
 
 u8* CachedInterpreter::GetCodePtr()
 {
-  return reinterpret_cast<u8*>(m_code.data() + m_code.size());
+  return m_code.data() + m_code.size();
+}
+
+template <class Operands, CachedInterpreter::Callback<Operands> callback>
+void CachedInterpreter::Write(const Operands& operands)
+{
+  static_assert(std::is_trivially_copyable_v<Operands>);
+
+  const AnyCallback entry = CallbackEntry<Operands, callback>;
+  const size_t offset = m_code.size();
+  m_code.resize(offset + GetEntrySize<Operands>());
+  std::memcpy(m_code.data() + offset, &entry, sizeof(entry));
+  std::memcpy(m_code.data() + offset + sizeof(entry), &operands, sizeof(operands));
 }
 
 void CachedInterpreter::ExecuteOneBlock()
 {
-  const u8* normal_entry = m_block_cache.Dispatch();
-  if (!normal_entry)
+  const u8* code = m_block_cache.Dispatch();
+  if (!code)
   {
     Jit(m_ppc_state.pc);
     return;
   }
 
-  const Instruction* code = reinterpret_cast<const Instruction*>(normal_entry);
-  auto& interpreter = m_system.GetInterpreter();
-
-  for (; code->type != Instruction::Type::Abort; ++code)
+  s32 entry_size;
+  do
   {
-    switch (code->type)
-    {
-    case Instruction::Type::Common:
-      code->common_callback(UGeckoInstruction(code->data));
-      break;
-
-    case Instruction::Type::Conditional:
-      if (code->conditional_callback(code->data))
-        return;
-      break;
-
-    case Instruction::Type::Interpreter:
-      code->interpreter_callback(interpreter, UGeckoInstruction(code->data));
-      break;
-
-    case Instruction::Type::CachedInterpreter:
-      code->cached_interpreter_callback(*this, UGeckoInstruction(code->data));
-      break;
-
-    case Instruction::Type::ConditionalCachedInterpreter:
-      if (code->conditional_cached_interpreter_callback(*this, code->data))
-        return;
-      break;
-
-    default:
-      ERROR_LOG_FMT(POWERPC, "Unknown CachedInterpreter Instruction: {}",
-                    static_cast<int>(code->type));
-      break;
-    }
-  }
+    const AnyCallback callback = *reinterpret_cast<const AnyCallback*>(code);
+    entry_size = callback(*this, code + sizeof(AnyCallback));
+    code += entry_size;
+  } while (entry_size != 0);
 }
 
 void CachedInterpreter::Run()
@@ -177,96 +112,166 @@ void CachedInterpreter::SingleStep()
   ExecuteOneBlock();
 }
 
-void CachedInterpreter::EndBlock(CachedInterpreter& cached_interpreter, UGeckoInstruction data)
-{
-  auto& ppc_state = cached_interpreter.m_ppc_state;
-  ppc_state.pc = ppc_state.npc;
-  ppc_state.downcount -= data.hex;
-  PowerPC::UpdatePerformanceMonitor(data.hex, 0, 0, ppc_state);
-}
-
-void CachedInterpreter::UpdateNumLoadStoreInstructions(CachedInterpreter& cached_interpreter,
-                                                       UGeckoInstruction data)
+bool CachedInterpreter::ExecuteInterpreter(CachedInterpreter& cached_interpreter,
+                                           const InterpreterOperands& operands)
 {
-  PowerPC::UpdatePerformanceMonitor(0, data.hex, 0, cached_interpreter.m_ppc_state);
+  operands.func(cached_interpreter.m_interpreter, operands.inst);
+  return false;
 }
 
-void CachedInterpreter::UpdateNumFloatingPointInstructions(CachedInterpreter& cached_interpreter,
-                                                           UGeckoInstruction data)
+bool CachedInterpreter::EndBlock(CachedInterpreter& cached_interpreter,
+                                 const EndBlockOperands& operands)
 {
-  PowerPC::UpdatePerformanceMonitor(0, 0, data.hex, cached_interpreter.m_ppc_state);
+  auto& ppc_state = cached_interpreter.m_ppc_state;
+  ppc_state.pc = ppc_state.npc;
+  ppc_state.downcount -= operands.downcount;
+  PowerPC::UpdatePerformanceMonitor(operands.downcount, operands.num_load_stores,
+                                    operands.num_fp_inst, ppc_state);
+  return true;
 }
 
-void CachedInterpreter::WritePC(CachedInterpreter& cached_interpreter, UGeckoInstruction data)
+bool CachedInterpreter::WritePC(CachedInterpreter& cached_interpreter,
+                                const AddressOperands& operands)
 {
   auto& ppc_state = cached_interpreter.m_ppc_state;
-  ppc_state.pc = data.hex;
-  ppc_state.npc = data.hex + 4;
+  ppc_state.pc = operands.address;
+  ppc_state.npc = operands.address + 4;
+  return false;
 }
 
-void CachedInterpreter::WriteBrokenBlockNPC(CachedInterpreter& cached_interpreter,
-                                            UGeckoInstruction data)
+bool CachedInterpreter::WriteBrokenBlockNPC(CachedInterpreter& cached_interpreter,
+                                            const AddressOperands& operands)
 {
-  cached_interpreter.m_ppc_state.npc = data.hex;
+  cached_interpreter.m_ppc_state.npc = operands.address;
+  return false;
 }
 
-bool CachedInterpreter::CheckFPU(CachedInterpreter& cached_interpreter, u32 data)
+bool CachedInterpreter::CheckFPU(CachedInterpreter& cached_interpreter,
+                                 const DowncountOperands& operands)
 {
   auto& ppc_state = cached_interpreter.m_ppc_state;
   if (!ppc_state.msr.FP)
   {
     ppc_state.Exceptions |= EXCEPTION_FPU_UNAVAILABLE;
     cached_interpreter.m_system.GetPowerPC().CheckExceptions();
-    ppc_state.downcount -= data;
+    ppc_state.downcount -= operands.downcount;
     return true;
   }
   return false;
 }
 
-bool CachedInterpreter::CheckDSI(CachedInterpreter& cached_interpreter, u32 data)
+bool CachedInterpreter::CheckDSI(CachedInterpreter& cached_interpreter,
+                                 const DowncountOperands& operands)
 {
   auto& ppc_state = cached_interpreter.m_ppc_state;
   if (ppc_state.Exceptions & EXCEPTION_DSI)
   {
     cached_interpreter.m_system.GetPowerPC().CheckExceptions();
-    ppc_state.downcount -= data;
+    ppc_state.downcount -= operands.downcount;
     return true;
   }
   return false;
 }
 
-bool CachedInterpreter::CheckProgramException(CachedInterpreter& cached_interpreter, u32 data)
+bool CachedInterpreter::CheckProgramException(CachedInterpreter& cached_interpreter,
+                                              const DowncountOperands& operands)
 {
   auto& ppc_state = cached_interpreter.m_ppc_state;
   if (ppc_state.Exceptions & EXCEPTION_PROGRAM)
   {
     cached_interpreter.m_system.GetPowerPC().CheckExceptions();
-    ppc_state.downcount -= data;
+    ppc_state.downcount -= operands.downcount;
     return true;
   }
   return false;
 }
 
-bool CachedInterpreter::CheckBreakpoint(CachedInterpreter& cached_interpreter, u32 data)
+bool CachedInterpreter::CheckBreakpoint(CachedInterpreter& cached_interpreter,
+                                        const DowncountOperands& operands)
 {
   cached_interpreter.m_system.GetPowerPC().CheckBreakPoints();
   if (cached_interpreter.m_system.GetCPU().GetState() != CPU::State::Running)
   {
-    cached_interpreter.m_ppc_state.downcount -= data;
+    cached_interpreter.m_ppc_state.downcount -= operands.downcount;
     return true;
   }
   return false;
 }
 
-bool CachedInterpreter::CheckIdle(CachedInterpreter& cached_interpreter, u32 idle_pc)
+bool CachedInterpreter::CheckIdle(CachedInterpreter& cached_interpreter,
+                                  const AddressOperands& operands)
 {
-  if (cached_interpreter.m_ppc_state.npc == idle_pc)
+  if (cached_interpreter.m_ppc_state.npc == operands.address)
   {
     cached_interpreter.m_system.GetCoreTiming().Idle();
   }
   return false;
 }
 
+bool CachedInterpreter::Abort(CachedInterpreter& cached_interpreter, const EmptyOperands& operands)
+{
+  return true;
+}
+
+bool CachedInterpreter::RotateAndMask(CachedInterpreter& cached_interpreter,
+                                      const RotateAndMaskOperands& operands)
+{
+  auto& ppc_state = cached_interpreter.m_ppc_state;
+  ppc_state.gpr[operands.ra] = std::rotl(ppc_state.gpr[operands.rs], operands.sh) & operands.mask;
+  return false;
+}
+
+bool CachedInterpreter::RotateAndMaskPair(CachedInterpreter& cached_interpreter,
+                                          const RotateAndMaskPairOperands& operands)
+{
+  auto& ppc_state = cached_interpreter.m_ppc_state;
+  ppc_state.gpr[operands.ra] = std::rotl(ppc_state.gpr[operands.rs], operands.sh) & operands.mask;
+  ppc_state.gpr[operands.second_ra] =
+      std::rotl(ppc_state.gpr[operands.ra], operands.second_sh) & operands.second_mask;
+  return false;
+}
+
+template <typename T, bool immediate>
+bool CachedInterpreter::CompareAndBranch(CachedInterpreter& cached_interpreter,
+                                         const CompareAndBranchOperands& operands)
+{
+  auto& ppc_state = cached_interpreter.m_ppc_state;
+  const T a = static_cast<T>(ppc_state.gpr[operands.ra]);
+  const T b = static_cast<T>(immediate ? operands.imm : ppc_state.gpr[operands.rb]);
+
+  u32 cr_field;
+  if (a < b)
+    cr_field = PowerPC::CR_LT;
+  else if (a > b)
+    cr_field = PowerPC::CR_GT;
+  else
+    cr_field = PowerPC::CR_EQ;
+
+  if (ppc_state.GetXER_SO())
+    cr_field |= PowerPC::CR_SO;
+
+  ppc_state.cr.SetField(operands.crf, cr_field);
+
+  if (((cr_field & operands.cr_mask) != 0) == operands.branch_if_set)
+    ppc_state.npc = operands.target;
+  return false;
+}
+
+bool CachedInterpreter::LoadAndExecute(CachedInterpreter& cached_interpreter,
+                                       const LoadAndExecuteOperands& operands)
+{
+  auto& ppc_state = cached_interpreter.m_ppc_state;
+  const u32 address =
+      operands.ra ? ppc_state.gpr[operands.ra] + operands.offset : operands.offset;
+  const u32 value = cached_interpreter.m_mmu.Read_U32(address);
+
+  if (!(ppc_state.Exceptions & EXCEPTION_DSI))
+    ppc_state.gpr[operands.rd] = value;
+
+  operands.func(cached_interpreter.m_interpreter, operands.inst);
+  return false;
+}
+
 bool CachedInterpreter::HandleFunctionHooking(u32 address)
 {
   // CachedInterpreter inherits from JitBase and is considered a JIT by relevant code.
@@ -275,25 +280,133 @@ bool CachedInterpreter::HandleFunctionHooking(u32 address)
   if (!result)
     return false;
 
-  m_code.emplace_back(WritePC, address);
-  m_code.emplace_back(Interpreter::HLEFunction, result.hook_index);
+  Write<AddressOperands, WritePC>({address});
+  Write<InterpreterOperands, ExecuteInterpreter>(
+      {Interpreter::HLEFunction, UGeckoInstruction(result.hook_index)});
 
   if (result.type != HLE::HookType::Replace)
     return false;
 
-  m_code.emplace_back(EndBlock, js.downcountAmount);
-  m_code.emplace_back();
+  Write<EndBlockOperands, EndBlock>({static_cast<u32>(js.downcountAmount), 0, 0});
   return true;
 }
 
-void CachedInterpreter::Jit(u32 address)
+void CachedInterpreter::CountInstruction(const PPCAnalyst::CodeOp& op)
+{
+  js.downcountAmount += op.opinfo->num_cycles;
+  if (op.opinfo->flags & FL_LOADSTORE)
+    ++js.numLoadStoreInst;
+  if (op.opinfo->flags & FL_USE_FPU)
+    ++js.numFloatingPointInst;
+}
+
+bool CachedInterpreter::CanFuse(const PPCAnalyst::CodeOp& op)
 {
-  if (m_code.size() >= CODE_SIZE / sizeof(Instruction) - 0x1000 ||
-      SConfig::GetInstance().bJITNoBlockCache)
+  if (op.skip || op.branchIsIdleLoop)
+    return false;
+  if (m_enable_debugging &&
+      m_system.GetPowerPC().GetBreakPoints().IsAddressBreakPoint(op.address))
   {
-    ClearCache();
+    return false;
   }
+  if ((op.opinfo->flags & FL_USE_FPU) && !js.firstFPInstructionFound)
+    return false;
+  if ((op.opinfo->flags & FL_LOADSTORE) && jo.memcheck)
+    return false;
+  if (ShouldHandleFPExceptionForInstruction(&op))
+    return false;
+  return !HLE::TryReplaceFunction(op.address, PowerPC::CoreMode::JIT);
+}
+
+u32 CachedInterpreter::WriteSuperinstruction(u32 index)
+{
+  const PPCAnalyst::CodeOp& op = m_code_buffer[index];
+  if (!CanFuse(op))
+    return 0;
+
+  const UGeckoInstruction inst = op.inst;
+  const PPCAnalyst::CodeOp* next = nullptr;
+  if (index + 1 < code_block.m_num_instructions && CanFuse(m_code_buffer[index + 1]))
+    next = &m_code_buffer[index + 1];
+
+  // rlwinm, and chains of two of them.
+  if (inst.OPCD == 21 && !inst.Rc)
+  {
+    const u32 mask = MakeRotationMask(inst.MB, inst.ME);
+    if (next && next->inst.OPCD == 21 && !next->inst.Rc && next->inst.RS == inst.RA)
+    {
+      CountInstruction(*next);
+      Write<RotateAndMaskPairOperands, RotateAndMaskPair>(
+          {mask, MakeRotationMask(next->inst.MB, next->inst.ME), static_cast<u8>(inst.RA),
+           static_cast<u8>(inst.RS), static_cast<u8>(inst.SH), static_cast<u8>(next->inst.RA),
+           static_cast<u8>(next->inst.SH)});
+      return 2;
+    }
+
+    Write<RotateAndMaskOperands, RotateAndMask>(
+        {mask, static_cast<u8>(inst.RA), static_cast<u8>(inst.RS), static_cast<u8>(inst.SH)});
+    return 1;
+  }
+
+  if (!next)
+    return 0;
+
+  // A compare followed by a conditional branch on its result, ending the block.
+  const bool is_cmpi = inst.OPCD == 11;
+  const bool is_cmpli = inst.OPCD == 10;
+  const bool is_cmp = inst.OPCD == 31 && inst.SUBOP10 == 0;
+  const bool is_cmpl = inst.OPCD == 31 && inst.SUBOP10 == 32;
+  const UGeckoInstruction branch = next->inst;
+  if ((is_cmpi || is_cmpli || is_cmp || is_cmpl) && branch.OPCD == 16 && !branch.LK &&
+      (branch.BO & BO_DONT_DECREMENT_FLAG) && !(branch.BO & BO_DONT_CHECK_CONDITION) &&
+      static_cast<u32>(branch.BI >> 2) == inst.CRFD)
+  {
+    const u32 offset = u32(SignExt16(s16(branch.BD << 2)));
+    const CompareAndBranchOperands operands{
+        is_cmpli ? inst.UIMM : u32(inst.SIMM_16),
+        branch.AA ? offset : next->address + offset,
+        static_cast<u8>(inst.CRFD),
+        static_cast<u8>(inst.RA),
+        static_cast<u8>(inst.RB),
+        static_cast<u8>(8 >> (branch.BI & 3)),
+        (branch.BO & BO_BRANCH_IF_TRUE) != 0,
+    };
+
+    Write<AddressOperands, WritePC>({next->address});
+    if (is_cmpi)
+      Write<CompareAndBranchOperands, CompareAndBranch<s32, true>>(operands);
+    else if (is_cmpli)
+      Write<CompareAndBranchOperands, CompareAndBranch<u32, true>>(operands);
+    else if (is_cmp)
+      Write<CompareAndBranchOperands, CompareAndBranch<s32, false>>(operands);
+    else
+      Write<CompareAndBranchOperands, CompareAndBranch<u32, false>>(operands);
+
+    CountInstruction(*next);
+    Write<EndBlockOperands, EndBlock>({static_cast<u32>(js.downcountAmount), js.numLoadStoreInst,
+                                       js.numFloatingPointInst});
+    return 2;
+  }
+
+  // lwz followed by an instruction using the loaded value.
+  if (inst.OPCD == 32 && !(next->opinfo->flags & FL_ENDBLOCK) && next->regsIn[inst.RD])
+  {
+    CountInstruction(*next);
+    Write<LoadAndExecuteOperands, LoadAndExecute>(
+        {Interpreter::GetInterpreterOp(next->inst), next->inst, u32(inst.SIMM_16),
+         static_cast<u8>(inst.RD), static_cast<u8>(inst.RA)});
+    return 2;
+  }
+
+  return 0;
+}
 
+void CachedInterpreter::Jit(u32 address)
+{
+  if (m_code.size() >= CODE_SIZE - 0x10000 || SConfig::GetInstance().bJITNoBlockCache)
+    ClearCache();
+
+  const auto analysis_start = std::chrono::steady_clock::now();
   const u32 nextPC =
       analyzer.Analyze(m_ppc_state.pc, &code_block, &m_code_buffer, m_code_buffer.size());
   if (code_block.m_memory_exception)
@@ -322,70 +435,81 @@ void CachedInterpreter::Jit(u32 address)
   {
     PPCAnalyst::CodeOp& op = m_code_buffer[i];
 
-    js.downcountAmount += op.opinfo->num_cycles;
-    if (op.opinfo->flags & FL_LOADSTORE)
-      ++js.numLoadStoreInst;
-    if (op.opinfo->flags & FL_USE_FPU)
-      ++js.numFloatingPointInst;
+    CountInstruction(op);
 
     if (HandleFunctionHooking(op.address))
       break;
 
     if (!op.skip)
     {
+      if (const u32 covered = WriteSuperinstruction(i))
+      {
+        i += covered - 1;
+        continue;
+      }
+
       const bool breakpoint =
           m_enable_debugging &&
           m_system.GetPowerPC().GetBreakPoints().IsAddressBreakPoint(op.address);
       const bool check_fpu = (op.opinfo->flags & FL_USE_FPU) && !js.firstFPInstructionFound;
-      const bool endblock = (op.opinfo->flags & FL_ENDBLOCK) != 0;
+      // The block goes on with the instructions at the target of a branch the analyzer followed.
+      // The interpreter still computes the target and the return address from the PC.
+      const bool unconditional_branch =
+          op.inst.OPCD == 18 || (op.inst.OPCD == 16 && (op.inst.BO & BO_DONT_DECREMENT_FLAG) &&
+                                 (op.inst.BO & BO_DONT_CHECK_CONDITION));
+      const bool followed_branch = unconditional_branch && i + 1 < code_block.m_num_instructions &&
+                                   m_code_buffer[i + 1].address == op.branchTo;
+      const bool endblock = (op.opinfo->flags & FL_ENDBLOCK) && !followed_branch;
       const bool memcheck = (op.opinfo->flags & FL_LOADSTORE) && jo.memcheck;
       const bool check_program_exception = !endblock && ShouldHandleFPExceptionForInstruction(&op);
       const bool idle_loop = op.branchIsIdleLoop;
 
-      if (breakpoint || check_fpu || endblock || memcheck || check_program_exception)
-        m_code.emplace_back(WritePC, op.address);
+      if (breakpoint || check_fpu || endblock || followed_branch || memcheck ||
+          check_program_exception)
+        Write<AddressOperands, WritePC>({op.address});
 
       if (breakpoint)
-        m_code.emplace_back(CheckBreakpoint, js.downcountAmount);
+        Write<DowncountOperands, CheckBreakpoint>({static_cast<u32>(js.downcountAmount)});
 
       if (check_fpu)
       {
-        m_code.emplace_back(CheckFPU, js.downcountAmount);
+        Write<DowncountOperands, CheckFPU>({static_cast<u32>(js.downcountAmount)});
         js.firstFPInstructionFound = true;
       }
 
-      m_code.emplace_back(Interpreter::GetInterpreterOp(op.inst), op.inst);
+      Write<InterpreterOperands, ExecuteInterpreter>(
+          {Interpreter::GetInterpreterOp(op.inst), op.inst});
       if (memcheck)
-        m_code.emplace_back(CheckDSI, js.downcountAmount);
+        Write<DowncountOperands, CheckDSI>({static_cast<u32>(js.downcountAmount)});
       if (check_program_exception)
-        m_code.emplace_back(CheckProgramException, js.downcountAmount);
+        Write<DowncountOperands, CheckProgramException>({static_cast<u32>(js.downcountAmount)});
       if (idle_loop)
-        m_code.emplace_back(CheckIdle, js.blockStart);
+        Write<AddressOperands, CheckIdle>({js.blockStart});
       if (endblock)
       {
-        m_code.emplace_back(EndBlock, js.downcountAmount);
-        m_code.emplace_back(UpdateNumLoadStoreInstructions, js.numLoadStoreInst);
-        m_code.emplace_back(UpdateNumFloatingPointInstructions, js.numFloatingPointInst);
+        Write<EndBlockOperands, EndBlock>({static_cast<u32>(js.downcountAmount),
+                                           js.numLoadStoreInst, js.numFloatingPointInst});
       }
     }
   }
   if (code_block.m_broken)
   {
-    m_code.emplace_back(WriteBrokenBlockNPC, nextPC);
-    m_code.emplace_back(EndBlock, js.downcountAmount);
-    m_code.emplace_back(UpdateNumLoadStoreInstructions, js.numLoadStoreInst);
-    m_code.emplace_back(UpdateNumFloatingPointInstructions, js.numFloatingPointInst);
+    Write<AddressOperands, WriteBrokenBlockNPC>({nextPC});
+    Write<EndBlockOperands, EndBlock>({static_cast<u32>(js.downcountAmount), js.numLoadStoreInst,
+                                       js.numFloatingPointInst});
   }
-  m_code.emplace_back();
+  Write<EmptyOperands, Abort>({});
 
   b->codeSize = static_cast<u32>(GetCodePtr() - b->normalEntry);
   b->originalSize = code_block.m_num_instructions;
 
   m_block_cache.FinalizeBlock(*b, jo.enableBlocklink, code_block.m_physical_addresses);
+  RecordCompiledBlock(*b, std::chrono::steady_clock::now() - analysis_start);
 }
 
 void CachedInterpreter::ClearCache()
 {
+  m_statistics.cache_clears++;
   m_code.clear();
   m_block_cache.Clear();
   RefreshConfig();
@@ -7,6 +7,8 @@
 
 #include "Common/CommonTypes.h"
 #include "Core/PowerPC/CachedInterpreter/InterpreterBlockCache.h"
+#include "Core/PowerPC/Gekko.h"
+#include "Core/PowerPC/Interpreter/Interpreter.h"
 #include "Core/PowerPC/JitCommon/JitBase.h"
 #include "Core/PowerPC/PPCAnalyst.h"
 
@@ -36,26 +38,128 @@ public:
   const CommonAsmRoutinesBase* GetAsmRoutines() override { return nullptr; }
 
 private:
-  struct Instruction;
+  // The generated code is a sequence of entries, each made of a callback followed by its
+  // predecoded operands. Execution jumps from one entry to the next through the offset returned
+  // by the callback, which is 0 once the block has to be left.
+  using AnyCallback = s32 (*)(CachedInterpreter& cached_interpreter, const u8* operands);
+  template <class Operands>
+  using Callback = bool (*)(CachedInterpreter& cached_interpreter, const Operands& operands);
+
+  struct InterpreterOperands
+  {
+    Interpreter::Instruction func;
+    UGeckoInstruction inst;
+  };
+  struct EndBlockOperands
+  {
+    u32 downcount;
+    u32 num_load_stores;
+    u32 num_fp_inst;
+  };
+  struct AddressOperands
+  {
+    u32 address;
+  };
+  struct DowncountOperands
+  {
+    u32 downcount;
+  };
+  struct EmptyOperands
+  {
+  };
+
+  // Superinstructions, covering common sequences of guest instructions with a single entry.
+  struct RotateAndMaskOperands
+  {
+    u32 mask;
+    u8 ra;
+    u8 rs;
+    u8 sh;
+  };
+  struct RotateAndMaskPairOperands
+  {
+    u32 mask;
+    u32 second_mask;
+    u8 ra;
+    u8 rs;
+    u8 sh;
+    u8 second_ra;
+    u8 second_sh;
+  };
+  struct CompareAndBranchOperands
+  {
+    u32 imm;
+    u32 target;
+    u8 crf;
+    u8 ra;
+    u8 rb;
+    u8 cr_mask;
+    bool branch_if_set;
+  };
+  struct LoadAndExecuteOperands
+  {
+    Interpreter::Instruction func;
+    UGeckoInstruction inst;
+    u32 offset;
+    u8 rd;
+    u8 ra;
+  };
+
+  template <class Operands>
+  static constexpr s32 GetEntrySize()
+  {
+    constexpr size_t align = alignof(AnyCallback);
+    return static_cast<s32>((sizeof(AnyCallback) + sizeof(Operands) + align - 1) & ~(align - 1));
+  }
+
+  template <class Operands, Callback<Operands> callback>
+  static s32 CallbackEntry(CachedInterpreter& cached_interpreter, const u8* operands)
+  {
+    if (callback(cached_interpreter, *reinterpret_cast<const Operands*>(operands)))
+      return 0;
+    return GetEntrySize<Operands>();
+  }
+
+  template <class Operands, Callback<Operands> callback>
+  void Write(const Operands& operands);
 
   u8* GetCodePtr();
   void ExecuteOneBlock();
 
   bool HandleFunctionHooking(u32 address);
+  void CountInstruction(const PPCAnalyst::CodeOp& op);
+  // Returns whether op can be part of a superinstruction, i.e. doesn't need any other entries.
+  bool CanFuse(const PPCAnalyst::CodeOp& op);
+  // Writes a superinstruction starting at the given instruction of the block if there is one
+  // matching, and returns the number of guest instructions it covers, or 0.
+  u32 WriteSuperinstruction(u32 index);
+
+  static bool ExecuteInterpreter(CachedInterpreter& cached_interpreter,
+                                 const InterpreterOperands& operands);
+  static bool EndBlock(CachedInterpreter& cached_interpreter, const EndBlockOperands& operands);
+  static bool WritePC(CachedInterpreter& cached_interpreter, const AddressOperands& operands);
+  static bool WriteBrokenBlockNPC(CachedInterpreter& cached_interpreter,
+                                  const AddressOperands& operands);
+  static bool CheckFPU(CachedInterpreter& cached_interpreter, const DowncountOperands& operands);
+  static bool CheckDSI(CachedInterpreter& cached_interpreter, const DowncountOperands& operands);
+  static bool CheckProgramException(CachedInterpreter& cached_interpreter,
+                                    const DowncountOperands& operands);
+  static bool CheckBreakpoint(CachedInterpreter& cached_interpreter,
+                              const DowncountOperands& operands);
+  static bool CheckIdle(CachedInterpreter& cached_interpreter, const AddressOperands& operands);
+  static bool Abort(CachedInterpreter& cached_interpreter, const EmptyOperands& operands);
 
-  static void EndBlock(CachedInterpreter& cached_interpreter, UGeckoInstruction data);
-  static void UpdateNumLoadStoreInstructions(CachedInterpreter& cached_interpreter,
-                                             UGeckoInstruction data);
-  static void UpdateNumFloatingPointInstructions(CachedInterpreter& cached_interpreter,
-                                                 UGeckoInstruction data);
-  static void WritePC(CachedInterpreter& cached_interpreter, UGeckoInstruction data);
-  static void WriteBrokenBlockNPC(CachedInterpreter& cached_interpreter, UGeckoInstruction data);
-  static bool CheckFPU(CachedInterpreter& cached_interpreter, u32 data);
-  static bool CheckDSI(CachedInterpreter& cached_interpreter, u32 data);
-  static bool CheckProgramException(CachedInterpreter& cached_interpreter, u32 data);
-  static bool CheckBreakpoint(CachedInterpreter& cached_interpreter, u32 data);
-  static bool CheckIdle(CachedInterpreter& cached_interpreter, u32 idle_pc);
+  static bool RotateAndMask(CachedInterpreter& cached_interpreter,
+                            const RotateAndMaskOperands& operands);
+  static bool RotateAndMaskPair(CachedInterpreter& cached_interpreter,
+                                const RotateAndMaskPairOperands& operands);
+  template <typename T, bool immediate>
+  static bool CompareAndBranch(CachedInterpreter& cached_interpreter,
+                               const CompareAndBranchOperands& operands);
+  static bool LoadAndExecute(CachedInterpreter& cached_interpreter,
+                             const LoadAndExecuteOperands& operands);
 
+  Interpreter& m_interpreter;
   BlockCache m_block_cache{*this};
-  std::vector<Instruction> m_code;
+  std::vector<u8> m_code;
 };
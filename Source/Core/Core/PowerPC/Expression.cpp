@@ -4,6 +4,7 @@
 #include "Core/PowerPC/Expression.h"
 
 #include <algorithm>
+#include <array>
 #include <cstdlib>
 #include <fmt/format.h>
 #include <optional>
@@ -22,6 +23,10 @@
 #include "Core/PowerPC/PowerPC.h"
 #include "Core/System.h"
 
+#ifdef _M_X86_64
+#include "Core/PowerPC/Jit64Common/CompiledExpression.h"
+#endif
+
 template <typename T>
 static T HostRead(const Core::CPUThreadGuard& guard, u32 address);
 
@@ -77,16 +82,22 @@ void HostWrite(const Core::CPUThreadGuard& guard, u64 var, u32 address)
 }
 
 template <typename T, typename U = T>
-static double HostReadFunc(expr_func* f, vec_expr_t* args, void* c)
+static double HostReadValue(double address_value)
 {
-  if (vec_len(args) != 1)
-    return 0;
-  const u32 address = static_cast<u32>(expr_eval(&vec_nth(args, 0)));
+  const u32 address = static_cast<u32>(address_value);
 
   Core::CPUThreadGuard guard(Core::System::GetInstance());
   return Common::BitCast<T>(HostRead<U>(guard, address));
 }
 
+template <typename T, typename U = T>
+static double HostReadFunc(expr_func* f, vec_expr_t* args, void* c)
+{
+  if (vec_len(args) != 1)
+    return 0;
+  return HostReadValue<T, U>(expr_eval(&vec_nth(args, 0)));
+}
+
 template <typename T, typename U = T>
 static double HostWriteFunc(expr_func* f, vec_expr_t* args, void* c)
 {
@@ -100,12 +111,18 @@ static double HostWriteFunc(expr_func* f, vec_expr_t* args, void* c)
   return var;
 }
 
+template <typename T, typename U = T>
+static double CastValue(double value)
+{
+  return Common::BitCast<T>(static_cast<U>(value));
+}
+
 template <typename T, typename U = T>
 static double CastFunc(expr_func* f, vec_expr_t* args, void* c)
 {
   if (vec_len(args) != 1)
     return 0;
-  return Common::BitCast<T>(static_cast<U>(expr_eval(&vec_nth(args, 0))));
+  return CastValue<T, U>(expr_eval(&vec_nth(args, 0)));
 }
 
 static double CallstackFunc(expr_func* f, vec_expr_t* args, void* c)
@@ -203,6 +220,31 @@ static std::array<expr_func, 23> g_expr_funcs{{
     {},
 }};
 
+// The functions of g_expr_funcs which compiled expressions may call.
+static const std::array<std::pair<exprfn_t, Expression::PureFunction>, 14> s_pure_funcs{{
+    {HostReadFunc<u8>, HostReadValue<u8>},
+    {HostReadFunc<s8, u8>, HostReadValue<s8, u8>},
+    {HostReadFunc<u16>, HostReadValue<u16>},
+    {HostReadFunc<s16, u16>, HostReadValue<s16, u16>},
+    {HostReadFunc<u32>, HostReadValue<u32>},
+    {HostReadFunc<s32, u32>, HostReadValue<s32, u32>},
+    {HostReadFunc<float, u32>, HostReadValue<float, u32>},
+    {HostReadFunc<double, u64>, HostReadValue<double, u64>},
+    {CastFunc<u8>, CastValue<u8>},
+    {CastFunc<s8, u8>, CastValue<s8, u8>},
+    {CastFunc<u16>, CastValue<u16>},
+    {CastFunc<s16, u16>, CastValue<s16, u16>},
+    {CastFunc<u32>, CastValue<u32>},
+    {CastFunc<s32, u32>, CastValue<s32, u32>},
+}};
+
+[[maybe_unused]] static Expression::PureFunction LookupPureFunction(const expr_func* f)
+{
+  const auto it = std::find_if(s_pure_funcs.begin(), s_pure_funcs.end(),
+                               [f](const auto& entry) { return entry.first == f->f; });
+  return it != s_pure_funcs.end() ? it->second : nullptr;
+}
+
 void ExprDeleter::operator()(expr* expression) const
 {
   expr_destroy(expression, nullptr);
@@ -216,6 +258,13 @@ void ExprVarListDeleter::operator()(expr_var_list* vars) const
   delete vars;
 }
 
+void CompiledExpressionDeleter::operator()(CompiledExpression* compiled) const
+{
+#ifdef _M_X86_64
+  delete compiled;
+#endif
+}
+
 Expression::Expression(std::string_view text, ExprPointer ex, ExprVarListPointer vars)
     : m_text(text), m_expr(std::move(ex)), m_vars(std::move(vars))
 {
@@ -254,6 +303,11 @@ Expression::Expression(std::string_view text, ExprPointer ex, ExprVarListPointer
 
     m_binds.emplace_back(bind);
   }
+
+#ifdef _M_X86_64
+  m_compiled.reset(
+      CompiledExpression::Compile(*m_expr, *m_vars, m_binds, LookupPureFunction).release());
+#endif
 }
 
 std::optional<Expression> Expression::TryParse(std::string_view text)
@@ -268,6 +322,18 @@ std::optional<Expression> Expression::TryParse(std::string_view text)
 
 double Expression::Evaluate(Core::System& system) const
 {
+  if (const CompiledFunction compiled_function = GetCompiledFunction())
+  {
+    const double result = compiled_function(&system.GetPPCState());
+
+    // Compiled expressions can't assign to variables, so the bindings only need to be read for
+    // the report.
+    SynchronizeBindings(system, SynchronizeDirection::From);
+    Reporting(result);
+
+    return result;
+  }
+
   SynchronizeBindings(system, SynchronizeDirection::From);
 
   double result = expr_eval(m_expr.get());
@@ -279,6 +345,15 @@ double Expression::Evaluate(Core::System& system) const
   return result;
 }
 
+Expression::CompiledFunction Expression::GetCompiledFunction() const
+{
+#ifdef _M_X86_64
+  if (m_compiled)
+    return m_compiled->GetFunction();
+#endif
+  return nullptr;
+}
+
 void Expression::SynchronizeBindings(Core::System& system, SynchronizeDirection dir) const
 {
   auto& ppc_state = system.GetPPCState();
@@ -320,15 +395,16 @@ void Expression::SynchronizeBindings(Core::System& system, SynchronizeDirection
 void Expression::Reporting(const double result) const
 {
   bool is_nan = std::isnan(result);
-  std::string message;
+  for (auto* v = m_vars->head; v != nullptr && !is_nan; v = v->next)
+    is_nan = std::isnan(v->value);
 
-  for (auto* v = m_vars->head; v != nullptr; v = v->next)
-  {
-    if (std::isnan(v->value))
-      is_nan = true;
+  // Conditions are evaluated on every hit, so only format the variables if there's a report.
+  if (result == 0.0 && !is_nan)
+    return;
 
+  std::string message;
+  for (auto* v = m_vars->head; v != nullptr; v = v->next)
     fmt::format_to(std::back_inserter(message), "  {}={}", v->name, v->value);
-  }
 
   if (is_nan)
   {
@@ -336,8 +412,7 @@ void Expression::Reporting(const double result) const
     Core::DisplayMessage("Breakpoint condition has encountered a NaN.", 2000);
   }
 
-  if (result != 0.0 || is_nan)
-    NOTICE_LOG_FMT(MEMMAP, "Breakpoint condition returned: {}. Vars:{}", result, message);
+  NOTICE_LOG_FMT(MEMMAP, "Breakpoint condition returned: {}. Vars:{}", result, message);
 }
 
 std::string Expression::GetText() const
@@ -10,6 +10,7 @@
 #include <vector>
 
 struct expr;
+struct expr_func;
 struct expr_var_list;
 
 namespace Core
@@ -18,6 +19,13 @@ class CPUThreadGuard;
 class System;
 }  // namespace Core
 
+namespace PowerPC
+{
+struct PowerPCState;
+}
+
+class CompiledExpression;
+
 struct ExprDeleter
 {
   void operator()(expr* expression) const;
@@ -32,22 +40,16 @@ struct ExprVarListDeleter
 
 using ExprVarListPointer = std::unique_ptr<expr_var_list, ExprVarListDeleter>;
 
-class Expression
+struct CompiledExpressionDeleter
 {
-public:
-  static std::optional<Expression> TryParse(std::string_view text);
-
-  double Evaluate(Core::System& system) const;
-
-  std::string GetText() const;
+  void operator()(CompiledExpression* compiled) const;
+};
 
-private:
-  enum class SynchronizeDirection
-  {
-    From,
-    To,
-  };
+using CompiledExpressionPointer = std::unique_ptr<CompiledExpression, CompiledExpressionDeleter>;
 
+class Expression
+{
+public:
   enum class VarBindingType
   {
     Zero,
@@ -63,6 +65,29 @@ private:
     int index = -1;
   };
 
+  // Functions which can be called from compiled expressions: they take a single argument and have
+  // no side effects on the emulated state.
+  using PureFunction = double (*)(double argument);
+  using CompiledFunction = double (*)(const PowerPC::PowerPCState* ppc_state);
+
+  static std::optional<Expression> TryParse(std::string_view text);
+
+  double Evaluate(Core::System& system) const;
+
+  // Returns the native code version of this expression, or nullptr if it couldn't be compiled.
+  // Compiled expressions never modify the emulated state, so they can be called directly to check
+  // whether the condition holds before doing the (logged) evaluation.
+  CompiledFunction GetCompiledFunction() const;
+
+  std::string GetText() const;
+
+private:
+  enum class SynchronizeDirection
+  {
+    From,
+    To,
+  };
+
   Expression(std::string_view text, ExprPointer ex, ExprVarListPointer vars);
 
   void SynchronizeBindings(Core::System& system, SynchronizeDirection dir) const;
@@ -72,6 +97,7 @@ private:
   ExprPointer m_expr;
   ExprVarListPointer m_vars;
   std::vector<VarBinding> m_binds;
+  CompiledExpressionPointer m_compiled;
 };
 
 inline bool EvaluateCondition(Core::System& system, const std::optional<Expression>& condition)
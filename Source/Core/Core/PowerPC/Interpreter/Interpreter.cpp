@@ -126,6 +126,11 @@ int Interpreter::SingleStepInner()
     return PPCTables::GetOpInfo(m_prev_inst, m_ppc_state.pc)->num_cycles;
   }
 
+  return ExecuteInstruction();
+}
+
+int Interpreter::ExecuteInstruction()
+{
   m_ppc_state.npc = m_ppc_state.pc + sizeof(UGeckoInstruction);
   m_prev_inst.hex = m_mmu.Read_Opcode(m_ppc_state.pc);
 
@@ -193,6 +198,15 @@ int Interpreter::SingleStepInner()
   return opinfo->num_cycles;
 }
 
+int Interpreter::RunBlock()
+{
+  m_end_block = false;
+  int cycles = 0;
+  while (!m_end_block)
+    cycles += SingleStepInner();
+  return cycles;
+}
+
 void Interpreter::SingleStep()
 {
   auto& core_timing = m_system.GetCoreTiming();
@@ -33,6 +33,11 @@ public:
   void Shutdown() override;
   void SingleStep() override;
   int SingleStepInner();
+  // Executes the instruction at pc without checking for function hooks, and returns the cycles it
+  // took.
+  int ExecuteInstruction();
+  // Executes instructions until the end of the current block and returns the cycles they took.
+  int RunBlock();
 
   void Run() override;
   void ClearCache() override;
@@ -3,7 +3,11 @@
 
 #include "Core/PowerPC/Jit64/Jit.h"
 
+#include <algorithm>
+#include <array>
+#include <chrono>
 #include <map>
+#include <numeric>
 #include <sstream>
 #include <string>
 
@@ -141,6 +145,9 @@ bool Jit64::HandleFault(uintptr_t access_address, SContext* ctx)
 
   if (memory.IsAddressInFastmemArea(reinterpret_cast<u8*>(access_address)))
   {
+    if (HandleCodeWriteFault(access_address))
+      return true;
+
     auto& ppc_state = m_system.GetPPCState();
     const uintptr_t memory_base = reinterpret_cast<uintptr_t>(
         ppc_state.msr.DR ? memory.GetLogicalBase() : memory.GetPhysicalBase());
@@ -246,9 +253,34 @@ bool Jit64::BackPatch(SContext* ctx)
 
   ctx->CTX_PC = reinterpret_cast<u64>(trampoline);
 
+  m_statistics.fastmem_backpatches++;
   return true;
 }
 
+static u64 GetFreeBytes(const HyoutaUtilities::RangeSizeSet<u8*>& free_ranges)
+{
+  u64 free_bytes = 0;
+  for (auto it = free_ranges.begin(); it != free_ranges.end(); ++it)
+    free_bytes += it.to() - it.from();
+  return free_bytes;
+}
+
+JitStatistics Jit64::GetStatistics()
+{
+  JitStatistics statistics = JitBase::GetStatistics();
+
+  statistics.near_code.size = region_size;
+  statistics.near_code.used = region_size - GetFreeBytes(m_free_ranges_near);
+  statistics.far_code.size = m_far_code.GetRegionSize();
+  statistics.far_code.used = m_far_code.GetRegionSize() - GetFreeBytes(m_free_ranges_far);
+  statistics.constant_pool.size = m_const_pool.GetSize();
+  statistics.constant_pool.used = m_const_pool.GetUsedSize();
+  statistics.trampolines.size = trampolines.GetRegionSize();
+  statistics.trampolines.used = trampolines.GetRegionSize() - trampolines.GetSpaceLeft();
+
+  return statistics;
+}
+
 void Jit64::Init()
 {
   InitFastmemArena();
@@ -295,10 +327,12 @@ void Jit64::Init()
   EnableOptimization();
 
   ResetFreeMemoryRanges();
+  RefreshDiskCache();
 }
 
 void Jit64::ClearCache()
 {
+  m_statistics.cache_clears++;
   blocks.Clear();
   blocks.ClearRangesToFree();
   trampolines.ClearCodeSpace();
@@ -309,6 +343,7 @@ void Jit64::ClearCache()
   RefreshConfig();
   asm_routines.Regenerate();
   ResetFreeMemoryRanges();
+  RefreshDiskCache();
 }
 
 void Jit64::ResetFreeMemoryRanges()
@@ -320,6 +355,88 @@ void Jit64::ResetFreeMemoryRanges()
   m_free_ranges_far.insert(m_far_code.GetWritableCodePtr(), m_far_code.GetWritableCodeEnd());
 }
 
+void Jit64::FreeRangesOfDestroyedBlocks()
+{
+  // Check if any code blocks have been freed in the block cache and transfer this information to
+  // the local rangesets to allow overwriting them with new code.
+  for (auto range : blocks.GetRangesToFreeNear())
+    m_free_ranges_near.insert(range.first, range.second);
+  for (auto range : blocks.GetRangesToFreeFar())
+    m_free_ranges_far.insert(range.first, range.second);
+  blocks.ClearRangesToFree();
+}
+
+void Jit64::EvictColdCodeSegment()
+{
+  // Blocks can't be moved, so free space can only be made by destroying blocks. Destroying all
+  // blocks overlapping one segment of each region leaves behind a contiguous free range in both.
+  // Jit() is only called from the dispatcher after it has reset the stack, so no return addresses
+  // into the destroyed blocks remain.
+  const size_t near_segment_size = region_size / CODE_SPACE_SEGMENTS;
+  const size_t far_segment_size = m_far_code.GetRegionSize() / CODE_SPACE_SEGMENTS;
+  const u8* far_region = m_far_code.GetRegion();
+
+  const auto overlaps_segment = [&](const JitBlock& block, u32 segment) {
+    const u8* near_segment_begin = region + near_segment_size * segment;
+    const u8* far_segment_begin = far_region + far_segment_size * segment;
+    return (block.near_begin != block.near_end &&
+            block.near_begin < near_segment_begin + near_segment_size &&
+            block.near_end > near_segment_begin) ||
+           (block.far_begin != block.far_end &&
+            block.far_begin < far_segment_begin + far_segment_size &&
+            block.far_end > far_segment_begin);
+  };
+
+  std::array<u64, CODE_SPACE_SEGMENTS> run_counts{};
+  blocks.RunOnBlocks([&](const JitBlock& block) {
+    const u64 run_count = GetBlockRunCount(block);
+    for (u32 segment = 0; segment < CODE_SPACE_SEGMENTS; segment++)
+    {
+      if (overlaps_segment(block, segment))
+        run_counts[segment] += run_count;
+    }
+  });
+
+  u32 evicted_segment = m_next_segment_to_evict;
+  for (u32 i = 1; i < CODE_SPACE_SEGMENTS; i++)
+  {
+    const u32 segment = (m_next_segment_to_evict + i) % CODE_SPACE_SEGMENTS;
+    if (run_counts[segment] < run_counts[evicted_segment])
+      evicted_segment = segment;
+  }
+  m_next_segment_to_evict = (evicted_segment + 1) % CODE_SPACE_SEGMENTS;
+
+  INFO_LOG_FMT(POWERPC, "Evicting code segment {} ({} block runs)", evicted_segment,
+               run_counts[evicted_segment]);
+  blocks.EraseBlocks(
+      [&](const JitBlock& block) { return overlaps_segment(block, evicted_segment); });
+  FreeRangesOfDestroyedBlocks();
+  m_statistics.code_space_evictions++;
+}
+
+u64 Jit64::GetBlockRunCount(const JitBlock& block) const
+{
+  // Blocks only count their runs if profiling or tiered compilation is enabled. Without either,
+  // all segments look equally cold and get evicted in turn.
+  u64 run_count = block.profile_data.runCount;
+
+  // Cold blocks count down to being recompiled as hot blocks. Hot blocks don't count their runs,
+  // as that would cost a load and a store on every run of the hottest code. Instead, their runs
+  // are estimated from how quickly their cold version counted down.
+  if (jo.tiered_compilation && IsHotBlock(block.effectiveAddress))
+  {
+    const u64 ticks = m_system.GetCoreTiming().GetTicks() - block.compile_ticks;
+    run_count += HOT_BLOCK_RUN_COUNT +
+                 HOT_BLOCK_RUN_COUNT * ticks / std::max<u64>(block.tier_up_ticks, 1);
+  }
+  else if (jo.tiered_compilation)
+  {
+    run_count += HOT_BLOCK_RUN_COUNT - block.hot_countdown;
+  }
+
+  return run_count;
+}
+
 void Jit64::Shutdown()
 {
   FreeCodeSpace();
@@ -330,6 +447,7 @@ void Jit64::Shutdown()
   blocks.Shutdown();
   m_far_code.Shutdown();
   m_const_pool.Shutdown();
+  m_disk_cache.Close();
 }
 
 void Jit64::FallBackToInterpreter(UGeckoInstruction inst)
@@ -405,6 +523,17 @@ void Jit64::DoNothing(UGeckoInstruction _inst)
   // Yup, just don't do anything.
 }
 
+void Jit64::RecordTierUp(Jit64& jit, u32 em_address)
+{
+  const JitBlock* block =
+      jit.blocks.GetBlockFromStartAddress(em_address, jit.m_ppc_state.feature_flags);
+  if (block)
+  {
+    jit.js.hotBlockTierUpTicks[em_address] =
+        jit.m_system.GetCoreTiming().GetTicks() - block->compile_ticks;
+  }
+}
+
 void Jit64::ImHere(Jit64& jit)
 {
   auto& ppc_state = jit.m_ppc_state;
@@ -541,6 +670,21 @@ void Jit64::WriteExit(u32 destination, bool bl, u32 after)
   if (!m_enable_blr_optimization)
     bl = false;
 
+  if (m_loop_entry && !bl && destination == js.blockStart)
+  {
+    // Keep looping within the block for as long as the timeslice lasts, without writing back and
+    // reloading the loop-carried registers. Only leave through the regular exit once it is over.
+    gpr.BindLoopCarriedRegisters();
+    Cleanup();
+    SUB(32, PPCSTATE(downcount), Imm32(js.downcountAmount));
+    J_CC(CC_G, m_loop_entry);
+
+    // Register stores leave the flags of the downcount check intact.
+    gpr.Flush();
+    JustWriteExit(destination, false, 0);
+    return;
+  }
+
   Cleanup();
 
   if (bl)
@@ -748,6 +892,16 @@ void Jit64::Jit(u32 em_address, bool clear_cache_and_retry_on_failure)
 {
   CleanUpAfterStackFault();
 
+  // Don't defer the retry after a cache clear, the block was already due to be compiled.
+  const bool defer_compilation =
+      m_enable_deferred_compilation && !m_enable_debugging && clear_cache_and_retry_on_failure;
+  // Blocks which had to be compiled in previous sessions are compiled right away, unless their
+  // guest code turns out to have changed, see below.
+  const bool prefetched =
+      defer_compilation && m_disk_cache.HasEntry(em_address, m_ppc_state.feature_flags);
+  if (defer_compilation && !prefetched && DeferCompilation(em_address))
+    return;
+
   if (trampolines.IsAlmostFull() || SConfig::GetInstance().bJITNoBlockCache)
   {
     if (!SConfig::GetInstance().bJITNoBlockCache)
@@ -757,13 +911,7 @@ void Jit64::Jit(u32 em_address, bool clear_cache_and_retry_on_failure)
     ClearCache();
   }
 
-  // Check if any code blocks have been freed in the block cache and transfer this information to
-  // the local rangesets to allow overwriting them with new code.
-  for (auto range : blocks.GetRangesToFreeNear())
-    m_free_ranges_near.insert(range.first, range.second);
-  for (auto range : blocks.GetRangesToFreeFar())
-    m_free_ranges_far.insert(range.first, range.second);
-  blocks.ClearRangesToFree();
+  FreeRangesOfDestroyedBlocks();
 
   std::size_t block_size = m_code_buffer.size();
 
@@ -786,11 +934,17 @@ void Jit64::Jit(u32 em_address, bool clear_cache_and_retry_on_failure)
         analyzer.ClearOption(PPCAnalyst::PPCAnalyzer::OPTION_CROR_MERGE);
         analyzer.ClearOption(PPCAnalyst::PPCAnalyzer::OPTION_CARRY_MERGE);
         analyzer.ClearOption(PPCAnalyst::PPCAnalyzer::OPTION_BRANCH_FOLLOW);
+        analyzer.ClearOption(PPCAnalyst::PPCAnalyzer::OPTION_LEAF_FUNCTION_INLINE);
       }
       Trace();
     }
   }
 
+  const bool is_hot_block = IsHotBlock(em_address);
+  SetAnalyzerTier(is_hot_block);
+
+  const auto analysis_start = std::chrono::steady_clock::now();
+
   // Analyze the block, collect all instructions it is made of (including inlining,
   // if that is enabled), reorder instructions for optimal performance, and join joinable
   // instructions.
@@ -807,40 +961,37 @@ void Jit64::Jit(u32 em_address, bool clear_cache_and_retry_on_failure)
     return;
   }
 
-  if (SetEmitterStateToFreeCodeRegion())
+  const bool use_disk_cache = m_disk_cache.IsOpen() && !is_hot_block;
+  u64 code_hash = 0;
+  if (use_disk_cache || prefetched)
+    code_hash = m_disk_cache.HashCodeBlock(code_block, m_code_buffer, m_ppc_state.feature_flags);
+  // The guest code of a prefetched block has changed since, so defer it like any other block.
+  if (prefetched && !m_disk_cache.TakeEntry(em_address, m_ppc_state.feature_flags, code_hash) &&
+      DeferCompilation(em_address))
   {
-    u8* near_start = GetWritableCodePtr();
-    u8* far_start = m_far_code.GetWritableCodePtr();
+    return;
+  }
 
-    JitBlock* b = blocks.AllocateBlock(em_address);
-    if (DoJit(em_address, b, nextPC))
-    {
-      // Code generation succeeded.
-
-      // Mark the memory regions that this code block uses as used in the local rangesets.
-      u8* near_end = GetWritableCodePtr();
-      if (near_start != near_end)
-        m_free_ranges_near.erase(near_start, near_end);
-      u8* far_end = m_far_code.GetWritableCodePtr();
-      if (far_start != far_end)
-        m_free_ranges_far.erase(far_start, far_end);
-
-      // Store the used memory regions in the block so we know what to mark as unused when the
-      // block gets invalidated.
-      b->near_begin = near_start;
-      b->near_end = near_end;
-      b->far_begin = far_start;
-      b->far_end = far_end;
-
-      blocks.FinalizeBlock(*b, jo.enableBlocklink, code_block.m_physical_addresses);
-      return;
-    }
+  bool compiled = CompileAnalyzedBlock(em_address, nextPC, analysis_start);
+  if (!compiled && clear_cache_and_retry_on_failure)
+  {
+    // Code generation failed due to not enough free space in either the near or far code regions.
+    // Evict the coldest part of the code regions and retry, so that only the blocks in it have to
+    // be recompiled.
+    EvictColdCodeSegment();
+    compiled = CompileAnalyzedBlock(em_address, nextPC, analysis_start);
+  }
+
+  if (compiled)
+  {
+    if (use_disk_cache)
+      m_disk_cache.RecordBlock(em_address, m_ppc_state.feature_flags, code_hash);
+    return;
   }
 
   if (clear_cache_and_retry_on_failure)
   {
-    // Code generation failed due to not enough free space in either the near or far code regions.
-    // Clear the entire JIT cache and retry.
+    // Evicting wasn't enough to make the block fit. Clear the entire JIT cache and retry.
     WARN_LOG_FMT(POWERPC, "flushing code caches, please report if this happens a lot");
     ClearCache();
     Jit(em_address, false);
@@ -853,6 +1004,59 @@ void Jit64::Jit(u32 em_address, bool clear_cache_and_retry_on_failure)
   std::exit(-1);
 }
 
+bool Jit64::CompileAnalyzedBlock(u32 em_address, u32 nextPC,
+                                 std::chrono::steady_clock::time_point analysis_start)
+{
+  if (!SetEmitterStateToFreeCodeRegion())
+    return false;
+
+  u8* near_start = GetWritableCodePtr();
+  u8* far_start = m_far_code.GetWritableCodePtr();
+
+  JitBlock* b = blocks.AllocateBlock(em_address);
+  if (!DoJit(em_address, b, nextPC))
+  {
+    blocks.DiscardBlock(*b);
+    return false;
+  }
+
+  // Code generation succeeded.
+
+  // Mark the memory regions that this code block uses as used in the local rangesets.
+  u8* near_end = GetWritableCodePtr();
+  if (near_start != near_end)
+    m_free_ranges_near.erase(near_start, near_end);
+  u8* far_end = m_far_code.GetWritableCodePtr();
+  if (far_start != far_end)
+    m_free_ranges_far.erase(far_start, far_end);
+
+  // Store the used memory regions in the block so we know what to mark as unused when the
+  // block gets invalidated.
+  b->near_begin = near_start;
+  b->near_end = near_end;
+  b->far_begin = far_start;
+  b->far_end = far_end;
+
+  blocks.FinalizeBlock(*b, jo.enableBlocklink, code_block.m_physical_addresses);
+  RecordCompiledBlock(*b, std::chrono::steady_clock::now() - analysis_start);
+  return true;
+}
+
+void Jit64::RefreshDiskCache()
+{
+  // Without deferred compilation, every block is compiled the first time it's reached anyway.
+  const bool use_disk_cache =
+      m_enable_block_disk_cache && m_enable_deferred_compilation && !m_enable_debugging;
+  m_disk_cache.SetGameID(use_disk_cache ? SConfig::GetInstance().GetGameID() : std::string());
+}
+
+void Jit64::OnConfigChanged()
+{
+  JitBase::OnConfigChanged();
+  // Loading a new title adds the config layers of its game INIs, so it ends up here too.
+  RefreshDiskCache();
+}
+
 bool Jit64::SetEmitterStateToFreeCodeRegion()
 {
   // Find the largest free memory blocks and set code emitters to point at them.
@@ -886,6 +1090,7 @@ bool Jit64::DoJit(u32 em_address, JitBlock* b, u32 nextPC)
   js.curBlock = b;
   js.numLoadStoreInst = 0;
   js.numFloatingPointInst = 0;
+  js.regCacheLookahead = IsHotBlock(em_address) ? HOT_BLOCK_REGCACHE_LOOKAHEAD : REGCACHE_LOOKAHEAD;
 
   // TODO: Test if this or AlignCode16 make a difference from GetCodePtr
   b->normalEntry = AlignCode4();
@@ -908,6 +1113,37 @@ bool Jit64::DoJit(u32 em_address, JitBlock* b, u32 nextPC)
     ADD(64, MDisp(ABI_PARAM1, offset), Imm8(1));
     ABI_CallFunction(QueryPerformanceCounter);
   }
+
+  if (jo.tiered_compilation)
+    b->compile_ticks = m_system.GetCoreTiming().GetTicks();
+
+  // Count down the runs of the block, and have it recompiled with the more expensive optimizations
+  // once it turns out to be hot.
+  if (jo.tiered_compilation && !IsHotBlock(em_address))
+  {
+    b->hot_countdown = HOT_BLOCK_RUN_COUNT;
+    MOV(64, R(RSCRATCH), ImmPtr(&b->hot_countdown));
+    SUB(32, MatR(RSCRATCH), Imm8(1));
+    FixupBranch hot = J_CC(CC_Z, Jump::Near);
+
+    SwitchToFarCode();
+    SetJumpTarget(hot);
+    MOV(32, PPCSTATE(pc), Imm32(js.blockStart));
+    ABI_PushRegistersAndAdjustStack({}, 0);
+    ABI_CallFunctionPC(RecordTierUp, this, js.blockStart);
+    ABI_CallFunctionPC(JitInterface::CompileExceptionCheckFromJIT, &m_system.GetJitInterface(),
+                       static_cast<u32>(JitInterface::ExceptionType::HotBlock));
+    ABI_PopRegistersAndAdjustStack({}, 0);
+    JMP(asm_routines.dispatcher_no_check, Jump::Near);
+    SwitchToNearCode();
+  }
+  else if (jo.tiered_compilation)
+  {
+    const auto it = js.hotBlockTierUpTicks.find(em_address);
+    if (it != js.hotBlockTierUpTicks.end())
+      b->tier_up_ticks = it->second;
+  }
+
 #if defined(_DEBUG) || defined(DEBUGFAST) || defined(NAN_CHECK)
   // should help logged stack-traces become more accurate
   MOV(32, PPCSTATE(pc), Imm32(js.blockStart));
@@ -961,6 +1197,8 @@ bool Jit64::DoJit(u32 em_address, JitBlock* b, u32 nextPC)
     IntializeSpeculativeConstants();
   }
 
+  SetUpLoopCarriedRegisters();
+
   // Translate instructions
   for (u32 i = 0; i < code_block.m_num_instructions; i++)
   {
@@ -1079,7 +1317,26 @@ bool Jit64::DoJit(u32 em_address, JitBlock* b, u32 nextPC)
 
         MOV(32, PPCSTATE(pc), Imm32(op.address));
         ABI_PushRegistersAndAdjustStack({}, 0);
+
+        // If the condition is available as native code, check it inline and only go through the
+        // breakpoint handling (which evaluates and logs it again) when it holds.
+        const TBreakPoint* bp = power_pc.GetBreakPoints().GetBreakpoint(op.address);
+        const Expression::CompiledFunction condition =
+            bp && bp->condition ? bp->condition->GetCompiledFunction() : nullptr;
+        FixupBranch condition_false;
+        if (condition)
+        {
+          ABI_CallFunctionP(condition, &m_ppc_state);
+          XORPD(XMM1, R(XMM1));
+          UCOMISD(XMM0, R(XMM1));
+          FixupBranch unordered = J_CC(CC_P);
+          condition_false = J_CC(CC_E, Jump::Near);
+          SetJumpTarget(unordered);
+        }
+
         ABI_CallFunctionP(PowerPC::CheckBreakPointsFromJIT, &power_pc);
+        if (condition)
+          SetJumpTarget(condition_false);
         ABI_PopRegistersAndAdjustStack({}, 0);
         MOV(64, R(RSCRATCH), ImmPtr(cpu.GetStatePtr()));
         TEST(32, MatR(RSCRATCH), Imm32(0xFFFFFFFF));
@@ -1162,7 +1419,7 @@ bool Jit64::DoJit(u32 em_address, JitBlock* b, u32 nextPC)
         gpr.Discard(op.gprDiscardable);
         fpr.Discard(op.fprDiscardable);
       }
-      gpr.Flush(~op.gprInUse & (op.regsIn | op.regsOut));
+      gpr.Flush(~op.gprInUse & (op.regsIn | op.regsOut) & ~gpr.GetLoopCarriedRegisters());
       fpr.Flush(~op.fprInUse & (op.fregsIn | op.GetFregsOut()));
 
       if (opinfo->flags & FL_LOADSTORE)
@@ -1190,6 +1447,8 @@ bool Jit64::DoJit(u32 em_address, JitBlock* b, u32 nextPC)
     WriteExit(nextPC);
   }
 
+  m_loop_entry = nullptr;
+
   if (HasWriteFailed() || m_far_code.HasWriteFailed())
   {
     if (HasWriteFailed())
@@ -1210,6 +1469,58 @@ bool Jit64::DoJit(u32 em_address, JitBlock* b, u32 nextPC)
   return true;
 }
 
+bool Jit64::DeferCompilation(u32 em_address)
+{
+  // Code that only runs a few times, e.g. while loading, is cheaper to interpret than to compile.
+  // Run blocks through the interpreter at first, and only compile those which keep getting run.
+  const auto it = js.interpretedBlockRuns.find(em_address);
+  if (it == js.interpretedBlockRuns.end())
+  {
+    // Most of the blocks that only ever run a few times never get compiled, so start over
+    // instead of letting their counts pile up.
+    if (js.interpretedBlockRuns.size() >= DEFERRED_COMPILATION_MAX_TRACKED_BLOCKS)
+      js.interpretedBlockRuns.clear();
+    js.interpretedBlockRuns.emplace(em_address, 1);
+  }
+  else if (it->second < DEFERRED_COMPILATION_INTERPRETER_RUNS)
+  {
+    it->second++;
+  }
+  else
+  {
+    js.interpretedBlockRuns.erase(it);
+    return false;
+  }
+
+  // The dispatcher does the timing check for the cycles used up by the interpreter.
+  m_ppc_state.downcount -= m_system.GetInterpreter().RunBlock();
+  m_system.GetJitInterface().UpdateMembase();
+  return true;
+}
+
+bool Jit64::IsHotBlock(u32 em_address) const
+{
+  return jo.tiered_compilation &&
+         js.hotBlockAddresses.find(em_address) != js.hotBlockAddresses.end();
+}
+
+void Jit64::SetAnalyzerTier(bool is_hot_block)
+{
+  // Hot blocks are allowed to follow (and thereby inline) more branches than regular blocks, and
+  // additionally continue on the taken path of conditional branches that are usually taken.
+  if (is_hot_block)
+  {
+    analyzer.SetBranchFollowingThreshold(HOT_BLOCK_BRANCH_FOLLOWING_THRESHOLD);
+    analyzer.SetBranchProfiles(&js.branchProfiles, HOT_BLOCK_TRACE_MIN_SAMPLES);
+  }
+  else
+  {
+    analyzer.SetBranchFollowingThreshold(
+        PPCAnalyst::PPCAnalyzer::DEFAULT_BRANCH_FOLLOWING_THRESHOLD);
+    analyzer.SetBranchProfiles(nullptr, 0);
+  }
+}
+
 BitSet8 Jit64::ComputeStaticGQRs(const PPCAnalyst::CodeBlock& cb) const
 {
   return cb.m_gqr_used & ~cb.m_gqr_modified;
@@ -1235,6 +1546,7 @@ void Jit64::EnableOptimization()
   analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_CROR_MERGE);
   analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_CARRY_MERGE);
   analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_BRANCH_FOLLOW);
+  analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_LEAF_FUNCTION_INLINE);
 }
 
 void Jit64::IntializeSpeculativeConstants()
@@ -1272,6 +1584,75 @@ void Jit64::IntializeSpeculativeConstants()
   }
 }
 
+void Jit64::SetUpLoopCarriedRegisters()
+{
+  m_loop_entry = nullptr;
+
+  if (!m_enable_loop_carried_registers || bJITRegisterCacheOff || jo.profile_blocks ||
+      m_enable_debugging)
+  {
+    return;
+  }
+
+  // With tiered compilation, leave this to hot blocks, which no longer count their runs on entry.
+  if (jo.tiered_compilation && !IsHotBlock(js.blockStart))
+    return;
+
+  bool loops = false;
+  std::array<u32, 32> reads{};
+  for (u32 i = 0; i < code_block.m_num_instructions; i++)
+  {
+    const PPCAnalyst::CodeOp& op = m_code_buffer[i];
+
+    // A block invalidating instructions could keep running stale code until the timeslice ends.
+    if (op.inst.OPCD == 31 && op.inst.SUBOP10 == 982)  // icbi
+      return;
+
+    loops |= IsLoopBackEdge(op);
+    for (int reg : op.regsIn)
+      reads[reg]++;
+  }
+  if (!loops)
+    return;
+
+  // Speculative constants are only checked when entering the block.
+  for (int reg : code_block.m_gpr_inputs)
+  {
+    if (gpr.IsImm(reg))
+      return;
+  }
+
+  std::array<preg_t, 32> order;
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&reads](preg_t a, preg_t b) { return reads[a] > reads[b]; });
+
+  BitSet32 carried;
+  for (size_t i = 0; i < MAX_LOOP_CARRIED_GPRS && reads[order[i]] != 0; i++)
+    carried[order[i]] = true;
+  if (!carried)
+    return;
+
+  gpr.SetLoopCarriedRegisters(carried);
+  m_loop_entry = GetCodePtr();
+}
+
+bool Jit64::IsLoopBackEdge(const PPCAnalyst::CodeOp& op) const
+{
+  // Only branches which are always compiled to a WriteExit to their target.
+  return (op.inst.OPCD == 16 || op.inst.OPCD == 18) && !op.inst.LK && !op.branchIsIdleLoop &&
+         !op.branchIsTraced && op.branchTo == js.blockStart;
+}
+
+void Jit64::FlushRegistersForBranch(const PPCAnalyst::CodeOp& op)
+{
+  if (m_loop_entry && IsLoopBackEdge(op))
+    gpr.Flush(~gpr.GetLoopCarriedRegisters());
+  else
+    gpr.Flush();
+  fpr.Flush();
+}
+
 bool Jit64::HandleFunctionHooking(u32 address)
 {
   const auto result = HLE::TryReplaceFunction(address, PowerPC::CoreMode::JIT);
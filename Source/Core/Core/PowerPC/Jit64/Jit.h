@@ -33,6 +33,7 @@
 #include "Core/PowerPC/Jit64Common/TrampolineCache.h"
 #include "Core/PowerPC/JitCommon/JitBase.h"
 #include "Core/PowerPC/JitCommon/JitCache.h"
+#include "Core/PowerPC/JitCommon/JitDiskCache.h"
 
 namespace PPCAnalyst
 {
@@ -56,14 +57,32 @@ public:
   bool HandleFault(uintptr_t access_address, SContext* ctx) override;
   bool BackPatch(SContext* ctx);
 
+  JitStatistics GetStatistics() override;
+
   void EnableOptimization();
   void EnableBlockLink();
 
+  // Number of runs through the interpreter before a block gets compiled, when deferred compilation
+  // is enabled.
+  static constexpr u32 DEFERRED_COMPILATION_INTERPRETER_RUNS = 2;
+  // Number of blocks whose runs through the interpreter are counted at most.
+  static constexpr u32 DEFERRED_COMPILATION_MAX_TRACKED_BLOCKS = 0x10000;
+
   // Jit!
 
   void Jit(u32 em_address) override;
   void Jit(u32 em_address, bool clear_cache_and_retry_on_failure);
   bool DoJit(u32 em_address, JitBlock* b, u32 nextPC);
+  bool IsHotBlock(u32 em_address) const;
+  void SetAnalyzerTier(bool is_hot_block);
+  // Deferred compilation: runs the block at em_address through the interpreter on the CPU thread
+  // instead of compiling it, until it has been reached DEFERRED_COMPILATION_INTERPRETER_RUNS times.
+  // The block is then compiled synchronously as usual. Returns whether the block was interpreted.
+  bool DeferCompilation(u32 em_address);
+  // Generates code for the block currently held in code_block and adds it to the block cache.
+  // Returns false if there wasn't enough free space in the code regions.
+  bool CompileAnalyzedBlock(u32 em_address, u32 nextPC,
+                            std::chrono::steady_clock::time_point analysis_start);
 
   // Finds a free memory region and sets the near and far code emitters to point at that region.
   // Returns false if no free memory region can be found for either of the two.
@@ -73,6 +92,10 @@ public:
   BitSet8 ComputeStaticGQRs(const PPCAnalyst::CodeBlock&) const;
 
   void IntializeSpeculativeConstants();
+  // If the block loops back to its own start, keeps its most read GPRs in host registers across
+  // iterations, and sets m_loop_entry to where the back edge jumps to.
+  void SetUpLoopCarriedRegisters();
+  bool IsLoopBackEdge(const PPCAnalyst::CodeOp& op) const;
 
   JitBlockCache* GetBlockCache() override { return &blocks; }
   void Trace();
@@ -99,6 +122,9 @@ public:
   void WriteRfiExitDestInRSCRATCH();
   void WriteIdleExit(u32 destination);
   bool Cleanup();
+  // Flushes the register caches before taking the branch in op. If the branch loops back to the
+  // start of the block, the loop-carried registers are left in their host registers.
+  void FlushRegistersForBranch(const PPCAnalyst::CodeOp& op);
 
   void GenerateConstantOverflow(bool overflow);
   void GenerateConstantOverflow(s64 val);
@@ -111,6 +137,11 @@ public:
   void AndWithMask(Gen::X64Reg reg, u32 mask);
   void RotateLeft(int bits, Gen::X64Reg regOp, const Gen::OpArg& arg, u8 rotate);
 
+  // Whether to count which way the given branch goes, so that hot blocks can be traced along the
+  // taken path of the usually taken ones.
+  bool IsProfiledBranch(UGeckoInstruction inst) const;
+  void ProfileConditionalBranch(u32 address, bool taken);
+
   bool CheckMergedBranch(u32 crf) const;
   void DoMergedBranch();
   void DoMergedBranchCondition();
@@ -256,12 +287,48 @@ public:
   void eieio(UGeckoInstruction inst);
 
 private:
+  // Number of runs after which a block gets recompiled with the optimizations for hot code.
+  static constexpr u32 HOT_BLOCK_RUN_COUNT = 10000;
+  // Number of unconditional branches that are followed when compiling a hot block.
+  static constexpr u32 HOT_BLOCK_BRANCH_FOLLOWING_THRESHOLD = 8;
+  // Number of times a conditional branch must have been executed, being taken at least as often as
+  // not, for a hot block to continue on its taken path, turning the fall-through path into a side
+  // exit.
+  static constexpr u32 HOT_BLOCK_TRACE_MIN_SAMPLES = HOT_BLOCK_RUN_COUNT / 10;
+  // Number of instructions the register caches look ahead when picking a register to spill.
+  static constexpr int REGCACHE_LOOKAHEAD = 64;
+  static constexpr int HOT_BLOCK_REGCACHE_LOOKAHEAD = 256;
+  // Number of GPRs kept in host registers across iterations of a block looping back to its own
+  // start. Matches the number of host registers GPRRegCache sets aside for them.
+  static constexpr size_t MAX_LOOP_CARRIED_GPRS = 3;
+  // Number of equally sized segments the near and far code regions are divided into. When a block
+  // doesn't fit, the blocks of one segment get evicted instead of clearing the whole cache.
+  static constexpr u32 CODE_SPACE_SEGMENTS = 8;
+
   void CompileInstruction(PPCAnalyst::CodeOp& op);
 
   bool HandleFunctionHooking(u32 address);
 
   void ResetFreeMemoryRanges();
+  // Makes the code space of blocks destroyed since the last call available for new blocks.
+  void FreeRangesOfDestroyedBlocks();
+  // Destroys the blocks using the least run segment of the near and far code regions.
+  void EvictColdCodeSegment();
+  u64 GetBlockRunCount(const JitBlock& block) const;
+
+  // Whether a paired load or store may be specialized for the current value of a GQR it can't
+  // assume to be constant, with a fallback to the generic routines for other values.
+  bool CanSpeculateOnGQR(u32 type) const;
+  // Called after emitting both paths of such a specialized paired load or store.
+  void EndGQRSpeculation();
 
+  // Opens the disk cache of the running title, or closes it if it isn't used.
+  void RefreshDiskCache();
+
+  void OnConfigChanged() override;
+
+  // Called when a cold block has counted down its runs, before it gets recompiled as a hot block.
+  static void RecordTierUp(Jit64& jit, u32 em_address);
   static void ImHere(Jit64& jit);
 
   JitBlockCache blocks{*this};
@@ -275,6 +342,16 @@ private:
   HyoutaUtilities::RangeSizeSet<u8*> m_free_ranges_near;
   HyoutaUtilities::RangeSizeSet<u8*> m_free_ranges_far;
 
+  JitDiskCache m_disk_cache;
+
+  // Where the search for the coldest code segment starts, so that segments which are all equally
+  // cold get evicted in turn.
+  u32 m_next_segment_to_evict = 0;
+
+  // Where a back edge to the start of the block currently being compiled jumps to, past the block
+  // entry checks and with the loop-carried registers loaded. nullptr if the block doesn't loop.
+  const u8* m_loop_entry = nullptr;
+
   const bool m_im_here_debug = false;
   const bool m_im_here_log = false;
   std::map<u32, int> m_been_here;
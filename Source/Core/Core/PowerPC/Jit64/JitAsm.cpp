@@ -221,7 +221,11 @@ void Jit64AsmRoutineManager::Generate()
   ABI_CallFunction(JitTrampoline);
   ABI_PopRegistersAndAdjustStack({}, 0);
 
-  JMP(dispatcher_no_check, Jump::Near);
+  // Instead of compiling it, Jit might have run the block through the interpreter, which uses up
+  // cycles and might change the MSR.
+  MOV(64, R(RMEM), PPCSTATE(mem_ptr));
+  CMP(32, PPCSTATE(downcount), Imm8(0));
+  JMP(dispatcher, Jump::Near);
 
   SetJumpTarget(bail);
   do_timing = GetCodePtr();
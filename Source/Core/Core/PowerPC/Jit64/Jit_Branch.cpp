@@ -91,8 +91,7 @@ void Jit64::bx(UGeckoInstruction inst)
     return;
   }
 
-  gpr.Flush();
-  fpr.Flush();
+  FlushRegistersForBranch(*js.op);
 
 #ifdef ACID_TEST
   if (inst.LK)
@@ -108,6 +107,21 @@ void Jit64::bx(UGeckoInstruction inst)
   }
 }
 
+bool Jit64::IsProfiledBranch(UGeckoInstruction inst) const
+{
+  // Only plain conditional bcx can be traced, see PPCAnalyzer::IsFrequentlyTakenBranch.
+  return jo.tiered_compilation && inst.OPCD == 16 && !inst.LK &&
+         ((inst.BO & BO_DONT_CHECK_CONDITION) == 0 || (inst.BO & BO_DONT_DECREMENT_FLAG) == 0) &&
+         !IsHotBlock(js.blockStart);
+}
+
+void Jit64::ProfileConditionalBranch(u32 address, bool taken)
+{
+  PPCAnalyst::BranchProfile& profile = js.branchProfiles[address];
+  MOV(64, R(RSCRATCH), ImmPtr(taken ? &profile.taken : &profile.not_taken));
+  ADD(32, MatR(RSCRATCH), Imm8(1));
+}
+
 // TODO - optimize to hell and beyond
 // TODO - make nice easy to optimize special cases for the most common
 // variants of this instruction.
@@ -118,6 +132,8 @@ void Jit64::bcx(UGeckoInstruction inst)
 
   // USES_CR
 
+  const bool profile_branch = IsProfiledBranch(inst);
+
   FixupBranch pCTRDontBranch;
   if ((inst.BO & BO_DONT_DECREMENT_FLAG) == 0)  // Decrement and test CTR
   {
@@ -138,6 +154,26 @@ void Jit64::bcx(UGeckoInstruction inst)
   if (inst.LK)
     MOV(32, PPCSTATE_LR, Imm32(js.compilerPC + 4));
 
+  if (js.op->branchIsTraced)
+  {
+    // The analyzer continued the block on the taken path, so leave through a side exit to the
+    // fall-through path instead.
+    SwitchToFarCode();
+    if ((inst.BO & BO_DONT_CHECK_CONDITION) == 0)
+      SetJumpTarget(pConditionDontBranch);
+    if ((inst.BO & BO_DONT_DECREMENT_FLAG) == 0)
+      SetJumpTarget(pCTRDontBranch);
+    {
+      RCForkGuard gpr_guard = gpr.Fork();
+      RCForkGuard fpr_guard = fpr.Fork();
+      gpr.Flush();
+      fpr.Flush();
+      WriteExit(js.compilerPC + 4);
+    }
+    SwitchToNearCode();
+    return;
+  }
+
   // If this is not the last instruction of a block
   // and an unconditional branch, we will skip the rest process.
   // Because PPCAnalyst::Flatten() merged the blocks.
@@ -157,8 +193,7 @@ void Jit64::bcx(UGeckoInstruction inst)
   {
     RCForkGuard gpr_guard = gpr.Fork();
     RCForkGuard fpr_guard = fpr.Fork();
-    gpr.Flush();
-    fpr.Flush();
+    FlushRegistersForBranch(*js.op);
 
     if (js.op->branchIsIdleLoop)
     {
@@ -166,6 +201,8 @@ void Jit64::bcx(UGeckoInstruction inst)
     }
     else
     {
+      if (profile_branch)
+        ProfileConditionalBranch(js.compilerPC, true);
       WriteExit(js.op->branchTo, inst.LK, js.compilerPC + 4);
     }
   }
@@ -175,6 +212,9 @@ void Jit64::bcx(UGeckoInstruction inst)
   if ((inst.BO & BO_DONT_DECREMENT_FLAG) == 0)
     SetJumpTarget(pCTRDontBranch);
 
+  if (profile_branch)
+    ProfileConditionalBranch(js.compilerPC, false);
+
   if (!analyzer.HasOption(PPCAnalyst::PPCAnalyzer::OPTION_CONDITIONAL_CONTINUE))
   {
     gpr.Flush();
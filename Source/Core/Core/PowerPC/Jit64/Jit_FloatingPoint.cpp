@@ -62,6 +62,17 @@ void Jit64::FinalizeSingleResult(X64Reg output, const OpArg& input, bool packed,
       SetFPRFIfNeeded(R(output), true);
       CVTPS2PD(output, R(output));
     }
+    else if (cpu_info.bAVX)
+    {
+      // If the upper half gets overwritten anyway, take the untouched upper bits from the input
+      // rather than from the old value of output, so that we don't depend on the latter.
+      const X64Reg upper_bits = duplicate && input.IsSimpleReg() ? input.GetSimpleReg() : output;
+      VCVTSD2SS(output, upper_bits, input);
+      SetFPRFIfNeeded(R(output), true);
+      VCVTSS2SD(output, output, R(output));
+      if (duplicate)
+        MOVDDUP(output, R(output));
+    }
     else
     {
       CVTSD2SS(output, input);
@@ -393,6 +404,7 @@ void Jit64::fmaddXX(UGeckoInstruction inst)
 
   X64Reg scratch_xmm = XMM0;
   X64Reg result_xmm = XMM1;
+  bool multiplied = false;
   if (software_fma)
   {
     for (size_t i = (packed ? 1 : 0); i != std::numeric_limits<size_t>::max(); --i)
@@ -472,12 +484,21 @@ void Jit64::fmaddXX(UGeckoInstruction inst)
       if (round_input)
         Force25BitPrecision(result_xmm, R(result_xmm), scratch_xmm);
     }
+    else if (round_input)
+    {
+      Force25BitPrecision(result_xmm, Rc, scratch_xmm);
+    }
+    else if (!use_fma)
+    {
+      // Without FMA, the multiplication can take Rc as its source directly, which with AVX saves
+      // us from copying it first.
+      avx_op(packed ? &XEmitter::VMULPD : &XEmitter::VMULSD,
+             packed ? &XEmitter::MULPD : &XEmitter::MULSD, result_xmm, Rc, Ra, packed, true);
+      multiplied = true;
+    }
     else
     {
-      if (round_input)
-        Force25BitPrecision(result_xmm, Rc, scratch_xmm);
-      else
-        MOVAPD(result_xmm, Rc);
+      MOVAPD(result_xmm, Rc);
     }
 
     if (use_fma)
@@ -501,7 +522,8 @@ void Jit64::fmaddXX(UGeckoInstruction inst)
     {
       if (packed)
       {
-        MULPD(result_xmm, Ra);
+        if (!multiplied)
+          MULPD(result_xmm, Ra);
         if (subtract)
           SUBPD(result_xmm, Rb);
         else
@@ -509,7 +531,8 @@ void Jit64::fmaddXX(UGeckoInstruction inst)
       }
       else
       {
-        MULSD(result_xmm, Ra);
+        if (!multiplied)
+          MULSD(result_xmm, Ra);
         if (subtract)
           SUBSD(result_xmm, Rb);
         else
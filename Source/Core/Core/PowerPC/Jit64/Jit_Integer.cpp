@@ -375,6 +375,10 @@ bool Jit64::CheckMergedBranch(u32 crf) const
   if (!CanMergeNextInstructions(1))
     return false;
 
+  // Traced branches continue on their taken path, which the merged branch code doesn't handle.
+  if (js.op[1].branchIsTraced)
+    return false;
+
   const UGeckoInstruction& next = js.op[1].inst;
   return (((next.OPCD == 16 /* bcx */) ||
            ((next.OPCD == 19) && (next.SUBOP10 == 528) /* bcctrx */) ||
@@ -406,6 +410,10 @@ void Jit64::DoMergedBranch()
       destination = SignExt16(next.BD << 2);
     else
       destination = nextPC + SignExt16(next.BD << 2);
+
+    // Count which way the branch goes, like in bcx.
+    if (IsProfiledBranch(next))
+      ProfileConditionalBranch(nextPC, true);
     WriteExit(destination, next.LK, nextPC + 4);
   }
   else if ((next.OPCD == 19) && (next.SUBOP10 == 528))  // bcctrx
@@ -468,14 +476,16 @@ void Jit64::DoMergedBranchCondition()
     RCForkGuard gpr_guard = gpr.Fork();
     RCForkGuard fpr_guard = fpr.Fork();
 
-    gpr.Flush();
-    fpr.Flush();
+    FlushRegistersForBranch(js.op[1]);
 
     DoMergedBranch();
   }
 
   SetJumpTarget(pDontBranch);
 
+  if (IsProfiledBranch(next))
+    ProfileConditionalBranch(nextPC, false);
+
   if (!analyzer.HasOption(PPCAnalyst::PPCAnalyzer::OPTION_CONDITIONAL_CONTINUE))
   {
     gpr.Flush();
@@ -507,11 +517,15 @@ void Jit64::DoMergedBranchImmediate(s64 val)
 
   if (branch)
   {
-    gpr.Flush();
-    fpr.Flush();
+    FlushRegistersForBranch(js.op[1]);
     DoMergedBranch();
+    return;
   }
-  else if (!analyzer.HasOption(PPCAnalyst::PPCAnalyzer::OPTION_CONDITIONAL_CONTINUE))
+
+  if (IsProfiledBranch(next))
+    ProfileConditionalBranch(nextPC, false);
+
+  if (!analyzer.HasOption(PPCAnalyst::PPCAnalyzer::OPTION_CONDITIONAL_CONTINUE))
   {
     gpr.Flush();
     fpr.Flush();
@@ -15,6 +15,29 @@
 
 using namespace Gen;
 
+// GQRs with an undefined type aren't worth specializing for.
+static bool IsDefinedQuantizeType(u32 type)
+{
+  return type != QUANTIZE_INVALID1 && type != QUANTIZE_INVALID2 && type != QUANTIZE_INVALID3;
+}
+
+bool Jit64::CanSpeculateOnGQR(u32 type) const
+{
+  // In memcheck mode, the exception check after the instruction has to cover both the specialized
+  // and the generic code. Without fastmem, the specialized code checks for exceptions on its own,
+  // which would leave the generic code unchecked.
+  return IsDefinedQuantizeType(type) && (!jo.memcheck || jo.fastmem);
+}
+
+void Jit64::EndGQRSpeculation()
+{
+  // The generic routines raise a DSI through C++ rather than through a fastmem fault, so DoJit has
+  // to emit its exception check after the instruction. Fastmem faults in the specialized code then
+  // go through a trampoline without an exception handler, and get caught by that check too.
+  if (jo.memcheck)
+    js.fastmemLoadStore = nullptr;
+}
+
 // The big problem is likely instructions that set the quantizers in the same block.
 // We will have to break block after quantizers are written to.
 void Jit64::psq_stXX(UGeckoInstruction inst)
@@ -52,10 +75,7 @@ void Jit64::psq_stXX(UGeckoInstruction inst)
   else
     CVTPD2PS(XMM0, Rs);  // pair
 
-  const bool gqrIsConstant = js.constantGqrValid[i];
-  if (gqrIsConstant)
-  {
-    const u32 gqrValue = js.constantGqr[i] & 0xffff;
+  const auto store_known_gqr = [&](u32 gqrValue) {
     int type = gqrValue & 0x7;
 
     // Paired stores (other than w/type zero) don't yield any real change in
@@ -80,9 +100,9 @@ void Jit64::psq_stXX(UGeckoInstruction inst)
       else
         CALL(asm_routines.paired_store_quantized[type]);
     }
-  }
-  else
-  {
+  };
+
+  const auto store_unknown_gqr = [&] {
     // Stash PC in case asm routine needs to call into C++
     MOV(32, PPCSTATE(pc), Imm32(js.compilerPC));
     // Some games (e.g. Dirt 2) incorrectly set the unused bits which breaks the lookup table code.
@@ -98,6 +118,32 @@ void Jit64::psq_stXX(UGeckoInstruction inst)
     OR(8, R(RSCRATCH), R(RSCRATCH2));
     SHL(8, R(RSCRATCH), Imm8(3));
     CALLptr(MatR(RSCRATCH));
+  };
+
+  const bool gqrIsConstant = js.constantGqrValid[i];
+  const u32 observedGqrValue = GQR(m_ppc_state, i) & 0xffff;
+  if (gqrIsConstant)
+  {
+    store_known_gqr(js.constantGqr[i] & 0xffff);
+  }
+  else if (CanSpeculateOnGQR(observedGqrValue & 0x7))
+  {
+    // The GQR can't be assumed constant for the whole block, but it most likely still has the
+    // value it has right now. Specialize for that, and only use the generic routines if it changed.
+    CMP(16, PPCSTATE_SPR(SPR_GQR0 + i), Imm16(static_cast<u16>(observedGqrValue)));
+    FixupBranch gqr_changed = J_CC(CC_NE, Jump::Near);
+    SwitchToFarCode();
+    SetJumpTarget(gqr_changed);
+    store_unknown_gqr();
+    FixupBranch done = J(Jump::Near);
+    SwitchToNearCode();
+    store_known_gqr(observedGqrValue);
+    SetJumpTarget(done);
+    EndGQRSpeculation();
+  }
+  else
+  {
+    store_unknown_gqr();
   }
 
   if (update && jo.memcheck)
@@ -136,19 +182,17 @@ void Jit64::psq_lXX(UGeckoInstruction inst)
   if (update && !jo.memcheck)
     MOV(32, Ra, R(RSCRATCH_EXTRA));
 
-  const bool gqrIsConstant = js.constantGqrValid[i];
-  if (gqrIsConstant)
-  {
-    const u32 gqrValue = js.constantGqr[i] >> 16;
+  // Get the high part of the GQR register
+  OpArg gqr = PPCSTATE_SPR(SPR_GQR0 + i);
+  gqr.AddMemOffset(2);
+
+  const auto load_known_gqr = [&](u32 gqrValue) {
     GenQuantizedLoad(w == 1, static_cast<EQuantizeType>(gqrValue & 0x7), (gqrValue & 0x3F00) >> 8);
-  }
-  else
-  {
+  };
+
+  const auto load_unknown_gqr = [&] {
     // Stash PC in case asm routine needs to call into C++
     MOV(32, PPCSTATE(pc), Imm32(js.compilerPC));
-    // Get the high part of the GQR register
-    OpArg gqr = PPCSTATE_SPR(SPR_GQR0 + i);
-    gqr.AddMemOffset(2);
     MOV(32, R(RSCRATCH2), Imm32(0x3F07));
     AND(32, R(RSCRATCH2), gqr);
     LEA(64, RSCRATCH,
@@ -158,6 +202,31 @@ void Jit64::psq_lXX(UGeckoInstruction inst)
     OR(8, R(RSCRATCH), R(RSCRATCH2));
     SHL(8, R(RSCRATCH), Imm8(3));
     CALLptr(MatR(RSCRATCH));
+  };
+
+  const bool gqrIsConstant = js.constantGqrValid[i];
+  const u32 observedGqrValue = GQR(m_ppc_state, i) >> 16;
+  if (gqrIsConstant)
+  {
+    load_known_gqr(js.constantGqr[i] >> 16);
+  }
+  else if (CanSpeculateOnGQR(observedGqrValue & 0x7))
+  {
+    // Like for stores, speculate that the GQR still has its current value.
+    CMP(16, gqr, Imm16(static_cast<u16>(observedGqrValue)));
+    FixupBranch gqr_changed = J_CC(CC_NE, Jump::Near);
+    SwitchToFarCode();
+    SetJumpTarget(gqr_changed);
+    load_unknown_gqr();
+    FixupBranch done = J(Jump::Near);
+    SwitchToNearCode();
+    load_known_gqr(observedGqrValue);
+    SetJumpTarget(done);
+    EndGQRSpeculation();
+  }
+  else
+  {
+    load_unknown_gqr();
   }
 
   CVTPS2PD(Rs, R(XMM0));
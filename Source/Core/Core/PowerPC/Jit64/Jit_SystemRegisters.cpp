@@ -300,6 +300,15 @@ void Jit64::mtspr(UGeckoInstruction inst)
   RCOpArg Rd = gpr.BindOrImm(d, RCMode::Read);
   RegCache::Realize(Rd);
   MOV(32, PPCSTATE_SPR(iIndex), Rd);
+
+  // Paired loads and stores later in the block can be specialized for a GQR set to a constant.
+  if (iIndex >= SPR_GQR0 && iIndex < SPR_GQR0 + 8)
+  {
+    const u32 gqr = iIndex - SPR_GQR0;
+    js.constantGqrValid[gqr] = Rd.IsImm();
+    if (Rd.IsImm())
+      js.constantGqr[gqr] = Rd.Imm32();
+  }
 }
 
 void Jit64::mfspr(UGeckoInstruction inst)
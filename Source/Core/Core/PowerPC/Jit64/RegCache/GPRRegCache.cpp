@@ -47,6 +47,14 @@ const X64Reg* GPRRegCache::GetAllocationOrder(size_t* count) const
   return allocation_order;
 }
 
+const X64Reg* GPRRegCache::GetLoopCarriedAllocationOrder(size_t* count) const
+{
+  // Callee-saved on both ABIs, so they survive calls, and never used as fixed scratch registers.
+  static const X64Reg allocation_order[] = {R13, R14, R15};
+  *count = sizeof(allocation_order) / sizeof(X64Reg);
+  return allocation_order;
+}
+
 void GPRRegCache::SetImmediate32(preg_t preg, u32 imm_value, bool dirty)
 {
   // "dirty" can be false to avoid redundantly flushing an immediate when
@@ -295,6 +295,8 @@ RegCache::RegCache(Jit64& jit) : m_jit{jit}
 void RegCache::Start()
 {
   m_xregs.fill({});
+  m_loop_carried = BitSet32{};
+  m_reserved_xregs = BitSet32{};
   for (size_t i = 0; i < m_regs.size(); i++)
   {
     m_regs[i] = PPCCachedReg{GetDefaultLocation(i)};
@@ -487,6 +489,43 @@ void RegCache::PreloadRegisters(BitSet32 to_preload)
   }
 }
 
+void RegCache::SetLoopCarriedRegisters(BitSet32 pregs)
+{
+  size_t count;
+  const X64Reg* order = GetLoopCarriedAllocationOrder(&count);
+
+  size_t i = 0;
+  for (preg_t preg : pregs)
+  {
+    if (i == count)
+      break;
+
+    const X64Reg xr = order[i++];
+    FlushX(xr);
+    StoreFromRegister(preg);
+    m_loop_carried[preg] = true;
+    m_loop_carried_xregs[preg] = xr;
+    m_reserved_xregs[xr] = true;
+  }
+
+  // Whether a register gets written or not may differ between iterations, so treat them all as
+  // dirty.
+  for (preg_t preg : m_loop_carried)
+    BindToRegister(preg, true, true);
+}
+
+void RegCache::BindLoopCarriedRegisters()
+{
+  for (preg_t i = 0; i < m_regs.size(); i++)
+  {
+    ASSERT_MSG(DYNA_REC, m_loop_carried[i] || !m_regs[i].IsAway(),
+               "PPC reg {} left unflushed when looping back", i);
+  }
+
+  for (preg_t preg : m_loop_carried)
+    BindToRegister(preg, true, true);
+}
+
 BitSet32 RegCache::RegistersInUse() const
 {
   BitSet32 result;
@@ -523,7 +562,7 @@ void RegCache::BindToRegister(preg_t i, bool doLoad, bool makeDirty)
 {
   if (!m_regs[i].IsBound())
   {
-    X64Reg xr = GetFreeXReg();
+    X64Reg xr = m_loop_carried[i] ? m_loop_carried_xregs[i] : GetFreeXReg();
 
     ASSERT_MSG(DYNA_REC, !m_xregs[xr].IsDirty(), "Xreg {} already dirty", Common::ToUnderlying(xr));
     ASSERT_MSG(DYNA_REC, !m_xregs[xr].IsLocked(), "GetFreeXReg returned locked register");
@@ -590,6 +629,12 @@ void RegCache::StoreFromRegister(preg_t i, FlushMode mode)
     m_regs[i].SetFlushed();
 }
 
+const X64Reg* RegCache::GetLoopCarriedAllocationOrder(size_t* count) const
+{
+  *count = 0;
+  return nullptr;
+}
+
 X64Reg RegCache::GetFreeXReg()
 {
   size_t aCount;
@@ -597,7 +642,7 @@ X64Reg RegCache::GetFreeXReg()
   for (size_t i = 0; i < aCount; i++)
   {
     X64Reg xr = aOrder[i];
-    if (m_xregs[xr].IsFree())
+    if (m_xregs[xr].IsFree() && !m_reserved_xregs[xr])
     {
       return xr;
     }
@@ -611,6 +656,8 @@ X64Reg RegCache::GetFreeXReg()
   for (size_t i = 0; i < aCount; i++)
   {
     X64Reg xreg = (X64Reg)aOrder[i];
+    if (m_reserved_xregs[xreg])
+      continue;
     preg_t preg = m_xregs[xreg].Contents();
     if (m_xregs[xreg].IsLocked() || m_regs[preg].IsLocked())
       continue;
@@ -640,7 +687,7 @@ int RegCache::NumFreeRegisters() const
   size_t aCount;
   const X64Reg* aOrder = GetAllocationOrder(&aCount);
   for (size_t i = 0; i < aCount; i++)
-    if (m_xregs[aOrder[i]].IsFree())
+    if (m_xregs[aOrder[i]].IsFree() && !m_reserved_xregs[aOrder[i]])
       count++;
   return count;
 }
@@ -664,9 +711,9 @@ float RegCache::ScoreRegister(X64Reg xreg) const
   if (GetRegUtilization()[preg])
   {
     // Don't look too far ahead; we don't want to have quadratic compilation times for
-    // enormous block sizes!
+    // enormous block sizes! Hot blocks can afford to look further.
     // This actually improves register allocation a tiny bit; I'm not sure why.
-    u32 lookahead = std::min(m_jit.js.instructionsLeft, 64);
+    u32 lookahead = std::min(m_jit.js.instructionsLeft, m_jit.js.regCacheLookahead);
     // Count how many other registers are going to be used before we need this one again.
     u32 regs_in_count = CountRegsIn(preg, lookahead).Count();
     // Totally ad-hoc heuristic to bias based on how many other registers we'll need
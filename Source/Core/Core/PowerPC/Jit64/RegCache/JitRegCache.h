@@ -178,6 +178,15 @@ public:
   void PreloadRegisters(BitSet32 pregs);
   BitSet32 RegistersInUse() const;
 
+  // Gives the given registers host registers of their own for the rest of the block and loads
+  // them, so that they can be carried over when the block loops back to its start. Registers
+  // beyond the number of available host registers are ignored.
+  void SetLoopCarriedRegisters(BitSet32 pregs);
+  BitSet32 GetLoopCarriedRegisters() const { return m_loop_carried; }
+  // Puts the loop-carried registers back into their host registers. All other registers must have
+  // been flushed.
+  void BindLoopCarriedRegisters();
+
 protected:
   friend class RCOpArg;
   friend class RCX64Reg;
@@ -188,6 +197,9 @@ protected:
   virtual void LoadRegister(preg_t preg, Gen::X64Reg new_loc) = 0;
 
   virtual const Gen::X64Reg* GetAllocationOrder(size_t* count) const = 0;
+  // Host registers which may be dedicated to loop-carried registers. They must be callee-saved
+  // and never be requested by Scratch(xr).
+  virtual const Gen::X64Reg* GetLoopCarriedAllocationOrder(size_t* count) const;
 
   virtual BitSet32 GetRegUtilization() const = 0;
   virtual BitSet32 CountRegsIn(preg_t preg, u32 lookahead) const = 0;
@@ -218,5 +230,8 @@ protected:
   std::array<PPCCachedReg, 32> m_regs;
   std::array<X64CachedReg, NUM_XREGS> m_xregs;
   std::array<RCConstraint, 32> m_constraints;
+  BitSet32 m_loop_carried;
+  std::array<Gen::X64Reg, 32> m_loop_carried_xregs{};
+  BitSet32 m_reserved_xregs;
   Gen::XEmitter* m_emitter = nullptr;
 };
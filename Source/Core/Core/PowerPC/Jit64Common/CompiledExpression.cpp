@@ -0,0 +1,362 @@
+// Copyright 2026 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "Core/PowerPC/Jit64Common/CompiledExpression.h"
+
+#include <cmath>
+#include <cstddef>
+
+#include <expr.h>
+
+#include "Common/BitUtils.h"
+#include "Common/JitRegister.h"
+#include "Common/x64ABI.h"
+#include "Core/PowerPC/PowerPC.h"
+
+using namespace Gen;
+
+// Holds the PowerPCState pointer passed in by the caller. It's callee-saved, so calls to helper
+// functions don't clobber it.
+static const X64Reg ppc_state_reg = RBX;
+
+// The operators whose semantics depend on expr's conversion to integers are left to C++.
+static double Power(double a, double b)
+{
+  return std::pow(a, b);
+}
+
+static double Remainder(double a, double b)
+{
+  return std::fmod(a, b);
+}
+
+static double ShiftLeft(double a, double b)
+{
+  return static_cast<double>(to_int(a) << to_int(b));
+}
+
+static double ShiftRight(double a, double b)
+{
+  return static_cast<double>(to_int(a) >> to_int(b));
+}
+
+static double BitwiseAnd(double a, double b)
+{
+  return static_cast<double>(to_int(a) & to_int(b));
+}
+
+static double BitwiseOr(double a, double b)
+{
+  return static_cast<double>(to_int(a) | to_int(b));
+}
+
+static double BitwiseXor(double a, double b)
+{
+  return static_cast<double>(to_int(a) ^ to_int(b));
+}
+
+static double BitwiseNot(double a)
+{
+  return static_cast<double>(~to_int(a));
+}
+
+CompiledExpression::CompiledExpression(PureFunctionLookup lookup_pure_function)
+    : m_lookup_pure_function(lookup_pure_function)
+{
+}
+
+std::unique_ptr<CompiledExpression>
+CompiledExpression::Compile(const expr& e, const expr_var_list& vars,
+                            const std::vector<Expression::VarBinding>& binds,
+                            PureFunctionLookup lookup_pure_function)
+{
+  std::unique_ptr<CompiledExpression> compiled(new CompiledExpression(lookup_pure_function));
+
+  auto bind = binds.begin();
+  for (const expr_var* v = vars.head; v != nullptr && bind != binds.end(); v = v->next, ++bind)
+    compiled->m_variables.emplace(&v->value, *bind);
+
+  compiled->AllocCodeSpace(4096);
+  if (!compiled->EmitFunction(e))
+    return nullptr;
+
+  compiled->WriteProtect(true);
+  return compiled;
+}
+
+bool CompiledExpression::EmitFunction(const expr& e)
+{
+  const u8* start = GetCodePtr();
+
+  m_shadow_size = ABI_PushRegistersAndAdjustStack({ppc_state_reg}, 8,
+                                                  MAX_SPILL_SLOTS * sizeof(double));
+  MOV(64, R(ppc_state_reg), R(ABI_PARAM1));
+
+  if (!EmitNode(e, 0))
+    return false;
+
+  ABI_PopRegistersAndAdjustStack({ppc_state_reg}, 8, MAX_SPILL_SLOTS * sizeof(double));
+  RET();
+
+  // Running out of space can only happen for absurdly long expressions, which the interpreter
+  // handles just fine.
+  if (HasWriteFailed())
+    return false;
+
+  m_function = reinterpret_cast<Expression::CompiledFunction>(const_cast<u8*>(start));
+  Common::JitRegister::Register(start, GetCodePtr(), "JIT_BreakpointCondition");
+  return true;
+}
+
+// Emits code leaving the value of the expression in XMM0. Spill slots starting at spill_slot may be
+// used for intermediate results.
+bool CompiledExpression::EmitNode(const expr& e, u32 spill_slot)
+{
+  const expr* args = e.param.op.args.buf;
+
+  switch (e.type)
+  {
+  case OP_CONST:
+    EmitConstant(e.param.num.value);
+    return true;
+
+  case OP_VAR:
+    return EmitVariable(e.param.var.value);
+
+  case OP_UNARY_MINUS:
+    if (!EmitNode(args[0], spill_slot))
+      return false;
+    MOV(64, R(RAX), Imm64(0x8000'0000'0000'0000));
+    MOVQ_xmm(XMM1, R(RAX));
+    XORPD(XMM0, R(XMM1));
+    return true;
+
+  case OP_UNARY_LOGICAL_NOT:
+    if (!EmitNode(args[0], spill_slot))
+      return false;
+    XORPD(XMM1, R(XMM1));
+    CMPSD(XMM0, R(XMM1), CMP_EQ);
+    EmitMaskToBoolean();
+    return true;
+
+  case OP_UNARY_BITWISE_NOT:
+    if (!EmitNode(args[0], spill_slot))
+      return false;
+    ABI_CallFunction(BitwiseNot);
+    return true;
+
+  case OP_PLUS:
+  case OP_MINUS:
+  case OP_MULTIPLY:
+  case OP_DIVIDE:
+    if (!EmitOperands(e, spill_slot))
+      return false;
+    if (e.type == OP_PLUS)
+      ADDSD(XMM0, R(XMM1));
+    else if (e.type == OP_MINUS)
+      SUBSD(XMM0, R(XMM1));
+    else if (e.type == OP_MULTIPLY)
+      MULSD(XMM0, R(XMM1));
+    else
+      DIVSD(XMM0, R(XMM1));
+    return true;
+
+  // CMPSD's ordered predicates match C++'s comparisons on NaN, and CMP_NEQ is unordered like !=.
+  case OP_LT:
+  case OP_LE:
+  case OP_EQ:
+  case OP_NE:
+    if (!EmitOperands(e, spill_slot))
+      return false;
+    if (e.type == OP_LT)
+      CMPSD(XMM0, R(XMM1), CMP_LT);
+    else if (e.type == OP_LE)
+      CMPSD(XMM0, R(XMM1), CMP_LE);
+    else if (e.type == OP_EQ)
+      CMPSD(XMM0, R(XMM1), CMP_EQ);
+    else
+      CMPSD(XMM0, R(XMM1), CMP_NEQ);
+    EmitMaskToBoolean();
+    return true;
+
+  case OP_GT:
+  case OP_GE:
+    if (!EmitOperands(e, spill_slot))
+      return false;
+    CMPSD(XMM1, R(XMM0), e.type == OP_GT ? CMP_LT : CMP_LE);
+    MOVAPD(XMM0, R(XMM1));
+    EmitMaskToBoolean();
+    return true;
+
+  case OP_POWER:
+  case OP_REMAINDER:
+  case OP_SHL:
+  case OP_SHR:
+  case OP_BITWISE_AND:
+  case OP_BITWISE_OR:
+  case OP_BITWISE_XOR:
+  {
+    if (!EmitOperands(e, spill_slot))
+      return false;
+
+    using BinaryFunction = double (*)(double, double);
+    const BinaryFunction function = e.type == OP_POWER       ? Power :
+                                    e.type == OP_REMAINDER   ? Remainder :
+                                    e.type == OP_SHL         ? ShiftLeft :
+                                    e.type == OP_SHR         ? ShiftRight :
+                                    e.type == OP_BITWISE_AND ? BitwiseAnd :
+                                    e.type == OP_BITWISE_OR  ? BitwiseOr :
+                                                               BitwiseXor;
+    ABI_CallFunction(function);
+    return true;
+  }
+
+  case OP_LOGICAL_AND:
+  {
+    // Returns the second operand if both are non-zero, 0 otherwise.
+    if (!EmitNode(args[0], spill_slot))
+      return false;
+    const FixupBranch first_zero = EmitBranchIfZero();
+    if (!EmitNode(args[1], spill_slot))
+      return false;
+    const FixupBranch second_zero = EmitBranchIfZero();
+    const FixupBranch done = J();
+    SetJumpTarget(first_zero);
+    SetJumpTarget(second_zero);
+    XORPD(XMM0, R(XMM0));
+    SetJumpTarget(done);
+    return true;
+  }
+
+  case OP_LOGICAL_OR:
+  {
+    // Returns the first operand if it's non-zero and not NaN, else the second one if it's non-zero,
+    // else 0.
+    if (!EmitNode(args[0], spill_slot))
+      return false;
+    XORPD(XMM1, R(XMM1));
+    UCOMISD(XMM0, R(XMM1));
+    const FixupBranch first_taken = J_CC(CC_NE, Jump::Near);
+    if (!EmitNode(args[1], spill_slot))
+      return false;
+    const FixupBranch second_zero = EmitBranchIfZero();
+    const FixupBranch done = J();
+    SetJumpTarget(second_zero);
+    XORPD(XMM0, R(XMM0));
+    SetJumpTarget(done);
+    SetJumpTarget(first_taken);
+    return true;
+  }
+
+  case OP_COMMA:
+    return EmitNode(args[0], spill_slot) && EmitNode(args[1], spill_slot);
+
+  case OP_FUNC:
+  {
+    const Expression::PureFunction function = m_lookup_pure_function(e.param.func.f);
+    if (!function || vec_len(&e.param.func.args) != 1)
+      return false;
+    if (!EmitNode(e.param.func.args.buf[0], spill_slot))
+      return false;
+    ABI_CallFunction(function);
+    return true;
+  }
+
+  default:
+    // Assignments, strings and anything unknown.
+    return false;
+  }
+}
+
+// Emits code leaving the first operand in XMM0 and the second one in XMM1.
+bool CompiledExpression::EmitOperands(const expr& e, u32 spill_slot)
+{
+  if (spill_slot >= MAX_SPILL_SLOTS)
+    return false;
+
+  if (!EmitNode(e.param.op.args.buf[0], spill_slot))
+    return false;
+  MOVSD(SpillSlot(spill_slot), XMM0);
+  if (!EmitNode(e.param.op.args.buf[1], spill_slot + 1))
+    return false;
+  MOVAPD(XMM1, R(XMM0));
+  MOVSD(XMM0, SpillSlot(spill_slot));
+  return true;
+}
+
+bool CompiledExpression::EmitVariable(const double* value)
+{
+  const auto it = m_variables.find(value);
+  if (it == m_variables.end())
+    return false;
+
+  const Expression::VarBinding& bind = it->second;
+  int offset;
+  switch (bind.type)
+  {
+  case Expression::VarBindingType::Zero:
+    XORPD(XMM0, R(XMM0));
+    return true;
+  case Expression::VarBindingType::FPR:
+    offset = static_cast<int>(offsetof(PowerPC::PowerPCState, ps) +
+                              sizeof(PowerPC::PairedSingle) * bind.index);
+    MOVSD(XMM0, MDisp(ppc_state_reg, offset));
+    return true;
+  case Expression::VarBindingType::GPR:
+    offset = static_cast<int>(offsetof(PowerPC::PowerPCState, gpr) + sizeof(u32) * bind.index);
+    break;
+  case Expression::VarBindingType::SPR:
+    offset = static_cast<int>(offsetof(PowerPC::PowerPCState, spr) + sizeof(u32) * bind.index);
+    break;
+  case Expression::VarBindingType::PCtr:
+    offset = static_cast<int>(offsetof(PowerPC::PowerPCState, pc));
+    break;
+  default:
+    return false;
+  }
+
+  // CVTSI2SD without REX.W converts signed 32-bit integers, so bias the unsigned value.
+  MOV(32, R(EAX), MDisp(ppc_state_reg, offset));
+  XOR(32, R(EAX), Imm32(0x8000'0000));
+  CVTSI2SD(XMM0, R(EAX));
+  MOV(64, R(RAX), Imm64(Common::BitCast<u64>(2147483648.0)));
+  MOVQ_xmm(XMM1, R(RAX));
+  ADDSD(XMM0, R(XMM1));
+  return true;
+}
+
+void CompiledExpression::EmitConstant(double value)
+{
+  if (Common::BitCast<u64>(value) == 0)
+  {
+    XORPD(XMM0, R(XMM0));
+    return;
+  }
+
+  MOV(64, R(RAX), Imm64(Common::BitCast<u64>(value)));
+  MOVQ_xmm(XMM0, R(RAX));
+}
+
+// Turns the all-ones or all-zeroes mask produced by CMPSD in XMM0 into 1.0 or 0.0.
+void CompiledExpression::EmitMaskToBoolean()
+{
+  MOV(64, R(RAX), Imm64(Common::BitCast<u64>(1.0)));
+  MOVQ_xmm(XMM1, R(RAX));
+  ANDPD(XMM0, R(XMM1));
+}
+
+// Branches if XMM0 compares equal to zero. NaN counts as non-zero.
+FixupBranch CompiledExpression::EmitBranchIfZero()
+{
+  XORPD(XMM1, R(XMM1));
+  UCOMISD(XMM0, R(XMM1));
+  const FixupBranch unordered = J_CC(CC_P);
+  const FixupBranch zero = J_CC(CC_E, Jump::Near);
+  SetJumpTarget(unordered);
+  return zero;
+}
+
+OpArg CompiledExpression::SpillSlot(u32 spill_slot) const
+{
+  return MDisp(RSP, static_cast<int>(m_shadow_size + spill_slot * sizeof(double)));
+}
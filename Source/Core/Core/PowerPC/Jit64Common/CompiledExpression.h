@@ -0,0 +1,55 @@
+// Copyright 2026 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/x64Emitter.h"
+#include "Core/PowerPC/Expression.h"
+
+struct expr;
+struct expr_func;
+struct expr_var_list;
+
+// Native code version of a breakpoint condition, so that conditional breakpoints and memchecks on
+// hot addresses don't have to walk the expression tree on every hit.
+//
+// Only expressions without side effects are compiled: assignments, the write_* functions and the
+// functions taking strings fall back to the interpreter in Expression::Evaluate.
+class CompiledExpression final : public Gen::X64CodeBlock
+{
+public:
+  using PureFunctionLookup = Expression::PureFunction (*)(const expr_func* function);
+
+  // Returns nullptr if the expression uses something which can't be compiled.
+  static std::unique_ptr<CompiledExpression>
+  Compile(const expr& e, const expr_var_list& vars, const std::vector<Expression::VarBinding>& binds,
+          PureFunctionLookup lookup_pure_function);
+
+  Expression::CompiledFunction GetFunction() const { return m_function; }
+
+private:
+  // Intermediate results are kept in a fixed number of stack slots. Deeper expressions aren't
+  // compiled.
+  static constexpr u32 MAX_SPILL_SLOTS = 16;
+
+  explicit CompiledExpression(PureFunctionLookup lookup_pure_function);
+
+  bool EmitFunction(const expr& e);
+  bool EmitNode(const expr& e, u32 spill_slot);
+  bool EmitOperands(const expr& e, u32 spill_slot);
+  bool EmitVariable(const double* value);
+  void EmitConstant(double value);
+  void EmitMaskToBoolean();
+  Gen::FixupBranch EmitBranchIfZero();
+  Gen::OpArg SpillSlot(u32 spill_slot) const;
+
+  PureFunctionLookup m_lookup_pure_function;
+  std::map<const double*, Expression::VarBinding> m_variables;
+  size_t m_shadow_size = 0;
+  Expression::CompiledFunction m_function = nullptr;
+};
@@ -28,6 +28,9 @@ public:
   const void* GetConstant(const void* value, size_t element_size, size_t num_elements,
                           size_t index);
 
+  size_t GetSize() const { return m_region_size; }
+  size_t GetUsedSize() const { return m_region_size - m_remaining_size; }
+
 private:
   struct ConstantInfo
   {
@@ -10,6 +10,7 @@
 #include "Common/CPUDetect.h"
 #include "Common/FloatUtils.h"
 #include "Common/Intrinsics.h"
+#include "Common/SmallVector.h"
 #include "Common/Swap.h"
 #include "Core/HW/MMIO.h"
 #include "Core/HW/Memmap.h"
@@ -908,9 +909,14 @@ void EmuCodeBlock::SetFPRF(Gen::X64Reg xmm, bool single)
 {
   const int input_size = single ? 32 : 64;
 
+  // Normalized numbers are by far the most common result, so they're handled inline without any
+  // taken branches. Everything else lives in far code.
+  const bool use_far_code = m_far_code.Enabled();
+  const Jump jump_type = use_far_code ? Jump::Near : Jump::Short;
+
   AND(32, PPCSTATE(fpscr), Imm32(~FPRF_MASK));
 
-  FixupBranch continue1, continue2, continue3, continue4;
+  Common::SmallVector<FixupBranch, 4> exits;
   if (cpu_info.bSSE4_1)
   {
     MOVQ_xmm(R(RSCRATCH), xmm);
@@ -920,13 +926,16 @@ void EmuCodeBlock::SetFPRF(Gen::X64Reg xmm, bool single)
       PTEST(xmm, MConst(psFloatExp));
     else
       PTEST(xmm, MConst(psDoubleExp));
-    FixupBranch maxExponent = J_CC(CC_C);
-    FixupBranch zeroExponent = J_CC(CC_Z);
+    FixupBranch maxExponent = J_CC(CC_C, jump_type);
+    FixupBranch zeroExponent = J_CC(CC_Z, jump_type);
 
     // Nice normalized number: sign ? PPC_FPCLASS_NN : PPC_FPCLASS_PN;
     LEA(32, RSCRATCH,
         MScaled(RSCRATCH, Common::PPC_FPCLASS_NN - Common::PPC_FPCLASS_PN, Common::PPC_FPCLASS_PN));
-    continue1 = J();
+    if (use_far_code)
+      SwitchToFarCode();
+    else
+      exits.push_back(J());
 
     SetJumpTarget(maxExponent);
     if (single)
@@ -937,14 +946,14 @@ void EmuCodeBlock::SetFPRF(Gen::X64Reg xmm, bool single)
 
     // Max exponent + mantissa: PPC_FPCLASS_QNAN
     MOV(32, R(RSCRATCH), Imm32(Common::PPC_FPCLASS_QNAN));
-    continue2 = J();
+    exits.push_back(J(jump_type));
 
     // Max exponent + no mantissa: sign ? PPC_FPCLASS_NINF : PPC_FPCLASS_PINF;
     SetJumpTarget(notNAN);
     LEA(32, RSCRATCH,
         MScaled(RSCRATCH, Common::PPC_FPCLASS_NINF - Common::PPC_FPCLASS_PINF,
                 Common::PPC_FPCLASS_PINF));
-    continue3 = J();
+    exits.push_back(J(jump_type));
 
     SetJumpTarget(zeroExponent);
     if (single)
@@ -956,12 +965,14 @@ void EmuCodeBlock::SetFPRF(Gen::X64Reg xmm, bool single)
     // No exponent + mantissa: sign ? PPC_FPCLASS_ND : PPC_FPCLASS_PD;
     LEA(32, RSCRATCH,
         MScaled(RSCRATCH, Common::PPC_FPCLASS_ND - Common::PPC_FPCLASS_PD, Common::PPC_FPCLASS_PD));
-    continue4 = J();
+    exits.push_back(J(jump_type));
 
     // Zero: sign ? PPC_FPCLASS_NZ : PPC_FPCLASS_PZ;
     SetJumpTarget(zero);
     SHL(32, R(RSCRATCH), Imm8(4));
     ADD(32, R(RSCRATCH), Imm8(Common::PPC_FPCLASS_PZ));
+    if (use_far_code)
+      exits.push_back(J(Jump::Near));
   }
   else
   {
@@ -970,7 +981,7 @@ void EmuCodeBlock::SetFPRF(Gen::X64Reg xmm, bool single)
       TEST(32, R(RSCRATCH), Imm32(Common::FLOAT_EXP));
     else
       TEST(64, R(RSCRATCH), MConst(psDoubleExp));
-    FixupBranch zeroExponent = J_CC(CC_Z);
+    FixupBranch zeroExponent = J_CC(CC_Z, jump_type);
 
     if (single)
     {
@@ -982,19 +993,22 @@ void EmuCodeBlock::SetFPRF(Gen::X64Reg xmm, bool single)
       AND(64, R(RSCRATCH), MConst(psDoubleNoSign));
       CMP(64, R(RSCRATCH), MConst(psDoubleExp));
     }
-    FixupBranch nan =
-        J_CC(CC_G);  // This works because if the sign bit is set, RSCRATCH is negative
-    FixupBranch infinity = J_CC(CC_E);
+    // This works because if the sign bit is set, RSCRATCH is negative
+    FixupBranch nan = J_CC(CC_G, jump_type);
+    FixupBranch infinity = J_CC(CC_E, jump_type);
 
     MOVQ_xmm(R(RSCRATCH), xmm);
     SHR(input_size, R(RSCRATCH), Imm8(input_size - 1));
     LEA(32, RSCRATCH,
         MScaled(RSCRATCH, Common::PPC_FPCLASS_NN - Common::PPC_FPCLASS_PN, Common::PPC_FPCLASS_PN));
-    continue1 = J();
+    if (use_far_code)
+      SwitchToFarCode();
+    else
+      exits.push_back(J());
 
     SetJumpTarget(nan);
     MOV(32, R(RSCRATCH), Imm32(Common::PPC_FPCLASS_QNAN));
-    continue2 = J();
+    exits.push_back(J(jump_type));
 
     SetJumpTarget(infinity);
     MOVQ_xmm(R(RSCRATCH), xmm);
@@ -1002,7 +1016,7 @@ void EmuCodeBlock::SetFPRF(Gen::X64Reg xmm, bool single)
     LEA(32, RSCRATCH,
         MScaled(RSCRATCH, Common::PPC_FPCLASS_NINF - Common::PPC_FPCLASS_PINF,
                 Common::PPC_FPCLASS_PINF));
-    continue3 = J();
+    exits.push_back(J(jump_type));
 
     SetJumpTarget(zeroExponent);
     if (single)
@@ -1014,18 +1028,20 @@ void EmuCodeBlock::SetFPRF(Gen::X64Reg xmm, bool single)
     SHR(input_size, R(RSCRATCH), Imm8(input_size - 1));
     LEA(32, RSCRATCH,
         MScaled(RSCRATCH, Common::PPC_FPCLASS_ND - Common::PPC_FPCLASS_PD, Common::PPC_FPCLASS_PD));
-    continue4 = J();
+    exits.push_back(J(jump_type));
 
     SetJumpTarget(zero);
     SHR(input_size, R(RSCRATCH), Imm8(input_size - 1));
     SHL(32, R(RSCRATCH), Imm8(4));
     ADD(32, R(RSCRATCH), Imm8(Common::PPC_FPCLASS_PZ));
+    if (use_far_code)
+      exits.push_back(J(Jump::Near));
   }
 
-  SetJumpTarget(continue1);
-  SetJumpTarget(continue2);
-  SetJumpTarget(continue3);
-  SetJumpTarget(continue4);
+  if (use_far_code)
+    SwitchToNearCode();
+  for (const FixupBranch& exit : exits)
+    SetJumpTarget(exit);
   SHL(32, R(RSCRATCH), Imm8(FPRF_SHIFT));
   OR(32, PPCSTATE(fpscr), R(RSCRATCH));
 }
@@ -3,6 +3,7 @@
 
 #include "Core/PowerPC/JitArm64/Jit.h"
 
+#include <chrono>
 #include <cstdio>
 
 #include "Common/Arm64Emitter.h"
@@ -85,12 +86,14 @@ void JitArm64::SetOptimizationEnabled(bool enabled)
     analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_CONDITIONAL_CONTINUE);
     analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_CARRY_MERGE);
     analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_BRANCH_FOLLOW);
+    analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_LEAF_FUNCTION_INLINE);
   }
   else
   {
     analyzer.ClearOption(PPCAnalyst::PPCAnalyzer::OPTION_CONDITIONAL_CONTINUE);
     analyzer.ClearOption(PPCAnalyst::PPCAnalyzer::OPTION_CARRY_MERGE);
     analyzer.ClearOption(PPCAnalyst::PPCAnalyzer::OPTION_BRANCH_FOLLOW);
+    analyzer.ClearOption(PPCAnalyst::PPCAnalyzer::OPTION_LEAF_FUNCTION_INLINE);
   }
 }
 
@@ -133,9 +136,15 @@ bool JitArm64::HandleFault(uintptr_t access_address, SContext* ctx)
                       fmt::ptr(m_ppc_state.mem_ptr), fmt::ptr(memory.GetPhysicalBase()),
                       fmt::ptr(memory.GetLogicalBase()));
       }
+      else if (HandleCodeWriteFault(access_address))
+      {
+        success = true;
+      }
       else
       {
         success = HandleFastmemFault(ctx);
+        if (success)
+          m_statistics.fastmem_backpatches++;
       }
     }
   }
@@ -150,6 +159,7 @@ bool JitArm64::HandleFault(uintptr_t access_address, SContext* ctx)
 
 void JitArm64::ClearCache()
 {
+  m_statistics.cache_clears++;
   m_fault_to_handler.clear();
 
   blocks.Clear();
@@ -164,6 +174,26 @@ void JitArm64::ClearCache()
   ResetFreeMemoryRanges();
 }
 
+static u64 GetFreeBytes(const HyoutaUtilities::RangeSizeSet<u8*>& free_ranges)
+{
+  u64 free_bytes = 0;
+  for (auto it = free_ranges.begin(); it != free_ranges.end(); ++it)
+    free_bytes += it.to() - it.from();
+  return free_bytes;
+}
+
+JitStatistics JitArm64::GetStatistics()
+{
+  JitStatistics statistics = JitBase::GetStatistics();
+
+  statistics.near_code.size = GetRegionSize();
+  statistics.near_code.used = GetRegionSize() - GetFreeBytes(m_free_ranges_near);
+  statistics.far_code.size = m_far_code.GetRegionSize();
+  statistics.far_code.used = m_far_code.GetRegionSize() - GetFreeBytes(m_free_ranges_far);
+
+  return statistics;
+}
+
 void JitArm64::ResetFreeMemoryRanges()
 {
   // Set the near and far code regions as unused.
@@ -947,6 +977,8 @@ void JitArm64::Jit(u32 em_address, bool clear_cache_and_retry_on_failure)
     }
   }
 
+  const auto analysis_start = std::chrono::steady_clock::now();
+
   // Analyze the block, collect all instructions it is made of (including inlining,
   // if that is enabled), reorder instructions for optimal performance, and join joinable
   // instructions.
@@ -989,6 +1021,7 @@ void JitArm64::Jit(u32 em_address, bool clear_cache_and_retry_on_failure)
       b->far_end = far_end;
 
       blocks.FinalizeBlock(*b, jo.enableBlocklink, code_block.m_physical_addresses);
+      RecordCompiledBlock(*b, std::chrono::steady_clock::now() - analysis_start);
       return;
     }
   }
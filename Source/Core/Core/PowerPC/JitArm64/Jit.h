@@ -38,6 +38,8 @@ public:
   void DoBacktrace(uintptr_t access_address, SContext* ctx);
   bool HandleFastmemFault(SContext* ctx);
 
+  JitStatistics GetStatistics() override;
+
   void ClearCache() override;
 
   CommonAsmRoutinesBase* GetAsmRoutines() override { return this; }
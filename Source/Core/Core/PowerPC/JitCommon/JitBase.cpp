@@ -5,6 +5,8 @@
 
 #include <algorithm>
 #include <array>
+#include <limits>
+#include <optional>
 #include <utility>
 
 #include "Common/Align.h"
@@ -18,6 +20,7 @@
 #include "Core/Core.h"
 #include "Core/CoreTiming.h"
 #include "Core/HW/CPU.h"
+#include "Core/HW/Memmap.h"
 #include "Core/MemTools.h"
 #include "Core/PowerPC/PPCAnalyst.h"
 #include "Core/PowerPC/PowerPC.h"
@@ -57,7 +60,7 @@
 // After resetting the stack to the top, we call _resetstkoflw() to restore
 // the guard page at the 256kb mark.
 
-const std::array<std::pair<bool JitBase::*, const Config::Info<bool>*>, 22> JitBase::JIT_SETTINGS{{
+const std::array<std::pair<bool JitBase::*, const Config::Info<bool>*>, 28> JitBase::JIT_SETTINGS{{
     {&JitBase::bJITOff, &Config::MAIN_DEBUG_JIT_OFF},
     {&JitBase::bJITLoadStoreOff, &Config::MAIN_DEBUG_JIT_LOAD_STORE_OFF},
     {&JitBase::bJITLoadStorelXzOff, &Config::MAIN_DEBUG_JIT_LOAD_STORE_LXZ_OFF},
@@ -73,6 +76,12 @@ const std::array<std::pair<bool JitBase::*, const Config::Info<bool>*>, 22> JitB
     {&JitBase::bJITRegisterCacheOff, &Config::MAIN_DEBUG_JIT_REGISTER_CACHE_OFF},
     {&JitBase::m_enable_debugging, &Config::MAIN_ENABLE_DEBUGGING},
     {&JitBase::m_enable_branch_following, &Config::MAIN_JIT_FOLLOW_BRANCH},
+    {&JitBase::m_enable_leaf_function_inlining, &Config::MAIN_JIT_INLINE_LEAF_FUNCTIONS},
+    {&JitBase::m_enable_block_disk_cache, &Config::MAIN_JIT_BLOCK_DISK_CACHE},
+    {&JitBase::m_enable_tiered_compilation, &Config::MAIN_JIT_TIERED_COMPILATION},
+    {&JitBase::m_enable_deferred_compilation, &Config::MAIN_JIT_DEFERRED_COMPILATION},
+    {&JitBase::m_enable_loop_carried_registers, &Config::MAIN_JIT_LOOP_CARRIED_REGISTERS},
+    {&JitBase::m_enable_code_write_protection, &Config::MAIN_JIT_CODE_WRITE_PROTECTION},
     {&JitBase::m_enable_float_exceptions, &Config::MAIN_FLOAT_EXCEPTIONS},
     {&JitBase::m_enable_div_by_zero_exceptions, &Config::MAIN_DIVIDE_BY_ZERO_EXCEPTIONS},
     {&JitBase::m_low_dcbz_hack, &Config::MAIN_LOW_DCBZ_HACK},
@@ -96,10 +105,8 @@ JitBase::JitBase(Core::System& system)
     : m_code_buffer(code_buffer_size), m_system(system), m_ppc_state(system.GetPPCState()),
       m_mmu(system.GetMMU())
 {
-  m_registered_config_callback_id = CPUThreadConfigCallback::AddConfigChangedCallback([this] {
-    if (DoesConfigNeedRefresh())
-      ClearCache();
-  });
+  m_registered_config_callback_id =
+      CPUThreadConfigCallback::AddConfigChangedCallback([this] { OnConfigChanged(); });
   // The JIT is responsible for calling RefreshConfig on Init and ClearCache
 }
 
@@ -108,6 +115,12 @@ JitBase::~JitBase()
   CPUThreadConfigCallback::RemoveConfigChangedCallback(m_registered_config_callback_id);
 }
 
+void JitBase::OnConfigChanged()
+{
+  if (DoesConfigNeedRefresh())
+    ClearCache();
+}
+
 bool JitBase::DoesConfigNeedRefresh()
 {
   return std::any_of(JIT_SETTINGS.begin(), JIT_SETTINGS.end(), [this](const auto& pair) {
@@ -129,12 +142,19 @@ void JitBase::RefreshConfig()
 
   analyzer.SetDebuggingEnabled(m_enable_debugging);
   analyzer.SetBranchFollowingEnabled(m_enable_branch_following);
+  analyzer.SetLeafFunctionInliningEnabled(m_enable_leaf_function_inlining);
   analyzer.SetFloatExceptionsEnabled(m_enable_float_exceptions);
   analyzer.SetDivByZeroExceptionsEnabled(m_enable_div_by_zero_exceptions);
 
   bool any_watchpoints = m_system.GetPowerPC().GetMemChecks().HasAny();
-  jo.fastmem = m_fastmem_enabled && jo.fastmem_arena && (m_ppc_state.msr.DR || !any_watchpoints) &&
-               EMM::IsExceptionHandlerSupported();
+  jo.fastmem = m_fastmem_enabled && jo.fastmem_arena && EMM::IsExceptionHandlerSupported();
+#if defined(_M_ARM_64) && defined(__APPLE__)
+  // WriteProtectMemory is a no-op on this platform.
+  jo.code_write_protection = false;
+#else
+  jo.code_write_protection = m_enable_code_write_protection && jo.fastmem;
+#endif
+  jo.tiered_compilation = m_enable_tiered_compilation && m_enable_branch_following;
   jo.memcheck = m_system.IsMMUMode() || m_system.IsPauseOnPanicMode() || any_watchpoints;
   jo.fp_exceptions = m_enable_float_exceptions;
   jo.div_by_zero_exceptions = m_enable_div_by_zero_exceptions;
@@ -245,6 +265,23 @@ bool JitBase::HandleStackFault()
   return true;
 }
 
+bool JitBase::HandleCodeWriteFault(uintptr_t access_address)
+{
+  // Code which modifies itself without icbi is caught by the write protection of the pages holding
+  // compiled code. Throw away all blocks in the page, make it writable and let the store retry.
+  // The code following the store in the current block keeps running until the block is left.
+  auto& memory = m_system.GetMemory();
+  const std::optional<u32> page =
+      memory.UnprotectCodeAt(reinterpret_cast<const u8*>(access_address));
+  if (!page)
+    return false;
+
+  DEBUG_LOG_FMT(DYNA_REC, "Write to compiled code in page {:08x}", *page);
+  GetBlockCache()->ErasePhysicalRange(*page, static_cast<u32>(Common::GetPageSize()));
+  m_statistics.code_write_faults++;
+  return true;
+}
+
 void JitBase::CleanUpAfterStackFault()
 {
   if (m_cleanup_after_stackfault)
@@ -285,3 +322,31 @@ bool JitBase::ShouldHandleFPExceptionForInstruction(const PPCAnalyst::CodeOp* op
   else
     return false;
 }
+
+void JitBase::RecordCompiledBlock(JitBlock& block, std::chrono::steady_clock::duration compile_time)
+{
+  const u64 compile_time_ns =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(compile_time).count();
+  const u64 near_code_size = block.codeSize;
+  const u64 far_code_size = block.far_end - block.far_begin;
+
+  block.compile_time_ns =
+      static_cast<u32>(std::min<u64>(compile_time_ns, std::numeric_limits<u32>::max()));
+
+  m_statistics.blocks_compiled++;
+  m_statistics.instructions_compiled += block.originalSize;
+  m_statistics.compile_time_ns += compile_time_ns;
+  m_statistics.max_block_compile_time_ns =
+      std::max(m_statistics.max_block_compile_time_ns, compile_time_ns);
+  m_statistics.near_code_bytes += near_code_size;
+  m_statistics.far_code_bytes += far_code_size;
+  m_statistics.max_block_code_size =
+      std::max(m_statistics.max_block_code_size, near_code_size + far_code_size);
+}
+
+JitStatistics JitBase::GetStatistics()
+{
+  JitStatistics statistics = m_statistics;
+  GetBlockCache()->RunOnBlocks([&statistics](const JitBlock&) { statistics.live_blocks++; });
+  return statistics;
+}
@@ -4,8 +4,10 @@
 #pragma once
 
 #include <array>
+#include <chrono>
 #include <cstddef>
 #include <map>
+#include <unordered_map>
 #include <unordered_set>
 #include <utility>
 
@@ -19,6 +21,7 @@
 #include "Core/PowerPC/CPUCoreBase.h"
 #include "Core/PowerPC/JitCommon/JitAsmCommon.h"
 #include "Core/PowerPC/JitCommon/JitCache.h"
+#include "Core/PowerPC/JitCommon/JitStatistics.h"
 #include "Core/PowerPC/PPCAnalyst.h"
 
 namespace Core
@@ -81,10 +84,15 @@ protected:
     bool accurateSinglePrecision;
     bool fastmem;
     bool fastmem_arena;
+    // Write protect the fastmem pages containing compiled code to notice when it gets modified.
+    bool code_write_protection;
     bool memcheck;
     bool fp_exceptions;
     bool div_by_zero_exceptions;
     bool profile_blocks;
+    // Recompile hot blocks with more expensive optimizations. Only enabled along with branch
+    // following, which is what hot blocks mostly differ in.
+    bool tiered_compilation;
   };
   struct JitState
   {
@@ -92,6 +100,9 @@ protected:
     u32 blockStart;
     int instructionNumber;
     int instructionsLeft;
+    // How many of the following instructions the register caches consider when picking a
+    // register to spill.
+    int regCacheLookahead;
     int downcountAmount;
     u32 numLoadStoreInst;
     u32 numFloatingPointInst;
@@ -127,6 +138,16 @@ protected:
     std::unordered_set<u32> fifoWriteAddresses;
     std::unordered_set<u32> pairedQuantizeAddresses;
     std::unordered_set<u32> noSpeculativeConstantsAddresses;
+    std::unordered_set<u32> hotBlockAddresses;
+    // How many emulated ticks each hot block took to become hot.
+    std::unordered_map<u32, u64> hotBlockTierUpTicks;
+    // How often the conditional branch at each address went either way in blocks that haven't
+    // been recompiled as hot blocks yet. Compiled code holds pointers to the counters, so entries
+    // are only ever removed together with all blocks.
+    std::unordered_map<u32, PPCAnalyst::BranchProfile> branchProfiles;
+    // How often each block that hasn't been compiled yet has been run through the interpreter.
+    // Bounded by Jit64::DEFERRED_COMPILATION_MAX_TRACKED_BLOCKS.
+    std::unordered_map<u32, u32> interpretedBlockRuns;
   };
 
   PPCAnalyst::CodeBlock code_block;
@@ -149,6 +170,12 @@ protected:
   bool bJITRegisterCacheOff = false;
   bool m_enable_debugging = false;
   bool m_enable_branch_following = false;
+  bool m_enable_leaf_function_inlining = false;
+  bool m_enable_block_disk_cache = false;
+  bool m_enable_tiered_compilation = false;
+  bool m_enable_deferred_compilation = false;
+  bool m_enable_loop_carried_registers = false;
+  bool m_enable_code_write_protection = false;
   bool m_enable_float_exceptions = false;
   bool m_enable_div_by_zero_exceptions = false;
   bool m_low_dcbz_hack = false;
@@ -161,10 +188,14 @@ protected:
   bool m_cleanup_after_stackfault = false;
   u8* m_stack_guard = nullptr;
 
-  static const std::array<std::pair<bool JitBase::*, const Config::Info<bool>*>, 22> JIT_SETTINGS;
+  JitStatistics m_statistics;
+
+  static const std::array<std::pair<bool JitBase::*, const Config::Info<bool>*>, 28> JIT_SETTINGS;
 
   bool DoesConfigNeedRefresh();
   void RefreshConfig();
+  // Called on the CPU thread whenever the config changes, which includes title changes.
+  virtual void OnConfigChanged();
 
   void InitFastmemArena();
 
@@ -177,6 +208,9 @@ protected:
 
   bool ShouldHandleFPExceptionForInstruction(const PPCAnalyst::CodeOp* op);
 
+  // Updates the statistics after a block has been compiled and its code size has been set.
+  void RecordCompiledBlock(JitBlock& block, std::chrono::steady_clock::duration compile_time);
+
 public:
   explicit JitBase(Core::System& system);
   JitBase(const JitBase&) = delete;
@@ -196,6 +230,12 @@ public:
 
   virtual bool HandleFault(uintptr_t access_address, SContext* ctx) = 0;
   bool HandleStackFault();
+  // Handles a store to a page which is write protected because it contains compiled code. Returns
+  // false if the fault has another cause.
+  bool HandleCodeWriteFault(uintptr_t access_address);
+
+  // Returns the accumulated statistics together with the current state of the code cache.
+  virtual JitStatistics GetStatistics();
 
   static constexpr std::size_t code_buffer_size = 32000;
 
@@ -7,7 +7,6 @@
 #include <array>
 #include <cstring>
 #include <functional>
-#include <map>
 #include <set>
 #include <utility>
 
@@ -15,10 +14,12 @@
 #include "Common/JitRegister.h"
 #include "Core/Config/MainSettings.h"
 #include "Core/Core.h"
+#include "Core/HW/Memmap.h"
 #include "Core/PowerPC/JitCommon/JitBase.h"
 #include "Core/PowerPC/MMU.h"
 #include "Core/PowerPC/PPCSymbolDB.h"
 #include "Core/PowerPC/PowerPC.h"
+#include "Core/System.h"
 
 #ifdef _WIN32
 #include <windows.h>
@@ -28,8 +29,49 @@ using namespace Gen;
 
 bool JitBlock::OverlapsPhysicalRange(u32 address, u32 length) const
 {
-  return physical_addresses.lower_bound(address) !=
-         physical_addresses.lower_bound(address + length);
+  return std::lower_bound(physical_addresses.begin(), physical_addresses.end(), address) !=
+         std::lower_bound(physical_addresses.begin(), physical_addresses.end(), address + length);
+}
+
+std::vector<JitBlock*>* BlockRangeTable::Find(u32 address)
+{
+  const std::unique_ptr<Page>& page = m_pages[address >> PAGE_SHIFT];
+  if (!page)
+    return nullptr;
+
+  std::vector<JitBlock*>& blocks = (*page)[(address >> RANGE_SHIFT) & (RANGES_PER_PAGE - 1)];
+  return blocks.empty() ? nullptr : &blocks;
+}
+
+void BlockRangeTable::Insert(u32 address, JitBlock* block)
+{
+  std::unique_ptr<Page>& page = m_pages[address >> PAGE_SHIFT];
+  if (!page)
+    page = std::make_unique<Page>();
+
+  std::vector<JitBlock*>& blocks = (*page)[(address >> RANGE_SHIFT) & (RANGES_PER_PAGE - 1)];
+  if (std::find(blocks.begin(), blocks.end(), block) == blocks.end())
+    blocks.push_back(block);
+}
+
+void BlockRangeTable::Erase(u32 address, JitBlock* block)
+{
+  std::vector<JitBlock*>* blocks = Find(address);
+  if (!blocks)
+    return;
+
+  const auto it = std::find(blocks->begin(), blocks->end(), block);
+  if (it == blocks->end())
+    return;
+
+  *it = blocks->back();
+  blocks->pop_back();
+}
+
+void BlockRangeTable::Clear()
+{
+  for (std::unique_ptr<Page>& page : m_pages)
+    page.reset();
 }
 
 JitBaseBlockCache::JitBaseBlockCache(JitBase& jit) : m_jit{jit}
@@ -68,18 +110,22 @@ void JitBaseBlockCache::Clear()
   m_jit.js.fifoWriteAddresses.clear();
   m_jit.js.pairedQuantizeAddresses.clear();
   m_jit.js.noSpeculativeConstantsAddresses.clear();
-  for (auto& e : block_map)
-  {
-    DestroyBlock(e.second);
-  }
-  block_map.clear();
-  links_to.clear();
-  block_range_map.clear();
+  m_jit.js.hotBlockAddresses.clear();
+  m_jit.js.hotBlockTierUpTicks.clear();
+  m_jit.js.branchProfiles.clear();
+  m_jit.js.interpretedBlockRuns.clear();
+  ForEachBlock([this](JitBlock& block) { DestroyBlock(block); });
+  block_range_map.Clear();
+  links_to.Clear();
+  m_block_pool.clear();
+  m_free_blocks.clear();
 
   valid_block.ClearAll();
 
   if (m_entry_points_ptr)
     m_entry_points_arena.Clear();
+
+  m_jit.m_system.GetMemory().UnprotectAllCode();
 }
 
 void JitBaseBlockCache::Reset()
@@ -98,16 +144,45 @@ JitBlock** JitBaseBlockCache::GetFastBlockMapFallback()
   return m_fast_block_map_fallback.data();
 }
 
+template <typename Func>
+void JitBaseBlockCache::ForEachBlock(Func f)
+{
+  block_range_map.ForEachRange(
+      0, 0xffffffff, [&f](u32 range_start, std::vector<JitBlock*>& blocks) {
+        // Blocks are listed in every range they occupy, only visit them in the range of their
+        // entry point.
+        for (JitBlock* block : blocks)
+        {
+          if ((block->physicalAddress >> BlockRangeTable::RANGE_SHIFT) ==
+              (range_start >> BlockRangeTable::RANGE_SHIFT))
+          {
+            f(*block);
+          }
+        }
+      });
+}
+
 void JitBaseBlockCache::RunOnBlocks(std::function<void(const JitBlock&)> f)
 {
-  for (const auto& e : block_map)
-    f(e.second);
+  ForEachBlock([&f](const JitBlock& block) { f(block); });
 }
 
 JitBlock* JitBaseBlockCache::AllocateBlock(u32 em_address)
 {
   const u32 physical_address = m_jit.m_mmu.JitCache_TranslateAddress(em_address).address;
-  JitBlock& b = block_map.emplace(physical_address, JitBlock())->second;
+  JitBlock* block;
+  if (!m_free_blocks.empty())
+  {
+    block = m_free_blocks.back();
+    m_free_blocks.pop_back();
+    *block = JitBlock();
+  }
+  else
+  {
+    block = &m_block_pool.emplace_back();
+  }
+
+  JitBlock& b = *block;
   b.effectiveAddress = em_address;
   b.physicalAddress = physical_address;
   b.feature_flags = m_jit.m_ppc_state.feature_flags;
@@ -116,6 +191,11 @@ JitBlock* JitBaseBlockCache::AllocateBlock(u32 em_address)
   return &b;
 }
 
+void JitBaseBlockCache::DiscardBlock(JitBlock& block)
+{
+  m_free_blocks.push_back(&block);
+}
+
 void JitBaseBlockCache::FinalizeBlock(JitBlock& block, bool block_link,
                                       const std::set<u32>& physical_addresses)
 {
@@ -131,20 +211,33 @@ void JitBaseBlockCache::FinalizeBlock(JitBlock& block, bool block_link,
   }
   block.fast_block_map_index = index;
 
-  block.physical_addresses = physical_addresses;
+  block.physical_addresses.assign(physical_addresses.begin(), physical_addresses.end());
 
-  u32 range_mask = ~(BLOCK_RANGE_MAP_ELEMENTS - 1);
+  block_range_map.Insert(block.physicalAddress, &block);
   for (u32 addr : physical_addresses)
   {
     valid_block.Set(addr / 32);
-    block_range_map[addr & range_mask].insert(&block);
+    block_range_map.Insert(addr, &block);
+  }
+
+  if (m_jit.jo.code_write_protection)
+  {
+    auto& memory = m_jit.m_system.GetMemory();
+    bool protected_new_page = false;
+    for (u32 addr : physical_addresses)
+      protected_new_page |= memory.WriteProtectCode(addr);
+
+    // Slow stores don't go through the fastmem views and check for code themselves, except for
+    // the ones using a cached translation.
+    if (protected_new_page)
+      m_jit.m_mmu.InvalidateTranslationCache();
   }
 
   if (block_link)
   {
     for (const auto& e : block.linkData)
     {
-      links_to[e.exitAddress].insert(&block);
+      links_to.Insert(e.exitAddress, &block);
     }
 
     LinkBlock(block);
@@ -177,12 +270,17 @@ JitBlock* JitBaseBlockCache::GetBlockFromStartAddress(u32 addr, CPUEmuFeatureFla
     translated_addr = translated.address;
   }
 
-  auto iter = block_map.equal_range(translated_addr);
-  for (; iter.first != iter.second; iter.first++)
+  std::vector<JitBlock*>* blocks = block_range_map.Find(translated_addr);
+  if (!blocks)
+    return nullptr;
+
+  for (JitBlock* b : *blocks)
   {
-    JitBlock& b = iter.first->second;
-    if (b.effectiveAddress == addr && b.feature_flags == feature_flags)
-      return &b;
+    if (b->physicalAddress == translated_addr && b->effectiveAddress == addr &&
+        b->feature_flags == feature_flags)
+    {
+      return b;
+    }
   }
 
   return nullptr;
@@ -303,6 +401,8 @@ void JitBaseBlockCache::InvalidateICacheInternal(u32 physical_address, u32 addre
         m_jit.js.fifoWriteAddresses.erase(i);
         m_jit.js.pairedQuantizeAddresses.erase(i);
         m_jit.js.noSpeculativeConstantsAddresses.erase(i);
+        m_jit.js.hotBlockAddresses.erase(i);
+        m_jit.js.hotBlockTierUpTicks.erase(i);
       }
     }
   }
@@ -310,53 +410,54 @@ void JitBaseBlockCache::InvalidateICacheInternal(u32 physical_address, u32 addre
 
 void JitBaseBlockCache::ErasePhysicalRange(u32 address, u32 length)
 {
-  // Iterate over all macro blocks which overlap the given range.
-  u32 range_mask = ~(BLOCK_RANGE_MAP_ELEMENTS - 1);
-  auto start = block_range_map.lower_bound(address & range_mask);
-  auto end = block_range_map.lower_bound(address + length);
-  while (start != end)
-  {
-    // Iterate over all blocks in the macro block.
-    auto iter = start->second.begin();
-    while (iter != start->second.end())
-    {
-      JitBlock* block = *iter;
-      if (block->OverlapsPhysicalRange(address, length))
-      {
-        // If the block overlaps, also remove all other occupied slots in the other macro blocks.
-        // This will leak empty macro blocks, but they may be reused or cleared later on.
-        for (u32 addr : block->physical_addresses)
-          if ((addr & range_mask) != start->first)
-            block_range_map[addr & range_mask].erase(block);
-
-        // And remove the block.
-        DestroyBlock(*block);
-        auto block_map_iter = block_map.equal_range(block->physicalAddress);
-        while (block_map_iter.first != block_map_iter.second)
+  if (length == 0)
+    return;
+
+  // Iterate over all ranges which overlap the given addresses.
+  const u32 last_address = address + (length - 1);
+  block_range_map.ForEachRange(
+      address, last_address, [&](u32, std::vector<JitBlock*>& blocks) {
+        size_t i = 0;
+        while (i < blocks.size())
         {
-          if (&block_map_iter.first->second == block)
+          JitBlock* block = blocks[i];
+          if (!block->OverlapsPhysicalRange(address, length))
           {
-            block_map.erase(block_map_iter.first);
-            break;
+            i++;
+            continue;
           }
-          block_map_iter.first++;
+
+          // Removing the block from all ranges moves another block into slot i of this range.
+          RemoveBlockFromRanges(*block);
+          DestroyBlock(*block);
+          m_free_blocks.push_back(block);
         }
-        iter = start->second.erase(iter);
-      }
-      else
-      {
-        iter++;
-      }
-    }
+      });
+}
 
-    // If the macro block is empty, drop it.
-    if (start->second.empty())
-      start = block_range_map.erase(start);
-    else
-      start++;
+void JitBaseBlockCache::EraseBlocks(const std::function<bool(const JitBlock&)>& predicate)
+{
+  std::vector<JitBlock*> erased_blocks;
+  ForEachBlock([&](JitBlock& block) {
+    if (predicate(block))
+      erased_blocks.push_back(&block);
+  });
+
+  for (JitBlock* block : erased_blocks)
+  {
+    RemoveBlockFromRanges(*block);
+    DestroyBlock(*block);
+    m_free_blocks.push_back(block);
   }
 }
 
+void JitBaseBlockCache::RemoveBlockFromRanges(JitBlock& block)
+{
+  block_range_map.Erase(block.physicalAddress, &block);
+  for (u32 addr : block.physical_addresses)
+    block_range_map.Erase(addr, &block);
+}
+
 u32* JitBaseBlockCache::GetBlockBitSet() const
 {
   return valid_block.m_valid_block.get();
@@ -391,14 +492,24 @@ void JitBaseBlockCache::LinkBlockExits(JitBlock& block)
 void JitBaseBlockCache::LinkBlock(JitBlock& block)
 {
   LinkBlockExits(block);
-  const auto it = links_to.find(block.effectiveAddress);
-  if (it == links_to.end())
+  std::vector<JitBlock*>* source_blocks = links_to.Find(block.effectiveAddress);
+  if (!source_blocks)
     return;
 
-  for (JitBlock* b2 : it->second)
+  // links_to is grouped by ranges, so only link the exits which actually point to this block.
+  for (JitBlock* b2 : *source_blocks)
   {
-    if (block.feature_flags == b2->feature_flags)
-      LinkBlockExits(*b2);
+    if (block.feature_flags != b2->feature_flags)
+      continue;
+
+    for (auto& e : b2->linkData)
+    {
+      if (!e.linkStatus && e.exitAddress == block.effectiveAddress)
+      {
+        WriteLinkBlock(e, &block);
+        e.linkStatus = true;
+      }
+    }
   }
 }
 
@@ -411,10 +522,10 @@ void JitBaseBlockCache::UnlinkBlock(const JitBlock& block)
   }
 
   // Unlink all exits of other blocks which points to this block
-  const auto it = links_to.find(block.effectiveAddress);
-  if (it == links_to.end())
+  std::vector<JitBlock*>* source_blocks = links_to.Find(block.effectiveAddress);
+  if (!source_blocks)
     return;
-  for (JitBlock* sourceBlock : it->second)
+  for (JitBlock* sourceBlock : *source_blocks)
   {
     if (sourceBlock->feature_flags != block.feature_flags)
       continue;
@@ -451,14 +562,7 @@ void JitBaseBlockCache::DestroyBlock(JitBlock& block)
 
   // Delete linking addresses
   for (const auto& e : block.linkData)
-  {
-    auto it = links_to.find(e.exitAddress);
-    if (it == links_to.end())
-      continue;
-    it->second.erase(&block);
-    if (it->second.empty())
-      links_to.erase(it);
-  }
+    links_to.Erase(e.exitAddress, &block);
 
   // Raise an signal if we are going to call this block again
   WriteDestroyBlock(block);
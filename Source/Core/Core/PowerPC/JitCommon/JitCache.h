@@ -6,13 +6,11 @@
 #include <array>
 #include <bitset>
 #include <cstring>
+#include <deque>
 #include <functional>
-#include <map>
 #include <memory>
 #include <set>
 #include <type_traits>
-#include <unordered_map>
-#include <unordered_set>
 #include <vector>
 
 #include "Common/CommonTypes.h"
@@ -39,7 +37,7 @@ struct JitBlockData
   // The effective address (PC) for the beginning of the block.
   u32 effectiveAddress;
   // The physical address of the code represented by this block.
-  // Various maps in the cache are indexed by this (block_map
+  // Various maps in the cache are indexed by this (block_range_map
   // and valid_block in particular). This is useful because of
   // of the way the instruction cache works on PowerPC.
   u32 physicalAddress;
@@ -80,8 +78,8 @@ struct JitBlock : public JitBlockData
   };
   std::vector<LinkData> linkData;
 
-  // This set stores all physical addresses of all occupied instructions.
-  std::set<u32> physical_addresses;
+  // The physical addresses of all occupied instructions, sorted in ascending order.
+  std::vector<u32> physical_addresses;
 
   // Block profiling data, structure is inlined in Jit.cpp
   struct ProfileData
@@ -92,6 +90,18 @@ struct JitBlock : public JitBlockData
     u64 ticStart;
     u64 ticStop;
   } profile_data = {};
+
+  // Number of remaining runs before this block gets recompiled as a hot block.
+  // Only used when tiered compilation is enabled.
+  u32 hot_countdown = 0;
+
+  // Emulated ticks at which this block was compiled, and for hot blocks, how many ticks their
+  // cold version took to count down its runs. Only used when tiered compilation is enabled.
+  u64 compile_ticks = 0;
+  u64 tier_up_ticks = 0;
+
+  // How long analyzing and compiling this block took.
+  u32 compile_time_ns = 0;
 };
 
 typedef void (*CompiledCode)();
@@ -126,6 +136,58 @@ public:
   bool Test(u32 bit) const { return (m_valid_block[bit / 32] & (1u << (bit % 32))) != 0; }
 };
 
+// Associates blocks with the ranges of the 32-bit address space they belong to.
+//
+// This replaces a map of sets: the block lists of 2^RANGE_SHIFT byte ranges are stored in flat
+// arrays, which are allocated lazily per page of ranges. A lookup is two array accesses, and the
+// blocks of a range are stored contiguously.
+class BlockRangeTable final
+{
+public:
+  static constexpr u32 RANGE_SHIFT = 8;
+  static constexpr u32 PAGE_SHIFT = 20;
+  static constexpr u32 RANGES_PER_PAGE = 1u << (PAGE_SHIFT - RANGE_SHIFT);
+  static constexpr u32 NUM_PAGES = 1u << (32 - PAGE_SHIFT);
+
+  // Returns the blocks of the range containing the given address, or nullptr if there are none.
+  std::vector<JitBlock*>* Find(u32 address);
+  // Adds the block to the range containing the given address, unless it is already in there.
+  void Insert(u32 address, JitBlock* block);
+  // Removes the block from the range containing the given address. The order of the remaining
+  // blocks in that range is not preserved.
+  void Erase(u32 address, JitBlock* block);
+  void Clear();
+
+  // Calls f(range_start, blocks) for every non-empty range overlapping the addresses first to last
+  // (inclusive). f may erase blocks from any range.
+  template <typename Func>
+  void ForEachRange(u32 first, u32 last, Func f)
+  {
+    constexpr u32 range_page_shift = PAGE_SHIFT - RANGE_SHIFT;
+    const u32 last_range = last >> RANGE_SHIFT;
+    u32 range = first >> RANGE_SHIFT;
+    while (range <= last_range)
+    {
+      const std::unique_ptr<Page>& page = m_pages[range >> range_page_shift];
+      if (!page)
+      {
+        range = ((range >> range_page_shift) + 1) << range_page_shift;
+        continue;
+      }
+
+      std::vector<JitBlock*>& blocks = (*page)[range & (RANGES_PER_PAGE - 1)];
+      if (!blocks.empty())
+        f(range << RANGE_SHIFT, blocks);
+      range++;
+    }
+  }
+
+private:
+  using Page = std::array<std::vector<JitBlock*>, RANGES_PER_PAGE>;
+
+  std::array<std::unique_ptr<Page>, NUM_PAGES> m_pages;
+};
+
 class JitBaseBlockCache
 {
 public:
@@ -150,6 +212,8 @@ public:
 
   JitBlock* AllocateBlock(u32 em_address);
   void FinalizeBlock(JitBlock& block, bool block_link, const std::set<u32>& physical_addresses);
+  // Returns a block which was allocated but never finalized, e.g. because compiling it failed.
+  void DiscardBlock(JitBlock& block);
 
   // Look for the block in the slow but accurate way.
   // This function shall be used if FastLookupIndexForAddress() failed.
@@ -165,6 +229,8 @@ public:
   void InvalidateICache(u32 address, u32 length, bool forced);
   void InvalidateICacheLine(u32 address);
   void ErasePhysicalRange(u32 address, u32 length);
+  // Destroys all blocks for which the predicate returns true.
+  void EraseBlocks(const std::function<bool(const JitBlock&)>& predicate);
 
   u32* GetBlockBitSet() const;
 
@@ -184,22 +250,27 @@ private:
 
   JitBlock* MoveBlockIntoFastCache(u32 em_address, CPUEmuFeatureFlags feature_flags);
 
+  void RemoveBlockFromRanges(JitBlock& block);
+  // Calls f once for every block, even if it spans several ranges.
+  template <typename Func>
+  void ForEachBlock(Func f);
+
   // Fast but risky block lookup based on fast_block_map.
   size_t FastLookupIndexForAddress(u32 address, u32 msr);
 
-  // links_to hold all exit points of all valid blocks in a reverse way.
-  // It is used to query all blocks which links to an address.
-  std::unordered_map<u32, std::unordered_set<JitBlock*>> links_to;  // destination_PC -> number
+  // links_to hold all exit points of all valid blocks in a reverse way, indexed by the effective
+  // address of the destination. It is used to query all blocks which links to an address.
+  BlockRangeTable links_to;
 
-  // Map indexed by the physical address of the entry point.
-  // This is used to query the block based on the current PC in a slow way.
-  std::multimap<u32, JitBlock> block_map;  // start_addr -> block
+  // Blocks indexed by all physical addresses they occupy, including the one of the entry point.
+  // This is used for invalidation of memory regions and to query the block based on the current PC
+  // in a slow way.
+  BlockRangeTable block_range_map;
 
-  // Range of overlapping code indexed by a masked physical address.
-  // This is used for invalidation of memory regions. The range is grouped
-  // in macro blocks of each 0x100 bytes.
-  static constexpr u32 BLOCK_RANGE_MAP_ELEMENTS = 0x100;
-  std::map<u32, std::unordered_set<JitBlock*>> block_range_map;
+  // Storage of all blocks. Compiled code refers to its block, so blocks never move in memory.
+  // Destroyed blocks are kept in m_free_blocks to be reused by later allocations.
+  std::deque<JitBlock> m_block_pool;
+  std::vector<JitBlock*> m_free_blocks;
 
   // This bitsets shows which cachelines overlap with any blocks.
   // It is used to provide a fast way to query if no icache invalidation is needed.
@@ -0,0 +1,114 @@
+// Copyright 2026 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "Core/PowerPC/JitCommon/JitDiskCache.h"
+
+#include <tuple>
+
+#include <xxhash.h>
+
+#include "Common/CommonPaths.h"
+#include "Common/FileUtil.h"
+#include "Common/Logging/Log.h"
+
+bool JitDiskCache::Key::operator<(const Key& other) const
+{
+  return std::tie(effective_address, feature_flags, code_hash) <
+         std::tie(other.effective_address, other.feature_flags, other.code_hash);
+}
+
+class JitDiskCache::Reader final : public Common::LinearDiskCacheReader<Key, u8>
+{
+public:
+  explicit Reader(JitDiskCache& cache) : m_cache(cache) {}
+
+  void Read(const Key& key, const u8* value, u32 value_size) override
+  {
+    if (m_cache.m_known_entries.insert(key).second)
+      m_cache.m_pending_entries.insert(key);
+  }
+
+private:
+  JitDiskCache& m_cache;
+};
+
+JitDiskCache::JitDiskCache() : m_hash_state(XXH3_createState())
+{
+}
+
+JitDiskCache::~JitDiskCache()
+{
+  Close();
+  XXH3_freeState(m_hash_state);
+}
+
+void JitDiskCache::SetGameID(const std::string& game_id)
+{
+  if (game_id == m_game_id)
+    return;
+
+  Close();
+  if (game_id.empty())
+    return;
+
+  const std::string directory = File::GetUserPath(D_CACHE_IDX) + "JIT" DIR_SEP;
+  if (!File::Exists(directory))
+    File::CreateDir(directory);
+
+  const std::string filename = directory + game_id + ".jbc";
+  Reader reader(*this);
+  const u32 count = m_file.OpenAndRead(filename, reader);
+  INFO_LOG_FMT(DYNA_REC, "Loaded {} cached JIT blocks from {}", count, filename);
+
+  m_game_id = game_id;
+}
+
+void JitDiskCache::Close()
+{
+  if (!IsOpen())
+    return;
+
+  m_file.Sync();
+  m_file.Close();
+  m_known_entries.clear();
+  m_pending_entries.clear();
+  m_game_id.clear();
+}
+
+bool JitDiskCache::HasEntry(u32 effective_address, u32 feature_flags) const
+{
+  const auto it = m_pending_entries.lower_bound({effective_address, feature_flags, 0});
+  return it != m_pending_entries.end() && it->effective_address == effective_address &&
+         it->feature_flags == feature_flags;
+}
+
+bool JitDiskCache::TakeEntry(u32 effective_address, u32 feature_flags, u64 code_hash)
+{
+  const bool found = m_pending_entries.contains({effective_address, feature_flags, code_hash});
+  const auto first = m_pending_entries.lower_bound({effective_address, feature_flags, 0});
+  const auto last = m_pending_entries.upper_bound({effective_address, feature_flags, UINT64_MAX});
+  m_pending_entries.erase(first, last);
+  return found;
+}
+
+void JitDiskCache::RecordBlock(u32 effective_address, u32 feature_flags, u64 code_hash)
+{
+  if (!IsOpen())
+    return;
+
+  const Key key{effective_address, feature_flags, code_hash};
+  if (m_known_entries.insert(key).second)
+    m_file.Append(key, nullptr, 0);
+}
+
+u64 JitDiskCache::HashCodeBlock(const PPCAnalyst::CodeBlock& code_block,
+                                const PPCAnalyst::CodeBuffer& code_buffer, u32 feature_flags)
+{
+  XXH3_64bits_reset_withSeed(m_hash_state, feature_flags);
+  for (u32 i = 0; i < code_block.m_num_instructions; i++)
+  {
+    const u32 op[] = {code_buffer[i].address, code_buffer[i].inst.hex};
+    XXH3_64bits_update(m_hash_state, op, sizeof(op));
+  }
+  return XXH3_64bits_digest(m_hash_state);
+}
@@ -0,0 +1,72 @@
+// Copyright 2026 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <set>
+#include <string>
+
+#include "Common/CommonTypes.h"
+#include "Common/LinearDiskCache.h"
+#include "Core/PowerPC/PPCAnalyst.h"
+
+struct XXH3_state_s;
+
+// A prefetch list of the blocks a title had to compile in previous sessions. With deferred
+// compilation, these blocks are compiled the first time execution reaches them, instead of being
+// run through the interpreter a few times first.
+//
+// Host code isn't stored: it contains absolute pointers into the emulator's address space (and
+// rel32 calls into the Dolphin binary), so it can't be reused across runs. Instead, every entry is
+// keyed by the block's effective address, the CPUEmuFeatureFlags it was compiled with and a hash
+// of the analyzed guest instructions. An entry is only used if the guest code currently in memory
+// produces the same hash, so stale entries (overlays, different revisions) are simply skipped.
+class JitDiskCache
+{
+public:
+  struct Key
+  {
+    u32 effective_address;
+    u32 feature_flags;
+    u64 code_hash;
+
+    bool operator<(const Key& other) const;
+  };
+
+  JitDiskCache();
+  ~JitDiskCache();
+
+  // Opens the cache file belonging to the given title, closing the previous one if needed.
+  // Passing an empty game ID closes the cache.
+  void SetGameID(const std::string& game_id);
+  void Close();
+
+  bool IsOpen() const { return !m_game_id.empty(); }
+
+  // Whether a block at the given address was compiled with the given feature flags in a previous
+  // session, and hasn't been taken yet.
+  bool HasEntry(u32 effective_address, u32 feature_flags) const;
+  // Forgets the entries for the given address and feature flags. Returns whether one of them was
+  // for the same guest code, i.e. has the given hash.
+  bool TakeEntry(u32 effective_address, u32 feature_flags, u64 code_hash);
+
+  // Appends a newly compiled block to the cache file, unless it is already in there.
+  void RecordBlock(u32 effective_address, u32 feature_flags, u64 code_hash);
+
+  u64 HashCodeBlock(const PPCAnalyst::CodeBlock& code_block,
+                    const PPCAnalyst::CodeBuffer& code_buffer, u32 feature_flags);
+
+private:
+  class Reader;
+
+  std::string m_game_id;
+  Common::LinearDiskCache<Key, u8> m_file;
+
+  // Every entry that is in the cache file, used to avoid writing duplicates.
+  std::set<Key> m_known_entries;
+  // Entries from previous sessions which haven't been taken yet.
+  std::set<Key> m_pending_entries;
+
+  // Reused for every block that gets hashed.
+  XXH3_state_s* m_hash_state;
+};
@@ -0,0 +1,41 @@
+// Copyright 2026 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "Core/PowerPC/JitCommon/JitStatistics.h"
+
+#include <picojson.h>
+
+static picojson::value ToJSONValue(u64 value)
+{
+  return picojson::value(static_cast<double>(value));
+}
+
+static picojson::value ToJSONValue(const JitStatistics::CodeRegion& region)
+{
+  picojson::object object;
+  object.emplace("used", ToJSONValue(region.used));
+  object.emplace("size", ToJSONValue(region.size));
+  return picojson::value(object);
+}
+
+std::string JitStatistics::ToJSON() const
+{
+  picojson::object object;
+  object.emplace("blocks_compiled", ToJSONValue(blocks_compiled));
+  object.emplace("instructions_compiled", ToJSONValue(instructions_compiled));
+  object.emplace("compile_time_ns", ToJSONValue(compile_time_ns));
+  object.emplace("max_block_compile_time_ns", ToJSONValue(max_block_compile_time_ns));
+  object.emplace("near_code_bytes", ToJSONValue(near_code_bytes));
+  object.emplace("far_code_bytes", ToJSONValue(far_code_bytes));
+  object.emplace("max_block_code_size", ToJSONValue(max_block_code_size));
+  object.emplace("cache_clears", ToJSONValue(cache_clears));
+  object.emplace("code_space_evictions", ToJSONValue(code_space_evictions));
+  object.emplace("fastmem_backpatches", ToJSONValue(fastmem_backpatches));
+  object.emplace("code_write_faults", ToJSONValue(code_write_faults));
+  object.emplace("live_blocks", ToJSONValue(live_blocks));
+  object.emplace("near_code", ToJSONValue(near_code));
+  object.emplace("far_code", ToJSONValue(far_code));
+  object.emplace("constant_pool", ToJSONValue(constant_pool));
+  object.emplace("trampolines", ToJSONValue(trampolines));
+  return picojson::value(object).serialize(true);
+}
@@ -0,0 +1,51 @@
+// Copyright 2026 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <string>
+
+#include "Common/CommonTypes.h"
+
+// Counters describing the work done by a JIT. They are only updated on the CPU thread when a block
+// gets compiled, the code cache gets cleared or a fastmem access has to be backpatched, all of
+// which are rare compared to running code, so they are always collected.
+struct JitStatistics
+{
+  struct CodeRegion
+  {
+    u64 used = 0;
+    u64 size = 0;
+  };
+
+  // Totals since the JIT was initialized.
+  u64 blocks_compiled = 0;
+  u64 instructions_compiled = 0;
+  u64 compile_time_ns = 0;
+  u64 max_block_compile_time_ns = 0;
+  u64 near_code_bytes = 0;
+  u64 far_code_bytes = 0;
+  u64 max_block_code_size = 0;
+  u64 cache_clears = 0;
+  u64 code_space_evictions = 0;
+  u64 fastmem_backpatches = 0;
+  u64 code_write_faults = 0;
+
+  // The current state of the code cache. Regions the JIT doesn't have are left empty.
+  u64 live_blocks = 0;
+  CodeRegion near_code;
+  CodeRegion far_code;
+  CodeRegion constant_pool;
+  CodeRegion trampolines;
+
+  std::string ToJSON() const;
+};
+
+struct JitBlockStatistics
+{
+  u32 effective_address;
+  u32 instructions;
+  u32 near_code_size;
+  u32 far_code_size;
+  u32 compile_time_ns;
+};
@@ -19,6 +19,7 @@
 #include "Common/Assert.h"
 #include "Common/ChunkFile.h"
 #include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
 #include "Common/IOFile.h"
 #include "Common/MsgHandler.h"
 
@@ -178,6 +179,40 @@ void JitInterface::GetProfileResults(Profiler::ProfileStats* prof_stats) const
   });
 }
 
+JitStatistics JitInterface::GetStatistics() const
+{
+  JitStatistics statistics;
+  if (!m_jit)
+    return statistics;
+
+  Core::RunAsCPUThread([this, &statistics] { statistics = m_jit->GetStatistics(); });
+  return statistics;
+}
+
+std::vector<JitBlockStatistics> JitInterface::GetBlockStatistics() const
+{
+  std::vector<JitBlockStatistics> block_statistics;
+  if (!m_jit)
+    return block_statistics;
+
+  Core::RunAsCPUThread([this, &block_statistics] {
+    m_jit->GetBlockCache()->RunOnBlocks([&block_statistics](const JitBlock& block) {
+      block_statistics.push_back({block.effectiveAddress, block.originalSize, block.codeSize,
+                                  static_cast<u32>(block.far_end - block.far_begin),
+                                  block.compile_time_ns});
+    });
+  });
+  return block_statistics;
+}
+
+bool JitInterface::WriteStatistics(const std::string& filename) const
+{
+  if (!m_jit)
+    return false;
+
+  return File::WriteStringToFile(filename, GetStatistics().ToJSON());
+}
+
 std::variant<JitInterface::GetHostCodeError, JitInterface::GetHostCodeResult>
 JitInterface::GetHostCode(u32 address) const
 {
@@ -281,6 +316,12 @@ void JitInterface::InvalidateICacheLines(u32 address, u32 count)
     InvalidateICache(address & ~0x1f, 32 * count, false);
 }
 
+void JitInterface::InvalidateOverwrittenCode(u32 physical_address, u32 size)
+{
+  if (m_jit)
+    m_jit->GetBlockCache()->ErasePhysicalRange(physical_address, size);
+}
+
 void JitInterface::InvalidateICacheLineFromJIT(JitInterface& jit_interface, u32 address)
 {
   jit_interface.InvalidateICacheLine(address);
@@ -309,6 +350,9 @@ void JitInterface::CompileExceptionCheck(ExceptionType type)
   case ExceptionType::SpeculativeConstants:
     exception_addresses = &m_jit->js.noSpeculativeConstantsAddresses;
     break;
+  case ExceptionType::HotBlock:
+    exception_addresses = &m_jit->js.hotBlockAddresses;
+    break;
   }
 
   auto& ppc_state = m_system.GetPPCState();
@@ -6,9 +6,11 @@
 #include <memory>
 #include <string>
 #include <variant>
+#include <vector>
 
 #include "Common/CommonTypes.h"
 #include "Core/MachineContext.h"
+#include "Core/PowerPC/JitCommon/JitStatistics.h"
 
 class CPUCoreBase;
 class PointerWrap;
@@ -65,6 +67,10 @@ public:
   void SetProfilingState(ProfilingState state);
   void WriteProfileResults(const std::string& filename) const;
   void GetProfileResults(Profiler::ProfileStats* prof_stats) const;
+  JitStatistics GetStatistics() const;
+  std::vector<JitBlockStatistics> GetBlockStatistics() const;
+  // Writes the aggregate statistics as JSON. Returns false if the file couldn't be written.
+  bool WriteStatistics(const std::string& filename) const;
   std::variant<GetHostCodeError, GetHostCodeResult> GetHostCode(u32 address) const;
 
   // Memory Utilities
@@ -85,12 +91,16 @@ public:
   void InvalidateICacheLines(u32 address, u32 count);
   static void InvalidateICacheLineFromJIT(JitInterface& jit_interface, u32 address);
   static void InvalidateICacheLinesFromJIT(JitInterface& jit_interface, u32 address, u32 count);
+  // Called by stores which wrote to write protected code without faulting, because they didn't
+  // go through the fastmem views.
+  void InvalidateOverwrittenCode(u32 physical_address, u32 size);
 
   enum class ExceptionType
   {
     FIFOWrite,
     PairedQuantize,
-    SpeculativeConstants
+    SpeculativeConstants,
+    HotBlock
   };
   void CompileExceptionCheck(ExceptionType type);
   static void CompileExceptionCheckFromJIT(JitInterface& jit_interface, ExceptionType type);
@@ -170,6 +170,16 @@ T MMU::ReadFromHardware(u32 em_address)
     return static_cast<T>(var);
   }
 
+  if (!never_translate && flag == XCheckTLBFlag::Read && m_ppc_state.msr.DR)
+  {
+    if (const u8* host_address = LookupTranslationCache(m_read_translation_cache, em_address))
+    {
+      T value;
+      std::memcpy(&value, host_address, sizeof(T));
+      return bswap(value);
+    }
+  }
+
   bool wi = false;
 
   if (!never_translate &&
@@ -182,6 +192,8 @@ T MMU::ReadFromHardware(u32 em_address)
         GenerateDSIException(em_address, false);
       return 0;
     }
+    if (flag == XCheckTLBFlag::Read)
+      FillTranslationCache(m_read_translation_cache, em_address, translated_addr);
     em_address = translated_addr.address;
     wi = translated_addr.wi;
   }
@@ -284,6 +296,16 @@ void MMU::WriteToHardware(u32 em_address, const u32 data, const u32 size)
     return;
   }
 
+  if (!never_translate && flag == XCheckTLBFlag::Write && m_ppc_state.msr.DR)
+  {
+    if (u8* host_address = LookupTranslationCache(m_write_translation_cache, em_address))
+    {
+      const u32 swapped_data = Common::swap32(std::rotr(data, size * 8));
+      std::memcpy(host_address, &swapped_data, size);
+      return;
+    }
+  }
+
   bool wi = false;
 
   if (!never_translate && m_ppc_state.msr.DR)
@@ -295,6 +317,8 @@ void MMU::WriteToHardware(u32 em_address, const u32 data, const u32 size)
         GenerateDSIException(em_address, true);
       return;
     }
+    if (flag == XCheckTLBFlag::Write)
+      FillTranslationCache(m_write_translation_cache, em_address, translated_addr);
     em_address = translated_addr.address;
     wi = translated_addr.wi;
   }
@@ -413,6 +437,9 @@ void MMU::WriteToHardware(u32 em_address, const u32 data, const u32 size)
     if (!m_ppc_state.m_enable_dcache || wi || flag != XCheckTLBFlag::Write)
       std::memcpy(&m_memory.GetRAM()[em_address], &swapped_data, size);
 
+    if (m_memory.IsProtectedCode(em_address))
+      m_system.GetJitInterface().InvalidateOverwrittenCode(em_address, size);
+
     return;
   }
 
@@ -430,6 +457,9 @@ void MMU::WriteToHardware(u32 em_address, const u32 data, const u32 size)
     if (!m_ppc_state.m_enable_dcache || wi || flag != XCheckTLBFlag::Write)
       std::memcpy(&m_memory.GetEXRAM()[em_address], &swapped_data, size);
 
+    if (m_memory.IsProtectedCode(em_address + 0x10000000))
+      m_system.GetJitInterface().InvalidateOverwrittenCode(em_address + 0x10000000, size);
+
     return;
   }
 
@@ -1329,6 +1359,8 @@ void MMU::SDRUpdated()
 
   m_ppc_state.pagetable_base = htaborg << 16;
   m_ppc_state.pagetable_hashmask = ((htabmask << 10) | 0x3ff);
+
+  InvalidateTranslationCache();
 }
 
 enum class TLBLookupResult
@@ -1394,20 +1426,23 @@ static TLBLookupResult LookupTLBPageAddress(PowerPC::PowerPCState& ppc_state,
   return TLBLookupResult::NotFound;
 }
 
-static void UpdateTLBEntry(PowerPC::PowerPCState& ppc_state, const XCheckTLBFlag flag, UPTE_Hi pte2,
-                           const u32 address, const u32 vsid)
+// Returns the tag of the entry which got replaced, or INVALID_TAG if none was.
+static u32 UpdateTLBEntry(PowerPC::PowerPCState& ppc_state, const XCheckTLBFlag flag, UPTE_Hi pte2,
+                          const u32 address, const u32 vsid)
 {
   if (IsNoExceptionFlag(flag))
-    return;
+    return TLBEntry::INVALID_TAG;
 
   const u32 tag = address >> HW_PAGE_INDEX_SHIFT;
   TLBEntry& tlbe = ppc_state.tlb[IsOpcodeFlag(flag)][tag & HW_PAGE_INDEX_MASK];
   const u32 index = tlbe.recent == 0 && tlbe.tag[0] != TLBEntry::INVALID_TAG;
+  const u32 replaced_tag = tlbe.tag[index];
   tlbe.recent = index;
   tlbe.paddr[index] = pte2.RPN << HW_PAGE_INDEX_SHIFT;
   tlbe.pte[index] = pte2.Hex;
   tlbe.tag[index] = tag;
   tlbe.vsid[index] = vsid;
+  return replaced_tag;
 }
 
 void MMU::InvalidateTLBEntry(u32 address)
@@ -1416,6 +1451,86 @@ void MMU::InvalidateTLBEntry(u32 address)
 
   m_ppc_state.tlb[0][entry_index].Invalidate();
   m_ppc_state.tlb[1][entry_index].Invalidate();
+
+  InvalidateTranslationCache();
+}
+
+u8* MMU::LookupTranslationCache(TranslationCache& cache, u32 effective_address)
+{
+  const u32 tag = effective_address >> HW_PAGE_INDEX_SHIFT;
+  const TranslationCacheEntry& entry = cache[tag % TRANSLATION_CACHE_SIZE];
+  if (entry.tag != tag || entry.sr != m_ppc_state.sr[effective_address >> 28])
+    return nullptr;
+
+  // Keep the replacement order of the emulated TLB the same as without this cache.
+  if (entry.tlb_way >= 0)
+    m_ppc_state.tlb[0][tag & HW_PAGE_INDEX_MASK].recent = entry.tlb_way;
+
+  return entry.host_page + (effective_address & HW_PAGE_MASK);
+}
+
+void MMU::FillTranslationCache(TranslationCache& cache, u32 effective_address,
+                               const TranslateAddressResult& result)
+{
+  if (m_ppc_state.m_enable_dcache || result.wi)
+    return;
+
+  const u32 physical_page = result.address & ~HW_PAGE_MASK;
+
+  // Stores to write protected code have to go through WriteToHardware to invalidate it.
+  if (&cache == &m_write_translation_cache && m_memory.IsProtectedCode(physical_page))
+    return;
+  u8* host_page;
+  if (m_memory.GetRAM() && (physical_page & 0xF8000000) == 0x00000000)
+  {
+    host_page = &m_memory.GetRAM()[physical_page & m_memory.GetRamMask()];
+  }
+  else if (m_memory.GetEXRAM() && (physical_page >> 28) == 0x1 &&
+           (physical_page & 0x0FFFFFFF) < m_memory.GetExRamSizeReal())
+  {
+    host_page = &m_memory.GetEXRAM()[physical_page & 0x0FFFFFFF];
+  }
+  else
+  {
+    return;
+  }
+
+  const u32 tag = effective_address >> HW_PAGE_INDEX_SHIFT;
+  s32 tlb_way = -1;
+  if (result.result == TranslateAddressResultEnum::PAGE_TABLE_TRANSLATED)
+  {
+    const TLBEntry& tlbe = m_ppc_state.tlb[0][tag & HW_PAGE_INDEX_MASK];
+    for (u32 i = 0; i < TLB_WAYS; i++)
+    {
+      if (tlbe.tag[i] == tag)
+        tlb_way = static_cast<s32>(i);
+    }
+    if (tlb_way < 0)
+      return;
+  }
+
+  TranslationCacheEntry& entry = cache[tag % TRANSLATION_CACHE_SIZE];
+  entry.tag = tag;
+  entry.sr = m_ppc_state.sr[effective_address >> 28];
+  entry.host_page = host_page;
+  entry.tlb_way = tlb_way;
+}
+
+void MMU::InvalidateTranslationCache()
+{
+  m_read_translation_cache.fill({});
+  m_write_translation_cache.fill({});
+}
+
+void MMU::InvalidateTranslationCacheEntry(u32 effective_address)
+{
+  const u32 tag = effective_address >> HW_PAGE_INDEX_SHIFT;
+  for (TranslationCache* cache : {&m_read_translation_cache, &m_write_translation_cache})
+  {
+    TranslationCacheEntry& entry = (*cache)[tag % TRANSLATION_CACHE_SIZE];
+    if (entry.tag == tag)
+      entry = {};
+  }
 }
 
 // Page Address Translation
@@ -1506,7 +1621,11 @@ MMU::TranslateAddressResult MMU::TranslatePageAddress(const EffectiveAddress add
 
         // We already updated the TLB entry if this was caused by a C bit.
         if (res != TLBLookupResult::UpdateC)
-          UpdateTLBEntry(m_ppc_state, flag, pte2, address.Hex, VSID);
+        {
+          const u32 replaced_tag = UpdateTLBEntry(m_ppc_state, flag, pte2, address.Hex, VSID);
+          if (!IsOpcodeFlag(flag) && replaced_tag != TLBEntry::INVALID_TAG)
+            InvalidateTranslationCacheEntry(replaced_tag << HW_PAGE_INDEX_SHIFT);
+        }
 
         *wi = (pte2.WIMG & 0b1100) != 0;
 
@@ -1569,6 +1688,7 @@ void MMU::UpdateBATs(BatTable& bat_table, u32 base_spr)
         // BAT_MAPPED_BIT is whether the translation is valid
         // BAT_PHYSICAL_BIT is whether we can use the fastmem arena
         // BAT_WI_BIT is whether either W or I (of WIMG) is set
+        // BAT_MEMCHECK_BIT is whether the page is in the fastmem arena but overlaps a memcheck
         u32 valid_bit = BAT_MAPPED_BIT;
 
         const bool wi = (batl.WIMG & 0b1100) != 0;
@@ -1600,10 +1720,15 @@ void MMU::UpdateBATs(BatTable& bat_table, u32 base_spr)
           }
         }
 
-        // Fast accesses don't support memchecks, so force slow accesses by removing fastmem
-        // mappings for all overlapping virtual pages.
-        if (m_power_pc.GetMemChecks().OverlapsMemcheck(virtual_address, BAT_PAGE_SIZE))
-          valid_bit &= ~BAT_PHYSICAL_BIT;
+        // Fast accesses don't support memchecks. The page stays mapped in the fastmem arena, but
+        // the host pages containing the watched addresses get protected (see
+        // MemoryManager::UpdateLogicalMemory), and any access the JIT checks against the table
+        // itself takes the slow path.
+        if ((valid_bit & BAT_PHYSICAL_BIT) &&
+            m_power_pc.GetMemChecks().OverlapsMemcheck(virtual_address, BAT_PAGE_SIZE))
+        {
+          valid_bit ^= BAT_PHYSICAL_BIT | BAT_MEMCHECK_BIT;
+        }
 
         // (BEPI | j) == (BEPI & ~BL) | (j & BL).
         bat_table[virtual_address >> BAT_INDEX_SHIFT] = physical_address | valid_bit;
@@ -1623,7 +1748,7 @@ void MMU::UpdateFakeMMUBat(BatTable& bat_table, u32 start_addr)
     u32 flags = BAT_MAPPED_BIT | BAT_PHYSICAL_BIT;
 
     if (m_power_pc.GetMemChecks().OverlapsMemcheck(e_address << BAT_INDEX_SHIFT, BAT_PAGE_SIZE))
-      flags &= ~BAT_PHYSICAL_BIT;
+      flags ^= BAT_PHYSICAL_BIT | BAT_MEMCHECK_BIT;
 
     bat_table[e_address] = p_address | flags;
   }
@@ -1647,6 +1772,8 @@ void MMU::DBATUpdated()
   m_memory.UpdateLogicalMemory(m_dbat_table);
 #endif
 
+  InvalidateTranslationCache();
+
   // IsOptimizable*Address and dcbz depends on the BAT mapping, so we need a flush here.
   m_system.GetJitInterface().ClearSafe();
 }
@@ -64,7 +64,8 @@ constexpr u32 BAT_PAGE_COUNT = 1 << (32 - BAT_INDEX_SHIFT);
 constexpr u32 BAT_MAPPED_BIT = 0x1;
 constexpr u32 BAT_PHYSICAL_BIT = 0x2;
 constexpr u32 BAT_WI_BIT = 0x4;
-constexpr u32 BAT_RESULT_MASK = UINT32_C(~0x7);
+constexpr u32 BAT_MEMCHECK_BIT = 0x8;
+constexpr u32 BAT_RESULT_MASK = UINT32_C(~0xF);
 using BatTable = std::array<u32, BAT_PAGE_COUNT>;  // 128 KB
 
 constexpr size_t HW_PAGE_SIZE = 4096;
@@ -256,6 +257,8 @@ public:
   BatTable& GetIBATTable() { return m_ibat_table; }
   BatTable& GetDBATTable() { return m_dbat_table; }
 
+  void InvalidateTranslationCache();
+
 private:
   enum class TranslateAddressResultEnum : u8
   {
@@ -291,9 +294,33 @@ private:
     explicit EffectiveAddress(u32 address) : Hex{address} {}
   };
 
+  // Direct-mapped cache of recent data translations, consulted by the slow load and store paths
+  // before the BATs and the emulated TLB. Only pages backed by RAM or EXRAM which need neither the
+  // data cache nor write-through handling are cached. Entries remember the segment register they
+  // were translated with, so that segment register writes (some of which happen directly in JIT
+  // code) don't need to invalidate anything.
+  struct TranslationCacheEntry
+  {
+    static constexpr u32 INVALID_TAG = 0xffffffff;
+
+    u32 tag = INVALID_TAG;
+    u32 sr = 0;
+    u8* host_page = nullptr;
+    // The TLB way the translation came from, or -1 for BAT translations.
+    s32 tlb_way = -1;
+  };
+
+  static constexpr u32 TRANSLATION_CACHE_SIZE = 256;
+  using TranslationCache = std::array<TranslationCacheEntry, TRANSLATION_CACHE_SIZE>;
+
   template <const XCheckTLBFlag flag>
   TranslateAddressResult TranslateAddress(u32 address);
 
+  u8* LookupTranslationCache(TranslationCache& cache, u32 effective_address);
+  void FillTranslationCache(TranslationCache& cache, u32 effective_address,
+                            const TranslateAddressResult& result);
+  void InvalidateTranslationCacheEntry(u32 effective_address);
+
   template <const XCheckTLBFlag flag>
   TranslateAddressResult TranslatePageAddress(const EffectiveAddress address, bool* wi);
 
@@ -326,6 +353,11 @@ private:
 
   BatTable m_ibat_table;
   BatTable m_dbat_table;
+
+  // Reads and writes are cached separately, since a write translation is only cached once the
+  // changed bit of its page table entry has been set.
+  TranslationCache m_read_translation_cache;
+  TranslationCache m_write_translation_cache;
 };
 
 void ClearDCacheLineFromJit(MMU& mmu, u32 address);
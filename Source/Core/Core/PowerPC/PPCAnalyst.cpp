@@ -4,9 +4,12 @@
 #include "Core/PowerPC/PPCAnalyst.h"
 
 #include <algorithm>
+#include <future>
 #include <map>
+#include <optional>
 #include <queue>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include <fmt/format.h>
@@ -15,10 +18,12 @@
 #include "Common/CommonTypes.h"
 #include "Common/Logging/Log.h"
 #include "Common/StringUtil.h"
+#include "Common/Swap.h"
 #include "Core/Config/MainSettings.h"
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
 #include "Core/HLE/HLE.h"
+#include "Core/HW/Memmap.h"
 #include "Core/PowerPC/JitCommon/JitBase.h"
 #include "Core/PowerPC/MMU.h"
 #include "Core/PowerPC/PPCSymbolDB.h"
@@ -41,9 +46,6 @@
 
 namespace PPCAnalyst
 {
-// 0 does not perform block merging
-constexpr u32 BRANCH_FOLLOWING_THRESHOLD = 2;
-
 constexpr u32 INVALID_BRANCH_TARGET = 0xFFFFFFFF;
 
 static u32 EvaluateBranchTarget(UGeckoInstruction instr, u32 pc)
@@ -71,22 +73,174 @@ static u32 EvaluateBranchTarget(UGeckoInstruction instr, u32 pc)
   }
 }
 
+namespace
+{
+// Host pointers to the pages of a range of effective addresses. They are looked up on the CPU
+// thread, so that worker threads can then read the instructions in the range without going through
+// the MMU, whose TLB and instruction cache emulation aren't thread safe. Like HostRead_Instruction,
+// this reads memory directly rather than through the instruction cache. Pages that can't be read
+// directly (untranslated addresses, the fake VMEM, ...) are left null and have to be handled on the
+// CPU thread instead.
+class CodeView
+{
+public:
+  static constexpr u32 GUEST_PAGE_SIZE = 0x1000;
+
+  CodeView(const Core::CPUThreadGuard& guard, u32 start_address, u32 end_address)
+      : m_start_address(start_address), m_end_address(end_address),
+        m_first_page(start_address & ~(GUEST_PAGE_SIZE - 1))
+  {
+    auto& system = guard.GetSystem();
+    auto& mmu = system.GetMMU();
+    auto& memory = system.GetMemory();
+
+    for (u32 page = m_first_page; page < end_address && page >= m_first_page;
+         page += GUEST_PAGE_SIZE)
+    {
+      const PowerPC::TryReadInstResult result = mmu.TryReadInstruction(page);
+      m_pages.push_back(result.valid ? GetHostPointer(memory, result.physical_address) : nullptr);
+    }
+  }
+
+  u32 GetStartAddress() const { return m_start_address; }
+  u32 GetEndAddress() const { return m_end_address; }
+  size_t GetPageCount() const { return m_pages.size(); }
+  u32 GetPageAddress(size_t index) const { return m_first_page + u32(index) * GUEST_PAGE_SIZE; }
+
+  bool IsReadable(u32 address) const { return GetPage(address) != nullptr; }
+  u32 Read(u32 address) const
+  {
+    return Common::swap32(GetPage(address) + (address & (GUEST_PAGE_SIZE - 1)));
+  }
+
+private:
+  static const u8* GetHostPointer(Memory::MemoryManager& memory, u32 physical_address)
+  {
+    if (physical_address < memory.GetRamSizeReal())
+      return memory.GetRAM() + physical_address;
+    if (memory.GetEXRAM() && (physical_address >> 28) == 0x1 &&
+        (physical_address & 0x0fffffff) < memory.GetExRamSizeReal())
+    {
+      return memory.GetEXRAM() + (physical_address & 0x0fffffff);
+    }
+    return nullptr;
+  }
+
+  const u8* GetPage(u32 address) const
+  {
+    const size_t index = (address - m_first_page) / GUEST_PAGE_SIZE;
+    if (address - m_start_address >= m_end_address - m_start_address || index >= m_pages.size())
+      return nullptr;
+    return m_pages[index];
+  }
+
+  u32 m_start_address;
+  u32 m_end_address;
+  u32 m_first_page;
+  std::vector<const u8*> m_pages;
+};
+
+// Reads instructions through the MMU. Can only be used on the CPU thread.
+class GuardInstructionReader
+{
+public:
+  explicit GuardInstructionReader(const Core::CPUThreadGuard& guard)
+      : m_guard(guard), m_mmu(guard.GetSystem().GetMMU())
+  {
+  }
+
+  bool IsRAMAddress(u32 address) const
+  {
+    return PowerPC::MMU::HostIsInstructionRAMAddress(m_guard, address);
+  }
+
+  std::optional<u32> Read(u32 address) const
+  {
+    const PowerPC::TryReadInstResult read_result = m_mmu.TryReadInstruction(address);
+    if (!read_result.valid)
+      return std::nullopt;
+    return read_result.hex;
+  }
+
+  u32 ComputeChecksum(u32 start_address, u32 end_address) const
+  {
+    return HashSignatureDB::ComputeCodeChecksum(m_guard, start_address, end_address);
+  }
+
+private:
+  const Core::CPUThreadGuard& m_guard;
+  PowerPC::MMU& m_mmu;
+};
+
+// Reads instructions from a CodeView, and can be used from any thread. Analysis that leaves the
+// view gets flagged so that it can be redone on the CPU thread.
+class ViewInstructionReader
+{
+public:
+  explicit ViewInstructionReader(const CodeView& view) : m_view(view) {}
+
+  bool IsRAMAddress(u32 address)
+  {
+    if (m_view.IsReadable(address))
+      return true;
+    m_left_view = true;
+    return false;
+  }
+
+  std::optional<u32> Read(u32 address) const { return m_view.Read(address); }
+
+  u32 ComputeChecksum(u32 start_address, u32 end_address) const
+  {
+    u32 sum = 0;
+    for (u32 address = start_address; address <= end_address; address += 4)
+      sum = HashSignatureDB::UpdateCodeChecksum(sum, m_view.Read(address));
+    return sum;
+  }
+
+  bool LeftView() const { return m_left_view; }
+
+private:
+  const CodeView& m_view;
+  bool m_left_view = false;
+};
+
+// Splits [0, count) into at most one contiguous chunk per host thread and calls work(begin, end)
+// for each of them in parallel.
+template <typename Work>
+void ParallelForChunks(size_t count, const Work& work)
+{
+  if (count == 0)
+    return;
+
+  const size_t chunk_count = std::clamp<size_t>(std::thread::hardware_concurrency(), 1, count);
+  const size_t chunk_size = (count + chunk_count - 1) / chunk_count;
+
+  std::vector<std::future<void>> futures;
+  for (size_t begin = 0; begin < count; begin += chunk_size)
+  {
+    const size_t end = std::min(begin + chunk_size, count);
+    futures.push_back(std::async(std::launch::async, [&work, begin, end] { work(begin, end); }));
+  }
+  for (std::future<void>& future : futures)
+    future.get();
+}
+}  // namespace
+
 // To find the size of each found function, scan
 // forward until we hit blr or rfi. In the meantime, collect information
 // about which functions this function calls.
 // Also collect which internal branch goes the farthest.
 // If any one goes farther than the blr or rfi, assume that there is more than
 // one blr or rfi, and keep scanning.
-bool AnalyzeFunction(const Core::CPUThreadGuard& guard, u32 startAddr, Common::Symbol& func,
-                     u32 max_size)
+template <typename InstructionReader>
+static bool AnalyzeFunctionWithReader(InstructionReader& reader, u32 startAddr,
+                                      Common::Symbol& func, u32 max_size)
 {
   if (func.name.empty())
     func.Rename(fmt::format("zz_{:08x}_", startAddr));
   if (func.analyzed)
     return true;  // No error, just already did it.
 
-  auto& mmu = guard.GetSystem().GetMMU();
-
   func.calls.clear();
   func.callers.clear();
   func.size = 0;
@@ -97,8 +251,7 @@ bool AnalyzeFunction(const Core::CPUThreadGuard& guard, u32 startAddr, Common::S
   for (u32 addr = startAddr; true; addr += 4)
   {
     func.size += 4;
-    if (func.size >= JitBase::code_buffer_size * 4 ||
-        !PowerPC::MMU::HostIsInstructionRAMAddress(guard, addr))
+    if (func.size >= JitBase::code_buffer_size * 4 || !reader.IsRAMAddress(addr))
     {
       return false;
     }
@@ -108,14 +261,14 @@ bool AnalyzeFunction(const Core::CPUThreadGuard& guard, u32 startAddr, Common::S
       func.address = startAddr;
       func.analyzed = true;
       func.size -= 4;
-      func.hash = HashSignatureDB::ComputeCodeChecksum(guard, startAddr, addr - 4);
+      func.hash = reader.ComputeChecksum(startAddr, addr - 4);
       if (numInternalBranches == 0)
         func.flags |= Common::FFLAG_STRAIGHT;
       return true;
     }
-    const PowerPC::TryReadInstResult read_result = mmu.TryReadInstruction(addr);
-    const UGeckoInstruction instr = read_result.hex;
-    if (read_result.valid && PPCTables::IsValidInstruction(instr, addr))
+    const std::optional<u32> read_result = reader.Read(addr);
+    const UGeckoInstruction instr = read_result.value_or(0);
+    if (read_result && PPCTables::IsValidInstruction(instr, addr))
     {
       // BLR or RFI
       // 4e800021 is blrl, not the end of a function
@@ -130,7 +283,7 @@ bool AnalyzeFunction(const Core::CPUThreadGuard& guard, u32 startAddr, Common::S
         // Let's calc the checksum and get outta here
         func.address = startAddr;
         func.analyzed = true;
-        func.hash = HashSignatureDB::ComputeCodeChecksum(guard, startAddr, addr);
+        func.hash = reader.ComputeChecksum(startAddr, addr);
         if (numInternalBranches == 0)
           func.flags |= Common::FFLAG_STRAIGHT;
         return true;
@@ -176,6 +329,13 @@ bool AnalyzeFunction(const Core::CPUThreadGuard& guard, u32 startAddr, Common::S
   }
 }
 
+bool AnalyzeFunction(const Core::CPUThreadGuard& guard, u32 startAddr, Common::Symbol& func,
+                     u32 max_size)
+{
+  GuardInstructionReader reader(guard);
+  return AnalyzeFunctionWithReader(reader, startAddr, func, max_size);
+}
+
 bool ReanalyzeFunction(const Core::CPUThreadGuard& guard, u32 start_addr, Common::Symbol& func,
                        u32 max_size)
 {
@@ -275,41 +435,90 @@ bool PPCAnalyzer::CanSwapAdjacentOps(const CodeOp& a, const CodeOp& b) const
   return true;
 }
 
+// Returns the target of a bl instruction, or INVALID_BRANCH_TARGET for anything else.
+static u32 GetCallTarget(UGeckoInstruction instr, u32 addr)
+{
+  if (!PPCTables::IsValidInstruction(instr, addr) || instr.OPCD != 18 || !instr.LK)
+    return INVALID_BRANCH_TARGET;
+
+  u32 target = SignExt26(instr.LI << 2);
+  if (!instr.AA)
+    target += addr;
+  return target;
+}
+
 // Most functions that are relevant to analyze should be
 // called by another function. Therefore, let's scan the
 // entire space for bl operations and find what functions
 // get called.
-static void FindFunctionsFromBranches(const Core::CPUThreadGuard& guard, u32 startAddr, u32 endAddr,
-                                      Common::SymbolDB* func_db)
+// Both the scan and the analysis of the called functions are spread across worker threads, only the
+// pages the CodeView can't read directly are handled on the CPU thread.
+static void FindFunctionsFromBranches(const Core::CPUThreadGuard& guard, const CodeView& view,
+                                      PPCSymbolDB* func_db)
 {
+  const u32 start_address = view.GetStartAddress();
+  const u32 end_address = view.GetEndAddress();
+  const auto scan_page = [&](u32 page, const auto& read, std::vector<u32>* targets) {
+    const u32 first_address = std::max(page, start_address);
+    for (u32 addr = first_address; addr - page < CodeView::GUEST_PAGE_SIZE && addr < end_address;
+         addr += 4)
+    {
+      const std::optional<u32> instr = read(addr);
+      const u32 target = instr ? GetCallTarget(*instr, addr) : INVALID_BRANCH_TARGET;
+      if (target != INVALID_BRANCH_TARGET)
+        targets->push_back(target);
+    }
+  };
+
+  std::vector<std::vector<u32>> page_targets(view.GetPageCount());
+  ParallelForChunks(view.GetPageCount(), [&](size_t begin, size_t end) {
+    const auto read = [&](u32 addr) -> std::optional<u32> { return view.Read(addr); };
+    for (size_t i = begin; i < end; ++i)
+    {
+      const u32 page = view.GetPageAddress(i);
+      if (view.IsReadable(std::max(page, start_address)))
+        scan_page(page, read, &page_targets[i]);
+    }
+  });
+
   auto& mmu = guard.GetSystem().GetMMU();
-  for (u32 addr = startAddr; addr < endAddr; addr += 4)
-  {
+  const auto read_mmu = [&](u32 addr) -> std::optional<u32> {
     const PowerPC::TryReadInstResult read_result = mmu.TryReadInstruction(addr);
-    const UGeckoInstruction instr = read_result.hex;
+    return read_result.valid ? std::optional<u32>(read_result.hex) : std::nullopt;
+  };
+  for (size_t i = 0; i < view.GetPageCount(); ++i)
+  {
+    const u32 page = view.GetPageAddress(i);
+    if (!view.IsReadable(std::max(page, start_address)))
+      scan_page(page, read_mmu, &page_targets[i]);
+  }
 
-    if (read_result.valid && PPCTables::IsValidInstruction(instr, addr))
+  std::vector<u32> targets;
+  for (const std::vector<u32>& page : page_targets)
+    targets.insert(targets.end(), page.begin(), page.end());
+  std::sort(targets.begin(), targets.end());
+  targets.erase(std::unique(targets.begin(), targets.end()), targets.end());
+  std::erase_if(targets, [&](u32 target) {
+    return !PowerPC::MMU::HostIsRAMAddress(guard, target) || func_db->Symbols().contains(target);
+  });
+
+  std::vector<Common::Symbol> functions(targets.size());
+  std::vector<u8> left_view(targets.size());
+  ParallelForChunks(targets.size(), [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i)
     {
-      switch (instr.OPCD)
-      {
-      case 18:  // branch instruction
-      {
-        if (instr.LK)  // bl
-        {
-          u32 target = SignExt26(instr.LI << 2);
-          if (!instr.AA)
-            target += addr;
-          if (PowerPC::MMU::HostIsRAMAddress(guard, target))
-          {
-            func_db->AddFunction(guard, target);
-          }
-        }
-      }
-      break;
-      default:
-        break;
-      }
+      ViewInstructionReader reader(view);
+      if (!AnalyzeFunctionWithReader(reader, targets[i], functions[i], 0))
+        left_view[i] = reader.LeftView();
     }
+  });
+
+  for (size_t i = 0; i < targets.size(); ++i)
+  {
+    if (functions[i].analyzed)
+      func_db->AddAnalyzedFunction(std::move(functions[i]));
+    else if (left_view[i])
+      func_db->AddFunction(guard, targets[i]);
   }
 }
 
@@ -390,7 +599,7 @@ void FindFunctions(const Core::CPUThreadGuard& guard, u32 startAddr, u32 endAddr
                    PPCSymbolDB* func_db)
 {
   // Step 1: Find all functions
-  FindFunctionsFromBranches(guard, startAddr, endAddr, func_db);
+  FindFunctionsFromBranches(guard, CodeView(guard, startAddr, endAddr), func_db);
   FindFunctionsFromHandlers(guard, func_db);
   FindFunctionsAfterReturnInstruction(guard, func_db);
 
@@ -731,20 +940,105 @@ void PPCAnalyzer::SetInstructionStats(CodeBlock* block, CodeOp* code,
   }
 }
 
+bool PPCAnalyzer::IsFrequentlyTakenBranch(const CodeOp& op) const
+{
+  // Only plain bcx is supported, bclrx and bcctrx don't have a static target.
+  if (!m_branch_profiles || op.inst.OPCD != 16 || op.inst.LK)
+    return false;
+
+  const auto it = m_branch_profiles->find(op.address);
+  if (it == m_branch_profiles->end())
+    return false;
+
+  const BranchProfile& profile = it->second;
+  const u64 samples = u64{profile.taken} + profile.not_taken;
+  return samples >= m_trace_min_samples && profile.taken >= profile.not_taken;
+}
+
+// System instructions which only read state, and which may therefore appear in polling loops.
+// Time base and decrementer reads are fine too: skipping ahead to the next event advances them.
+static bool IsSideEffectFreeSystemOp(UGeckoInstruction inst)
+{
+  if (inst.OPCD == 19)
+    return inst.SUBOP10 == 150;  // isync
+
+  if (inst.OPCD != 31)
+    return false;
+
+  switch (inst.SUBOP10)
+  {
+  case 19:   // mfcr
+  case 598:  // sync
+    return true;
+  case 339:  // mfspr
+  case 371:  // mftb
+  {
+    const u32 index = (inst.SPRU << 5) | (inst.SPRL & 0x1F);
+    return index == SPR_TL || index == SPR_TU || index == SPR_DEC;
+  }
+  default:
+    return false;
+  }
+}
+
+// Whether the instruction can be repeated without changing anything but registers.
+static bool IsSideEffectFreeOp(UGeckoInstruction inst, const GekkoOPInfo* opinfo)
+{
+  switch (opinfo->type)
+  {
+  case OpType::Integer:
+  case OpType::CR:
+  case OpType::Load:
+  case OpType::LoadFP:
+  case OpType::LoadPS:
+    return true;
+  case OpType::System:
+    return IsSideEffectFreeSystemOp(inst);
+  default:
+    return false;
+  }
+}
+
+bool PPCAnalyzer::IsSideEffectFreeLeafFunction(u32 address) const
+{
+  auto& mmu = Core::System::GetInstance().GetMMU();
+  for (u32 i = 0; i < MAX_INLINED_LEAF_FUNCTION_SIZE; i++, address += 4)
+  {
+    const auto result = mmu.TryReadInstruction(address);
+    if (!result.valid)
+      return false;
+
+    const UGeckoInstruction inst = result.hex;
+
+    // Plain blr
+    if (inst.OPCD == 19 && inst.SUBOP10 == 16 && !inst.LK &&
+        (inst.BO & BO_DONT_DECREMENT_FLAG) && (inst.BO & BO_DONT_CHECK_CONDITION))
+    {
+      return true;
+    }
+
+    if (!IsSideEffectFreeOp(inst, PPCTables::GetOpInfo(inst, address)))
+      return false;
+  }
+  return false;
+}
+
 bool PPCAnalyzer::IsBusyWaitLoop(CodeBlock* block, CodeOp* code, size_t instructions) const
 {
   // Very basic algorithm to detect busy wait loops:
-  //   * It loops to itself and does not contain any other branches.
-  //   * It does not write to memory.
+  //   * It loops to itself and does not use the CTR.
+  //   * It does not write to memory, and only uses instructions which don't have side effects
+  //     other than writing registers: integer and CR arithmetic, loads (which covers polling both
+  //     RAM and MMIO registers) and a few system instructions like sync and time base reads.
   //   * It only reads from registers it wrote to earlier in the loop, or it
-  //     does not write to these registers.
+  //     does not write to these registers. GPRs, FPRs and CR fields are all tracked.
   //
-  // Would benefit a lot from basic inlining support - a lot of the most
-  // used busy loops are DSP register interactions, which are bl/cmp/bne
-  // (with the bl target a pure function that follows the above rules). We
-  // don't detect these at the moment.
-  std::bitset<32> write_disallowed_regs;
-  std::bitset<32> written_regs;
+  // With leaf function inlining, calls to short side effect free functions are inlined by Analyze,
+  // so the common DSP mailbox polling loops (bl/cmp/bne) end up as a single block and can be
+  // detected here as well.
+  BitSet32 write_disallowed_regs, written_regs;
+  BitSet32 write_disallowed_fregs, written_fregs;
+  BitSet8 write_disallowed_crs, written_crs;
   for (size_t i = 0; i <= instructions; ++i)
   {
     if (code[i].opinfo->type == OpType::Branch)
@@ -754,31 +1048,29 @@ bool PPCAnalyzer::IsBusyWaitLoop(CodeBlock* block, CodeOp* code, size_t instruct
       if (code[i].branchTo == block->m_address && i == instructions)
         return true;
     }
-    else if (code[i].opinfo->type != OpType::Integer && code[i].opinfo->type != OpType::Load)
+    else if (!IsSideEffectFreeOp(code[i].inst, code[i].opinfo))
     {
-      // In the future, some subsets of other instruction types might get
-      // supported. Right now, only try loops that have this very
-      // restricted instruction set.
       return false;
     }
     else
     {
-      for (int reg : code[i].regsIn)
-      {
-        if (reg == -1)
-          continue;
-        if (written_regs[reg])
-          continue;
-        write_disallowed_regs[reg] = true;
-      }
-      for (int reg : code[i].regsOut)
+      write_disallowed_regs |= code[i].regsIn & ~written_regs;
+      if (code[i].regsOut & write_disallowed_regs)
+        return false;
+      written_regs |= code[i].regsOut;
+
+      write_disallowed_fregs |= code[i].fregsIn & ~written_fregs;
+      if (code[i].fregOut >= 0)
       {
-        if (reg == -1)
-          continue;
-        if (write_disallowed_regs[reg])
+        if (write_disallowed_fregs[code[i].fregOut])
           return false;
-        written_regs[reg] = true;
+        written_fregs[code[i].fregOut] = true;
       }
+
+      write_disallowed_crs |= code[i].crIn & ~written_crs;
+      if (code[i].crOut & write_disallowed_crs)
+        return false;
+      written_crs |= code[i].crOut;
     }
   }
   return false;
@@ -822,7 +1114,9 @@ u32 PPCAnalyzer::Analyze(u32 address, CodeBlock* block, CodeBuffer* buffer,
   u32 numFollows = 0;
   u32 num_inst = 0;
 
-  const bool enable_follow = m_enable_branch_following;
+  const bool enable_follow = m_enable_branch_following && HasOption(OPTION_BRANCH_FOLLOW);
+  const bool enable_leaf_inline =
+      m_enable_leaf_function_inlining && HasOption(OPTION_LEAF_FUNCTION_INLINE);
 
   auto& mmu = Core::System::GetInstance().GetMMU();
   for (std::size_t i = 0; i < block_size; ++i)
@@ -853,11 +1147,21 @@ u32 PPCAnalyzer::Analyze(u32 address, CodeBlock* block, CodeBuffer* buffer,
 
     bool conditional_continue = false;
 
-    // TODO: Find the optimal value for BRANCH_FOLLOWING_THRESHOLD.
+    // TODO: Find the optimal value for DEFAULT_BRANCH_FOLLOWING_THRESHOLD.
     //       If it is small, the performance will be down.
     //       If it is big, the size of generated code will be big and
     //       cache clearning will happen many times.
-    if (enable_follow && HasOption(OPTION_BRANCH_FOLLOW))
+    if (!enable_follow && enable_leaf_inline && !found_call && inst.OPCD == 18 && inst.LK &&
+        block_size > 1 && IsSideEffectFreeLeafFunction(code[i].branchTo))
+    {
+      // Even without branch following, inline calls to short side effect free functions, so that
+      // polling loops built around them can be detected as idle loops. The matching blr is
+      // followed below, since found_call is only ever set here when branch following is off.
+      follow = true;
+      found_call = true;
+      caller = i;
+    }
+    else if (enable_follow || found_call)
     {
       if (inst.OPCD == 18 && block_size > 1)
       {
@@ -884,7 +1188,7 @@ u32 PPCAnalyzer::Analyze(u32 address, CodeBlock* block, CodeBuffer* buffer,
       {
         code[i].branchTo = code[caller].address + 4;
         if ((inst.BO & BO_DONT_DECREMENT_FLAG) && (inst.BO & BO_DONT_CHECK_CONDITION) &&
-            numFollows < BRANCH_FOLLOWING_THRESHOLD)
+            numFollows < m_branch_following_threshold)
         {
           // bclrx with unconditional branch = return
           // Follow it if we can propagate the LR value of the last CALL instruction.
@@ -944,11 +1248,23 @@ u32 PPCAnalyzer::Analyze(u32 address, CodeBlock* block, CodeBuffer* buffer,
     code[i].branchIsIdleLoop =
         code[i].branchTo == block->m_address && IsBusyWaitLoop(block, code, i);
 
-    if (follow && numFollows < BRANCH_FOLLOWING_THRESHOLD)
+    // Stitch the taken path of frequently taken conditional branches into this block.
+    if (enable_follow && conditional_continue && block_size > 1 && !code[i].branchIsIdleLoop &&
+        IsFrequentlyTakenBranch(code[i]))
+    {
+      follow = true;
+    }
+
+    if (follow && numFollows < m_branch_following_threshold)
     {
       // Follow the unconditional branch.
       numFollows++;
       address = code[i].branchTo;
+      if (conditional_continue)
+      {
+        code[i].branchIsTraced = true;
+        found_call = false;
+      }
     }
     else
     {
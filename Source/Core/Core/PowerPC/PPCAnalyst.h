@@ -6,6 +6,7 @@
 #include <algorithm>
 #include <cstddef>
 #include <set>
+#include <unordered_map>
 #include <vector>
 
 #include "Common/BitSet.h"
@@ -41,6 +42,9 @@ struct CodeOp  // 16B
   bool isBranchTarget = false;
   bool branchUsesCtr = false;
   bool branchIsIdleLoop = false;
+  // Conditional branch whose taken path is continued in this block. The fall-through path becomes
+  // a side exit.
+  bool branchIsTraced = false;
   BitSet8 wantsCR;
   bool wantsFPRF = false;
   bool wantsCA = false;
@@ -98,6 +102,13 @@ struct BlockRegStats
 
 using CodeBuffer = std::vector<CodeOp>;
 
+// How often a conditional branch went either way.
+struct BranchProfile
+{
+  u32 taken = 0;
+  u32 not_taken = 0;
+};
+
 struct CodeBlock
 {
   // Beginning PPC address.
@@ -136,6 +147,13 @@ struct CodeBlock
 class PPCAnalyzer
 {
 public:
+  // The default number of unconditional branches followed within a single block.
+  // 0 does not perform block merging
+  static constexpr u32 DEFAULT_BRANCH_FOLLOWING_THRESHOLD = 2;
+  // The maximum size (including the blr) of side effect free functions which get inlined when
+  // leaf function inlining is enabled.
+  static constexpr u32 MAX_INLINED_LEAF_FUNCTION_SIZE = 8;
+
   enum AnalystOption
   {
     // Conditional branch continuing
@@ -172,6 +190,10 @@ public:
 
     // Reorder cror instructions next to their associated fcmp.
     OPTION_CROR_MERGE = (1 << 6),
+
+    // Inline calls to short side effect free functions, even when other branches aren't followed.
+    // Requires the same JIT support as OPTION_BRANCH_FOLLOW.
+    OPTION_LEAF_FUNCTION_INLINE = (1 << 7),
   };
 
   // Option setting/getting
@@ -180,10 +202,22 @@ public:
   bool HasOption(AnalystOption option) const { return !!(m_options & option); }
   void SetDebuggingEnabled(bool enabled) { m_is_debugging_enabled = enabled; }
   void SetBranchFollowingEnabled(bool enabled) { m_enable_branch_following = enabled; }
+  void SetLeafFunctionInliningEnabled(bool enabled) { m_enable_leaf_function_inlining = enabled; }
   void SetFloatExceptionsEnabled(bool enabled) { m_enable_float_exceptions = enabled; }
   void SetDivByZeroExceptionsEnabled(bool enabled) { m_enable_div_by_zero_exceptions = enabled; }
+  void SetBranchFollowingThreshold(u32 threshold) { m_branch_following_threshold = threshold; }
+  // Conditional branches which have been executed at least min_samples times according to the
+  // given per-address profiles, and which were taken at least as often as not, are followed like
+  // unconditional branches (see CodeOp::branchIsTraced). Passing nullptr disables trace formation.
+  void SetBranchProfiles(const std::unordered_map<u32, BranchProfile>* profiles, u32 min_samples)
+  {
+    m_branch_profiles = profiles;
+    m_trace_min_samples = min_samples;
+  }
   u32 Analyze(u32 address, CodeBlock* block, CodeBuffer* buffer, std::size_t block_size) const;
 
+  bool IsSideEffectFreeLeafFunction(u32 address) const;
+
 private:
   enum class ReorderType
   {
@@ -198,14 +232,19 @@ private:
   void ReorderInstructions(u32 instructions, CodeOp* code) const;
   void SetInstructionStats(CodeBlock* block, CodeOp* code, const GekkoOPInfo* opinfo) const;
   bool IsBusyWaitLoop(CodeBlock* block, CodeOp* code, size_t instructions) const;
+  bool IsFrequentlyTakenBranch(const CodeOp& op) const;
 
   // Options
   u32 m_options = 0;
 
   bool m_is_debugging_enabled = false;
   bool m_enable_branch_following = false;
+  bool m_enable_leaf_function_inlining = false;
   bool m_enable_float_exceptions = false;
   bool m_enable_div_by_zero_exceptions = false;
+  u32 m_branch_following_threshold = DEFAULT_BRANCH_FOLLOWING_THRESHOLD;
+  const std::unordered_map<u32, BranchProfile>* m_branch_profiles = nullptr;
+  u32 m_trace_min_samples = 0;
 };
 
 void FindFunctions(const Core::CPUThreadGuard& guard, u32 startAddr, u32 endAddr,
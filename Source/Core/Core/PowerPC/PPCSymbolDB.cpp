@@ -45,7 +45,16 @@ Common::Symbol* PPCSymbolDB::AddFunction(const Core::CPUThreadGuard& guard, u32
   if (!PPCAnalyst::AnalyzeFunction(guard, start_addr, symbol))
     return nullptr;
 
-  const auto insert = m_functions.emplace(start_addr, std::move(symbol));
+  return AddAnalyzedFunction(std::move(symbol));
+}
+
+Common::Symbol* PPCSymbolDB::AddAnalyzedFunction(Common::Symbol symbol)
+{
+  const u32 address = symbol.address;
+  const auto insert = m_functions.emplace(address, std::move(symbol));
+  if (!insert.second)
+    return nullptr;
+
   Common::Symbol* ptr = &insert.first->second;
   ptr->type = Common::Symbol::Type::Function;
   m_checksum_to_function[ptr->hash].insert(ptr);
@@ -22,6 +22,8 @@ public:
   ~PPCSymbolDB() override;
 
   Common::Symbol* AddFunction(const Core::CPUThreadGuard& guard, u32 start_addr) override;
+  // Adds a function which has already been analyzed, unless its address is already in the list.
+  Common::Symbol* AddAnalyzedFunction(Common::Symbol symbol);
   void AddKnownSymbol(const Core::CPUThreadGuard& guard, u32 startAddr, u32 size,
                       const std::string& name,
                       Common::Symbol::Type type = Common::Symbol::Type::Function);
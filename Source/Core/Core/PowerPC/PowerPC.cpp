@@ -276,6 +276,11 @@ void PowerPCManager::RefreshConfig()
     INFO_LOG_FMT(POWERPC, "Flushing data cache");
     m_ppc_state.dCache.FlushAll();
   }
+
+  // The translation cache only holds pages which can be accessed without going through the data
+  // cache, so its entries depend on whether the data cache is emulated.
+  if (old_enable_dcache != m_ppc_state.m_enable_dcache)
+    m_system.GetMMU().InvalidateTranslationCache();
 }
 
 void PowerPCManager::Init(CPUCore cpu_core)
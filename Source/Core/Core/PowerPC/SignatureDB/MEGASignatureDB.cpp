@@ -124,6 +124,7 @@ MEGASignatureDB::~MEGASignatureDB() = default;
 void MEGASignatureDB::Clear()
 {
   m_signatures.clear();
+  m_signatures_by_size.clear();
 }
 
 bool MEGASignatureDB::Load(const std::string& file_path)
@@ -149,6 +150,13 @@ bool MEGASignatureDB::Load(const std::string& file_path)
       WARN_LOG_FMT(SYMBOLS, "MEGA database failed to parse line {}", i);
     }
   }
+
+  m_signatures_by_size.clear();
+  for (size_t i = 0; i < m_signatures.size(); ++i)
+  {
+    const u32 size = static_cast<u32>(m_signatures[i].code.size() * sizeof(u32));
+    m_signatures_by_size[size].push_back(i);
+  }
   return true;
 }
 
@@ -163,8 +171,13 @@ void MEGASignatureDB::Apply(const Core::CPUThreadGuard& guard, PPCSymbolDB* symb
   for (auto& it : symbol_db->AccessSymbols())
   {
     auto& symbol = it.second;
-    for (const auto& sig : m_signatures)
+    const auto candidates = m_signatures_by_size.find(symbol.size);
+    if (candidates == m_signatures_by_size.end())
+      continue;
+
+    for (const size_t index : candidates->second)
     {
+      const MEGASignature& sig = m_signatures[index];
       if (Compare(guard, symbol.address, symbol.size, sig))
       {
         symbol.name = sig.name;
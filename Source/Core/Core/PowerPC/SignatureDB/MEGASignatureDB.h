@@ -4,6 +4,7 @@
 #pragma once
 
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "Common/CommonTypes.h"
@@ -59,4 +60,7 @@ public:
 
 private:
   std::vector<MEGASignature> m_signatures;
+  // Indices of the signatures by code size in bytes, in load order. A symbol can only match
+  // signatures of its own size, so this avoids comparing it against the whole database.
+  std::unordered_map<u32, std::vector<size_t>> m_signatures_by_size;
 };
@@ -76,6 +76,9 @@ public:
   using FuncDB = std::map<u32, DBFunc>;
 
   static u32 ComputeCodeChecksum(const Core::CPUThreadGuard& guard, u32 offsetStart, u32 offsetEnd);
+  // Adds one instruction to a checksum computed the same way as ComputeCodeChecksum, for callers
+  // which already have the instructions at hand.
+  static u32 UpdateCodeChecksum(u32 sum, u32 opcode);
 
   void Clear() override;
   void List() const override;
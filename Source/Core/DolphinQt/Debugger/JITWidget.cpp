@@ -162,10 +162,12 @@ void JITWidget::Update()
   PPCAnalyst::PPCAnalyzer analyzer;
   analyzer.SetDebuggingEnabled(Config::IsDebuggingEnabled());
   analyzer.SetBranchFollowingEnabled(Config::Get(Config::MAIN_JIT_FOLLOW_BRANCH));
+  analyzer.SetLeafFunctionInliningEnabled(Config::Get(Config::MAIN_JIT_INLINE_LEAF_FUNCTIONS));
   analyzer.SetFloatExceptionsEnabled(Config::Get(Config::MAIN_FLOAT_EXCEPTIONS));
   analyzer.SetDivByZeroExceptionsEnabled(Config::Get(Config::MAIN_DIVIDE_BY_ZERO_EXCEPTIONS));
   analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_CONDITIONAL_CONTINUE);
   analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_BRANCH_FOLLOW);
+  analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_LEAF_FUNCTION_INLINE);
 
   code_block.m_stats = &st;
   code_block.m_gpa = &gpa;
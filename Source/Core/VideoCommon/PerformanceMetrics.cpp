@@ -3,11 +3,16 @@
 
 #include "VideoCommon/PerformanceMetrics.h"
 
+#include <algorithm>
+#include <chrono>
 #include <mutex>
+#include <numeric>
 
 #include <imgui.h>
 #include <implot.h>
 
+#include "Common/Config/Config.h"
+#include "Core/Config/MainSettings.h"
 #include "Core/CoreTiming.h"
 #include "Core/HW/VideoInterface.h"
 #include "Core/System.h"
@@ -22,6 +27,7 @@ void PerformanceMetrics::Reset()
   m_speed_counter.Reset();
 
   m_time_sleeping = DT::zero();
+  m_throttle_jitter.fill(0);
   m_real_times.fill(Clock::now());
   m_cpu_times.fill(Core::System::GetInstance().GetCoreTiming().GetCPUTimePoint(0));
 }
@@ -42,6 +48,16 @@ void PerformanceMetrics::CountThrottleSleep(DT sleep)
   m_time_sleeping += sleep;
 }
 
+void PerformanceMetrics::CountThrottleJitter(DT jitter)
+{
+  const s64 jitter_us = std::chrono::duration_cast<std::chrono::microseconds>(jitter).count();
+  const auto bucket = std::upper_bound(THROTTLE_JITTER_BUCKETS_US.begin(),
+                                       THROTTLE_JITTER_BUCKETS_US.end(), jitter_us);
+
+  std::unique_lock lock(m_time_lock);
+  m_throttle_jitter[bucket - THROTTLE_JITTER_BUCKETS_US.begin()]++;
+}
+
 void PerformanceMetrics::CountPerformanceMarker(Core::System& system, s64 cyclesLate)
 {
   std::unique_lock lock(m_time_lock);
@@ -80,6 +96,12 @@ double PerformanceMetrics::GetLastSpeedDenominator() const
          Core::System::GetInstance().GetVideoInterface().GetTargetRefreshRate();
 }
 
+PerformanceMetrics::ThrottleJitterHistogram PerformanceMetrics::GetThrottleJitterHistogram() const
+{
+  std::shared_lock lock(m_time_lock);
+  return m_throttle_jitter;
+}
+
 void PerformanceMetrics::DrawImGuiStats(const float backbuffer_scale)
 {
   const float bg_alpha = 0.7f;
@@ -209,6 +231,39 @@ void PerformanceMetrics::DrawImGuiStats(const float backbuffer_scale)
     }
   }
 
+  if (g_ActiveConfig.bShowSpeed && Config::Get(Config::MAIN_PRECISE_FRAME_PACING))
+  {
+    // Share of the throttler's wakeups per bucket of how late they were.
+    const ThrottleJitterHistogram jitter = GetThrottleJitterHistogram();
+    const u64 total = std::accumulate(jitter.begin(), jitter.end(), u64{0});
+
+    const float jitter_window_width = 120.f * backbuffer_scale;
+    const float window_height = (12.f + 17.f * jitter.size()) * backbuffer_scale;
+
+    // Position in the top-right corner of the screen.
+    ImGui::SetNextWindowPos(ImVec2(window_x, window_y), ImGuiCond_Always, ImVec2(1.0f, 0.0f));
+    ImGui::SetNextWindowSize(ImVec2(jitter_window_width, window_height));
+    ImGui::SetNextWindowBgAlpha(bg_alpha);
+
+    if (stack_vertically)
+      window_y += window_height + window_padding;
+    else
+      window_x -= jitter_window_width + window_padding;
+
+    if (ImGui::Begin("ThrottleJitter", nullptr, imgui_flags))
+    {
+      for (std::size_t i = 0; i < jitter.size(); i++)
+      {
+        const double percent = total == 0 ? 0.0 : 100.0 * jitter[i] / total;
+        if (i < THROTTLE_JITTER_BUCKETS_US.size())
+          ImGui::Text("<%5uus:%4.0lf%%", THROTTLE_JITTER_BUCKETS_US[i], percent);
+        else
+          ImGui::Text(">%5uus:%4.0lf%%", THROTTLE_JITTER_BUCKETS_US.back(), percent);
+      }
+      ImGui::End();
+    }
+  }
+
   if (g_ActiveConfig.bShowFPS || g_ActiveConfig.bShowFTimes)
   {
     int count = g_ActiveConfig.bShowFPS + 2 * g_ActiveConfig.bShowFTimes;
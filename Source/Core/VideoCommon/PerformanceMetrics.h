@@ -17,6 +17,11 @@ class System;
 class PerformanceMetrics
 {
 public:
+  // Upper bounds of the buckets of the throttle jitter histogram, in microseconds. The last bucket
+  // counts every wakeup later than that.
+  static constexpr std::array<u32, 7> THROTTLE_JITTER_BUCKETS_US{25, 50, 100, 250, 500, 1000, 2000};
+  using ThrottleJitterHistogram = std::array<u64, THROTTLE_JITTER_BUCKETS_US.size() + 1>;
+
   PerformanceMetrics() = default;
   ~PerformanceMetrics() = default;
 
@@ -31,6 +36,8 @@ public:
   void CountVBlank();
 
   void CountThrottleSleep(DT sleep);
+  // How late the throttler woke up compared to its deadline.
+  void CountThrottleJitter(DT jitter);
   void CountPerformanceMarker(Core::System& system, s64 cyclesLate);
 
   // Getter Functions
@@ -41,6 +48,9 @@ public:
 
   double GetLastSpeedDenominator() const;
 
+  // Shown next to the speed when precise frame pacing is enabled.
+  ThrottleJitterHistogram GetThrottleJitterHistogram() const;
+
   // ImGui Functions
   void DrawImGuiStats(const float backbuffer_scale);
 
@@ -57,6 +67,7 @@ private:
   std::array<TimePoint, 256> m_real_times{};
   std::array<TimePoint, 256> m_cpu_times{};
   DT m_time_sleeping{};
+  ThrottleJitterHistogram m_throttle_jitter{};
 };
 
 extern PerformanceMetrics g_perf_metrics;
@@ -0,0 +1,76 @@
+// Copyright 2026 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <gtest/gtest.h>
+#include <array>
+#include <thread>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/MPSCQueue.h"
+
+TEST(MPSCQueue, Simple)
+{
+  Common::MPSCQueue<u32, 16> q;
+
+  EXPECT_TRUE(q.Empty());
+  u32 v;
+  EXPECT_FALSE(q.Pop(v));
+
+  EXPECT_TRUE(q.TryPush(1));
+  EXPECT_FALSE(q.Empty());
+  EXPECT_TRUE(q.Pop(v));
+  EXPECT_EQ(1u, v);
+  EXPECT_TRUE(q.Empty());
+
+  // Test the FIFO order and wrapping around.
+  for (u32 round = 0; round < 10; ++round)
+  {
+    for (u32 i = 0; i < 16; ++i)
+      EXPECT_TRUE(q.TryPush(i));
+    EXPECT_FALSE(q.TryPush(16u));
+    for (u32 i = 0; i < 16; ++i)
+    {
+      EXPECT_TRUE(q.Pop(v));
+      EXPECT_EQ(i, v);
+    }
+    EXPECT_TRUE(q.Empty());
+  }
+}
+
+TEST(MPSCQueue, MultiThreaded)
+{
+  constexpr u32 NUM_PRODUCERS = 4;
+  constexpr u32 NUM_ELEMENTS = 100000;
+  Common::MPSCQueue<u32, 64> q;
+
+  // Each producer pushes its ID in the top bits, so the consumer can check that every producer's
+  // elements arrive in order.
+  auto inserter = [&q](u32 id) {
+    for (u32 i = 0; i < NUM_ELEMENTS; ++i)
+    {
+      while (!q.TryPush(id << 24 | i))
+        std::this_thread::yield();
+    }
+  };
+
+  std::vector<std::thread> inserter_threads;
+  for (u32 id = 0; id < NUM_PRODUCERS; ++id)
+    inserter_threads.emplace_back(inserter, id);
+
+  std::array<u32, NUM_PRODUCERS> next{};
+  for (u32 i = 0; i < NUM_PRODUCERS * NUM_ELEMENTS; ++i)
+  {
+    u32 v;
+    while (!q.Pop(v))
+      std::this_thread::yield();
+    const u32 id = v >> 24;
+    ASSERT_LT(id, NUM_PRODUCERS);
+    EXPECT_EQ(next[id], v & 0xFFFFFF);
+    next[id]++;
+  }
+  EXPECT_TRUE(q.Empty());
+
+  for (std::thread& thread : inserter_threads)
+    thread.join();
+}
@@ -5,8 +5,13 @@
 
 #include <array>
 #include <bitset>
+#include <chrono>
 #include <string>
+#include <vector>
 
+#include <fmt/format.h>
+
+#include "Common/ChunkFile.h"
 #include "Common/Config/Config.h"
 #include "Common/FileUtil.h"
 #include "Core/Config/MainSettings.h"
@@ -327,6 +332,137 @@ TEST(CoreTiming, ScheduleIntoPast)
   AdvanceAndCheck(system, 0, MAX_SLICE_LENGTH, 1000);
 }
 
+// Runs a slice in which no event may fire.
+static void AdvanceAndCheckNone(Core::System& system, int downcount)
+{
+  s_callbacks_ran_flags = 0;
+
+  auto& ppc_state = system.GetPPCState();
+  ppc_state.downcount = 0;
+  system.GetCoreTiming().Advance();
+
+  EXPECT_EQ(0u, s_callbacks_ran_flags.to_ullong());
+  EXPECT_EQ(downcount, ppc_state.downcount);
+}
+
+TEST(CoreTiming, RemoveAndReschedule)
+{
+  auto& system = Core::System::GetInstance();
+
+  ScopeInit guard(system);
+  ASSERT_TRUE(guard.UserDirectoryExists());
+
+  auto& core_timing = system.GetCoreTiming();
+  auto& ppc_state = system.GetPPCState();
+
+  CoreTiming::EventType* cb_a = core_timing.RegisterEvent("callbackA", CallbackTemplate<0>);
+  CoreTiming::EventType* cb_b = core_timing.RegisterEvent("callbackB", CallbackTemplate<1>);
+  CoreTiming::EventType* cb_c = core_timing.RegisterEvent("callbackC", CallbackTemplate<2>);
+  CoreTiming::EventType* cb_d = core_timing.RegisterEvent("callbackD", CallbackTemplate<3>);
+
+  // Enter slice 0
+  core_timing.Advance();
+
+  core_timing.ScheduleEvent(300, cb_b, CB_IDS[1]);
+  core_timing.ScheduleEvent(400, cb_c, CB_IDS[2]);
+  core_timing.ScheduleEvent(500, cb_d, CB_IDS[3]);
+  core_timing.ScheduleEvent(100, cb_a, CB_IDS[0]);
+  EXPECT_EQ(100, ppc_state.downcount);
+
+  // Removing the front event doesn't change the current slice, but the next one has to end at the
+  // event which is now at the front.
+  core_timing.RemoveEvent(cb_a);
+  core_timing.ScheduleEvent(200, cb_a, CB_IDS[0]);
+  AdvanceAndCheckNone(system, 100);  // (200 - 100)
+
+  // An event which is cancelled while it isn't at the front stays in the queue for a while. It
+  // must neither fire nor end a slice early, and its replacement must only fire once.
+  core_timing.RemoveEvent(cb_c);
+  core_timing.ScheduleEvent(350, cb_c, CB_IDS[2]);
+  AdvanceAndCheck(system, 0, 100);  // (300 - 200)
+  AdvanceAndCheck(system, 1, 150);  // (450 - 300)
+  AdvanceAndCheck(system, 2, 50);   // (500 - 450)
+  AdvanceAndCheck(system, 3, MAX_SLICE_LENGTH);
+
+  // Removing several events at once compacts the queue.
+  core_timing.ScheduleEvent(100, cb_a, CB_IDS[0]);
+  core_timing.ScheduleEvent(200, cb_b, CB_IDS[1]);
+  core_timing.ScheduleEvent(300, cb_c, CB_IDS[2]);
+  core_timing.RemoveEvent(cb_b);
+  core_timing.RemoveEvent(cb_c);
+  core_timing.ScheduleEvent(200, cb_b, CB_IDS[1]);
+  AdvanceAndCheck(system, 0, 100);
+  AdvanceAndCheck(system, 1, MAX_SLICE_LENGTH);
+
+  // Removing a type which has nothing queued leaves everything else alone.
+  core_timing.ScheduleEvent(100, cb_d, CB_IDS[3]);
+  core_timing.RemoveEvent(cb_c);
+  AdvanceAndCheck(system, 3, MAX_SLICE_LENGTH);
+}
+
+TEST(CoreTiming, SaveStateWithCancelledEvents)
+{
+  auto& system = Core::System::GetInstance();
+
+  ScopeInit guard(system);
+  ASSERT_TRUE(guard.UserDirectoryExists());
+
+  auto& core_timing = system.GetCoreTiming();
+
+  CoreTiming::EventType* cb_a = core_timing.RegisterEvent("callbackA", CallbackTemplate<0>);
+  CoreTiming::EventType* cb_b = core_timing.RegisterEvent("callbackB", CallbackTemplate<1>);
+  CoreTiming::EventType* cb_c = core_timing.RegisterEvent("callbackC", CallbackTemplate<2>);
+  CoreTiming::EventType* cb_d = core_timing.RegisterEvent("callbackD", CallbackTemplate<3>);
+  CoreTiming::EventType* cb_e = core_timing.RegisterEvent("callbackE", CallbackTemplate<4>);
+
+  // Enter slice 0
+  core_timing.Advance();
+
+  core_timing.ScheduleEvent(100, cb_a, CB_IDS[0]);
+  core_timing.ScheduleEvent(200, cb_b, CB_IDS[1]);
+  core_timing.ScheduleEvent(300, cb_c, CB_IDS[2]);
+  core_timing.ScheduleEvent(400, cb_d, CB_IDS[3]);
+  core_timing.ScheduleEvent(500, cb_e, CB_IDS[4]);
+
+  // Leaves a cancelled event in the middle of the queue.
+  core_timing.RemoveEvent(cb_c);
+  core_timing.ScheduleEvent(350, cb_c, CB_IDS[2]);
+
+  std::vector<u8> buffer;
+  {
+    u8* ptr = nullptr;
+    PointerWrap p_measure(&ptr, 0, PointerWrap::Mode::Measure);
+    core_timing.DoState(p_measure);
+    const size_t buffer_size = reinterpret_cast<size_t>(ptr);
+    buffer.resize(buffer_size);
+
+    ptr = buffer.data();
+    PointerWrap p(&ptr, buffer_size, PointerWrap::Mode::Write);
+    core_timing.DoState(p);
+    ASSERT_TRUE(p.IsWriteMode());
+  }
+
+  // Changes the state, so that loading has to restore it.
+  AdvanceAndCheck(system, 0, 100);
+  core_timing.RemoveEvent(cb_d);
+
+  {
+    u8* ptr = buffer.data();
+    PointerWrap p(&ptr, buffer.size(), PointerWrap::Mode::Read);
+    core_timing.DoState(p);
+    ASSERT_TRUE(p.IsReadMode());
+  }
+
+  // The number of queued events of each type has to be restored for removal to work.
+  core_timing.RemoveEvent(cb_e);
+
+  AdvanceAndCheck(system, 0, 100);  // (200 - 100)
+  AdvanceAndCheck(system, 1, 150);  // (350 - 200)
+  AdvanceAndCheck(system, 2, 50);   // (400 - 350)
+  AdvanceAndCheck(system, 3, MAX_SLICE_LENGTH);
+  AdvanceAndCheckNone(system, MAX_SLICE_LENGTH);
+}
+
 TEST(CoreTiming, Overclocking)
 {
   auto& system = Core::System::GetInstance();
@@ -401,3 +537,139 @@ TEST(CoreTiming, Overclocking)
   Config::SetCurrent(Config::MAIN_OVERCLOCK, 1.0f);
   AdvanceAndCheck(system, 4, MAX_SLICE_LENGTH);
 }
+
+TEST(CoreTiming, EventProfile)
+{
+  auto& system = Core::System::GetInstance();
+
+  ScopeInit guard(system);
+  ASSERT_TRUE(guard.UserDirectoryExists());
+
+  auto& core_timing = system.GetCoreTiming();
+
+  CoreTiming::EventType* cb_a = core_timing.RegisterEvent("callbackA", CallbackTemplate<0>);
+  CoreTiming::EventType* cb_b = core_timing.RegisterEvent("callbackB", CallbackTemplate<1>);
+
+  // Enter slice 0
+  core_timing.Advance();
+
+  // Nothing is recorded while profiling is disabled.
+  core_timing.ScheduleEvent(100, cb_a, CB_IDS[0]);
+  AdvanceAndCheck(system, 0, MAX_SLICE_LENGTH);
+  EXPECT_EQ("", core_timing.GetEventProfileSummary());
+
+  Config::SetCurrent(Config::MAIN_CORE_TIMING_PROFILING, true);
+
+  core_timing.ScheduleEvent(100, cb_a, CB_IDS[0]);
+  core_timing.ScheduleEvent(200, cb_b, CB_IDS[1]);
+
+  AdvanceAndCheck(system, 0, 90, 10, -10);  // (100 - 10)
+  AdvanceAndCheck(system, 1, MAX_SLICE_LENGTH, 50, -50);
+
+  core_timing.ScheduleEvent(100, cb_a, CB_IDS[0]);
+  AdvanceAndCheck(system, 0, MAX_SLICE_LENGTH, 30, -30);
+
+  const std::string summary = core_timing.GetEventProfileSummary();
+  // name : calls host_us avg_host_ns avg_late max_late
+  EXPECT_NE(std::string::npos, summary.find("callbackA : 2 ")) << summary;
+  EXPECT_NE(std::string::npos, summary.find(" 20 30\n")) << summary;
+  EXPECT_NE(std::string::npos, summary.find("callbackB : 1 ")) << summary;
+  EXPECT_NE(std::string::npos, summary.find(" 50 50\n")) << summary;
+
+  core_timing.ResetEventProfile();
+  EXPECT_EQ("", core_timing.GetEventProfileSummary());
+
+  Config::SetCurrent(Config::MAIN_CORE_TIMING_PROFILING, false);
+}
+
+namespace EventQueueBenchmarkTest
+{
+struct PeriodicEvent
+{
+  const char* name;
+  s64 period;
+  CoreTiming::EventType* type = nullptr;
+};
+
+// Roughly the periodic events of a running Wii title, in CPU cycles at 729 MHz.
+static std::array<PeriodicEvent, 6> s_periodic_events{{
+    {"VICallback", 729'000'000 / 60 / 525},
+    {"SICallback", 729'000'000 / 60 / 4},
+    {"AICallback", 729'000'000 / 32000 * 32},
+    {"DSPCallback", 729'000'000 / 32000 * 80},
+    {"IPCHLE", 729'000'000 / 1000},
+    {"DecrementerCallback", 729'000'000 / 100},
+}};
+static u64 s_callbacks = 0;
+
+static void PeriodicCallback(Core::System& system, u64 userdata, s64 lateness)
+{
+  const PeriodicEvent& event = s_periodic_events[userdata];
+  system.GetCoreTiming().ScheduleEvent(event.period - lateness, event.type, userdata);
+  ++s_callbacks;
+}
+
+static void TimerCallback(Core::System& system, u64 userdata, s64 lateness)
+{
+  ++s_callbacks;
+}
+}  // namespace EventQueueBenchmarkTest
+
+// Simulates the event mix of a Wii title: a few periodic hardware events, plus IOS timers which
+// get cancelled and re-armed far more often than they fire.
+// This is a benchmark rather than a test, so it's disabled. Run it with
+// --gtest_also_run_disabled_tests.
+TEST(CoreTiming, DISABLED_EventQueueBenchmark)
+{
+  using namespace EventQueueBenchmarkTest;
+
+  auto& system = Core::System::GetInstance();
+
+  ScopeInit guard(system);
+  ASSERT_TRUE(guard.UserDirectoryExists());
+
+  // Keep Throttle() from sleeping.
+  Config::SetCurrent(Config::MAIN_EMULATION_SPEED, 0.0f);
+
+  auto& core_timing = system.GetCoreTiming();
+  auto& ppc_state = system.GetPPCState();
+
+  for (PeriodicEvent& event : s_periodic_events)
+    event.type = core_timing.RegisterEvent(event.name, PeriodicCallback);
+
+  constexpr size_t NUM_TIMERS = 64;
+  std::array<CoreTiming::EventType*, NUM_TIMERS> timers;
+  for (size_t i = 0; i < NUM_TIMERS; ++i)
+    timers[i] = core_timing.RegisterEvent(fmt::format("IOSTimer{}", i), TimerCallback);
+
+  // Enter slice 0
+  core_timing.Advance();
+
+  for (size_t i = 0; i < s_periodic_events.size(); ++i)
+    core_timing.ScheduleEvent(s_periodic_events[i].period, s_periodic_events[i].type, i);
+
+  constexpr int NUM_ADVANCES = 1'000'000;
+  u32 random = 12345;
+  s_callbacks = 0;
+  const auto start = std::chrono::high_resolution_clock::now();
+  for (int i = 0; i < NUM_ADVANCES; ++i)
+  {
+    random = random * 1103515245 + 12345;
+    CoreTiming::EventType* timer = timers[(random >> 16) % NUM_TIMERS];
+    core_timing.RemoveEvent(timer);
+    core_timing.ScheduleEvent(1000 + (random >> 8) % 2'000'000, timer);
+
+    ppc_state.downcount = 0;
+    core_timing.Advance();
+  }
+  const auto end = std::chrono::high_resolution_clock::now();
+
+  EXPECT_NE(s_callbacks, 0u);
+
+  const auto nanoseconds =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+  fmt::print("event queue timing:\n");
+  fmt::print("{} slices, {} callbacks\n", NUM_ADVANCES, s_callbacks);
+  fmt::print("per slice              {} ns\n", nanoseconds / NUM_ADVANCES);
+  fmt::print("total                  {} ns\n", nanoseconds);
+}
@@ -0,0 +1,801 @@
+// Copyright 2026 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <array>
+#include <initializer_list>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/Config/Config.h"
+#include "Common/FileUtil.h"
+#include "Core/Config/MainSettings.h"
+#include "Core/ConfigManager.h"
+#include "Core/Core.h"
+#include "Core/CoreTiming.h"
+#include "Core/HLE/HLE_Lib.h"
+#include "Core/HW/CPU.h"
+#include "Core/HW/EXI/EXI.h"
+#include "Core/HW/EXI/EXI_Device.h"
+#include "Core/HW/Memmap.h"
+#include "Core/HW/Sram.h"
+#include "Core/PowerPC/Gekko.h"
+#include "Core/PowerPC/Interpreter/Interpreter.h"
+#include "Core/PowerPC/PowerPC.h"
+#include "Core/System.h"
+#include "UICommon/UICommon.h"
+
+#include <gtest/gtest.h>
+
+// Runs the SDK's implementations of the replaced routines through the interpreter, and checks that
+// the native replacements leave memory, the return value, the registers the caller may rely on and
+// FPSCR in the same state.
+
+namespace
+{
+// Physical addresses. The code runs untranslated, as MSR.IR and MSR.DR are off.
+constexpr u32 FUNCTION_ADDRESS = 0x00010000;
+constexpr u32 RETURN_ADDRESS = 0x00011000;
+// The small data area the SDK addresses through r2.
+constexpr u32 CONSTANTS_ADDRESS = 0x00012000;
+constexpr u32 UNIT01_ADDRESS = CONSTANTS_ADDRESS + 8;
+constexpr u32 STACK_ADDRESS = 0x00020000;
+// Spans a page boundary, to cover the page by page host pointer lookups.
+constexpr u32 BUFFER_ADDRESS = 0x00100000;
+constexpr u32 BUFFER_SIZE = 0x2000;
+constexpr u32 PAGE_SIZE = 0x1000;
+
+constexpr u32 MAX_STEPS = 0x100000;
+
+constexpr u32 DForm(u32 opcode, u32 rd, u32 ra, u32 imm)
+{
+  return opcode << 26 | rd << 21 | ra << 16 | (imm & 0xFFFF);
+}
+
+constexpr u32 XForm(u32 opcode, u32 rd, u32 ra, u32 rb, u32 xo, bool rc = false)
+{
+  return opcode << 26 | rd << 21 | ra << 16 | rb << 11 | xo << 1 | u32(rc);
+}
+
+constexpr u32 AForm(u32 xo, u32 frd, u32 fra, u32 frb, u32 frc)
+{
+  return 4u << 26 | frd << 21 | fra << 16 | frb << 11 | frc << 6 | xo << 1;
+}
+
+constexpr u32 ADDI(u32 rd, u32 ra, s16 imm)
+{
+  return DForm(14, rd, ra, static_cast<u16>(imm));
+}
+
+constexpr u32 ADDIS(u32 rd, u32 ra, u16 imm)
+{
+  return DForm(15, rd, ra, imm);
+}
+
+// addic., which is also used as subic.
+constexpr u32 ADDIC_RC(u32 rd, u32 ra, s16 imm)
+{
+  return DForm(13, rd, ra, static_cast<u16>(imm));
+}
+
+constexpr u32 LI(u32 rd, s16 imm)
+{
+  return ADDI(rd, 0, imm);
+}
+
+constexpr u32 ADD(u32 rd, u32 ra, u32 rb)
+{
+  return XForm(31, rd, ra, rb, 266);
+}
+
+// rd = rb - ra
+constexpr u32 SUBF_RC(u32 rd, u32 ra, u32 rb)
+{
+  return XForm(31, rd, ra, rb, 40, true);
+}
+
+constexpr u32 MR(u32 ra, u32 rs)
+{
+  return XForm(31, rs, ra, rs, 444);
+}
+
+constexpr u32 CMPWI(u32 ra, s16 imm)
+{
+  return DForm(11, 0, ra, static_cast<u16>(imm));
+}
+
+constexpr u32 CMPLW(u32 ra, u32 rb)
+{
+  return XForm(31, 0, ra, rb, 32);
+}
+
+constexpr u32 LBZU(u32 rd, u32 ra, s16 offset)
+{
+  return DForm(35, rd, ra, static_cast<u16>(offset));
+}
+
+constexpr u32 STBU(u32 rs, u32 ra, s16 offset)
+{
+  return DForm(39, rs, ra, static_cast<u16>(offset));
+}
+
+constexpr u32 STWU(u32 rs, u32 ra, s16 offset)
+{
+  return DForm(37, rs, ra, static_cast<u16>(offset));
+}
+
+constexpr u32 LFS(u32 frd, u32 ra, s16 offset)
+{
+  return DForm(48, frd, ra, static_cast<u16>(offset));
+}
+
+constexpr u32 LFD(u32 frd, u32 ra, s16 offset)
+{
+  return DForm(50, frd, ra, static_cast<u16>(offset));
+}
+
+constexpr u32 STFD(u32 frs, u32 ra, s16 offset)
+{
+  return DForm(54, frs, ra, static_cast<u16>(offset));
+}
+
+// psq_l and psq_st through GQR0. With w set, they only transfer ps0.
+constexpr u32 PSQ_L(u32 frd, u32 ra, u32 offset, bool w = false)
+{
+  return 56u << 26 | frd << 21 | ra << 16 | u32(w) << 15 | (offset & 0xFFF);
+}
+
+constexpr u32 PSQ_ST(u32 frs, u32 ra, u32 offset, bool w = false)
+{
+  return 60u << 26 | frs << 21 | ra << 16 | u32(w) << 15 | (offset & 0xFFF);
+}
+
+constexpr u32 PS_SUM0(u32 frd, u32 fra, u32 frc, u32 frb)
+{
+  return AForm(10, frd, fra, frb, frc);
+}
+
+constexpr u32 PS_MULS0(u32 frd, u32 fra, u32 frc)
+{
+  return AForm(12, frd, fra, 0, frc);
+}
+
+constexpr u32 PS_MADDS0(u32 frd, u32 fra, u32 frc, u32 frb)
+{
+  return AForm(14, frd, fra, frb, frc);
+}
+
+constexpr u32 PS_MADDS1(u32 frd, u32 fra, u32 frc, u32 frb)
+{
+  return AForm(15, frd, fra, frb, frc);
+}
+
+constexpr u32 PS_MUL(u32 frd, u32 fra, u32 frc)
+{
+  return AForm(25, frd, fra, 0, frc);
+}
+
+constexpr u32 PS_MADD(u32 frd, u32 fra, u32 frc, u32 frb)
+{
+  return AForm(29, frd, fra, frb, frc);
+}
+
+constexpr u32 PS_MERGE01(u32 frd, u32 fra, u32 frb)
+{
+  return 4u << 26 | frd << 21 | fra << 16 | frb << 11 | 560u << 1;
+}
+
+constexpr u32 PS_MERGE10(u32 frd, u32 fra, u32 frb)
+{
+  return 4u << 26 | frd << 21 | fra << 16 | frb << 11 | 592u << 1;
+}
+
+constexpr u32 B(s32 offset)
+{
+  return 18u << 26 | (static_cast<u32>(offset) & 0x03FFFFFC);
+}
+
+// bc on cr0, with BO = 12 (branch if the condition is true) or BO = 4 (branch if it's false).
+constexpr u32 BLT(s32 offset)
+{
+  return 16u << 26 | 12u << 21 | 0u << 16 | (static_cast<u32>(offset) & 0xFFFC);
+}
+
+constexpr u32 BNE(s32 offset)
+{
+  return 16u << 26 | 4u << 21 | 2u << 16 | (static_cast<u32>(offset) & 0xFFFC);
+}
+
+constexpr u32 BLR = 0x4e800020;
+
+// Byte by byte versions of the MSL routines, which copy backwards when the destination comes after
+// the source.
+const std::vector<u32> MEMCPY_CODE{
+    CMPLW(4, 3),         // 0: cmplw r4, r3
+    BLT(40),             // 4: blt 44
+    ADDI(4, 4, -1),      // 8: subi r4, r4, 1
+    ADDI(6, 3, -1),      // 12: subi r6, r3, 1
+    ADDI(5, 5, 1),       // 16: addi r5, r5, 1
+    B(12),               // 20: b 32
+    LBZU(0, 4, 1),       // 24: lbzu r0, 1(r4)
+    STBU(0, 6, 1),       // 28: stbu r0, 1(r6)
+    ADDIC_RC(5, 5, -1),  // 32: subic. r5, r5, 1
+    BNE(-12),            // 36: bne 24
+    BLR,                 // 40
+    ADD(4, 4, 5),        // 44: add r4, r4, r5
+    ADD(6, 3, 5),        // 48: add r6, r3, r5
+    ADDI(5, 5, 1),       // 52: addi r5, r5, 1
+    B(12),               // 56: b 68
+    LBZU(0, 4, -1),      // 60: lbzu r0, -1(r4)
+    STBU(0, 6, -1),      // 64: stbu r0, -1(r6)
+    ADDIC_RC(5, 5, -1),  // 68: subic. r5, r5, 1
+    BNE(-12),            // 72: bne 60
+    BLR,                 // 76
+};
+
+const std::vector<u32> MEMSET_CODE{
+    ADDI(6, 3, -1),      // 0: subi r6, r3, 1
+    ADDI(5, 5, 1),       // 4: addi r5, r5, 1
+    B(8),                // 8: b 16
+    STBU(4, 6, 1),       // 12: stbu r4, 1(r6)
+    ADDIC_RC(5, 5, -1),  // 16: subic. r5, r5, 1
+    BNE(-8),             // 20: bne 12
+    BLR,                 // 24
+};
+
+const std::vector<u32> STRLEN_CODE{
+    ADDI(4, 3, -1),  // 0: subi r4, r3, 1
+    LI(3, -1),       // 4: li r3, -1
+    LBZU(0, 4, 1),   // 8: lbzu r0, 1(r4)
+    ADDI(3, 3, 1),   // 12: addi r3, r3, 1
+    CMPWI(0, 0),     // 16: cmpwi r0, 0
+    BNE(-12),        // 20: bne 8
+    BLR,             // 24
+};
+
+const std::vector<u32> STRCMP_CODE{
+    ADDI(3, 3, -1),    // 0: subi r3, r3, 1
+    ADDI(4, 4, -1),    // 4: subi r4, r4, 1
+    LBZU(5, 3, 1),     // 8: lbzu r5, 1(r3)
+    LBZU(6, 4, 1),     // 12: lbzu r6, 1(r4)
+    SUBF_RC(0, 6, 5),  // 16: subf. r0, r6, r5
+    BNE(12),           // 20: bne 32
+    CMPWI(5, 0),       // 24: cmpwi r5, 0
+    BNE(-20),          // 28: bne 8
+    MR(3, 0),          // 32: mr r3, r0
+    BLR,               // 36
+};
+
+// The MTX routines, as in the SDK.
+const std::vector<u32> PSMTX_IDENTITY_CODE{
+    LFS(0, 2, 0),  // lfs f0, zero(r2)
+    LFS(1, 2, 4),  // lfs f1, one(r2)
+    PSQ_ST(0, 3, 8),
+    PS_MERGE01(2, 0, 1),
+    PSQ_ST(0, 3, 24),
+    PS_MERGE10(1, 1, 0),
+    PSQ_ST(0, 3, 32),
+    PSQ_ST(2, 3, 16),
+    PSQ_ST(1, 3, 0),
+    PSQ_ST(1, 3, 40),
+    BLR,
+};
+
+const std::vector<u32> PSMTX_COPY_CODE{
+    PSQ_L(0, 3, 0),
+    PSQ_ST(0, 4, 0),
+    PSQ_L(1, 3, 8),
+    PSQ_ST(1, 4, 8),
+    PSQ_L(2, 3, 16),
+    PSQ_ST(2, 4, 16),
+    PSQ_L(3, 3, 24),
+    PSQ_ST(3, 4, 24),
+    PSQ_L(4, 3, 32),
+    PSQ_ST(4, 4, 32),
+    PSQ_L(5, 3, 40),
+    PSQ_ST(5, 4, 40),
+    BLR,
+};
+
+const std::vector<u32> PSMTX_CONCAT_CODE{
+    STWU(1, 1, -64),
+    PSQ_L(0, 3, 0),
+    STFD(14, 1, 8),
+    PSQ_L(6, 4, 0),
+    ADDIS(6, 0, UNIT01_ADDRESS >> 16),
+    PSQ_L(7, 4, 8),
+    STFD(15, 1, 16),
+    ADDI(6, 6, UNIT01_ADDRESS & 0xFFFF),
+    STFD(31, 1, 40),
+    PSQ_L(8, 4, 16),
+    PS_MULS0(12, 6, 0),
+    PSQ_L(2, 3, 16),
+    PS_MULS0(13, 7, 0),
+    PSQ_L(31, 6, 0),
+    PS_MULS0(14, 6, 2),
+    PSQ_L(9, 4, 24),
+    PS_MULS0(15, 7, 2),
+    PSQ_L(1, 3, 8),
+    PS_MADDS1(12, 8, 0, 12),
+    PSQ_L(3, 3, 24),
+    PS_MADDS1(14, 8, 2, 14),
+    PSQ_L(10, 4, 32),
+    PS_MADDS1(13, 9, 0, 13),
+    PSQ_L(11, 4, 40),
+    PS_MADDS1(15, 9, 2, 15),
+    PSQ_L(4, 3, 32),
+    PSQ_L(5, 3, 40),
+    PS_MADDS0(12, 10, 1, 12),
+    PS_MADDS0(13, 11, 1, 13),
+    PS_MADDS0(14, 10, 3, 14),
+    PS_MADDS0(15, 11, 3, 15),
+    PSQ_ST(12, 5, 0),
+    PS_MULS0(2, 6, 4),
+    PS_MADDS1(13, 31, 1, 13),
+    PS_MULS0(0, 7, 4),
+    PSQ_ST(14, 5, 16),
+    PS_MADDS1(15, 31, 3, 15),
+    PSQ_ST(13, 5, 8),
+    PS_MADDS1(2, 8, 4, 2),
+    PS_MADDS1(0, 9, 4, 0),
+    PS_MADDS0(2, 10, 5, 2),
+    LFD(14, 1, 8),
+    PSQ_ST(15, 5, 24),
+    PS_MADDS0(0, 11, 5, 0),
+    PSQ_ST(2, 5, 32),
+    PS_MADDS1(0, 31, 5, 0),
+    LFD(15, 1, 16),
+    PSQ_ST(0, 5, 40),
+    LFD(31, 1, 40),
+    ADDI(1, 1, 64),
+    BLR,
+};
+
+const std::vector<u32> PSMTX_MULT_VEC_CODE{
+    PSQ_L(0, 4, 0),
+    PSQ_L(2, 3, 0),
+    PSQ_L(1, 4, 8, true),
+    PS_MUL(4, 2, 0),
+    PSQ_L(3, 3, 8),
+    PS_MADD(5, 3, 1, 4),
+    PSQ_L(8, 3, 16),
+    PS_SUM0(6, 5, 6, 5),
+    PSQ_L(9, 3, 24),
+    PS_MUL(10, 8, 0),
+    PSQ_ST(6, 5, 0, true),
+    PS_MADD(11, 9, 1, 10),
+    PSQ_L(2, 3, 32),
+    PS_SUM0(12, 11, 12, 11),
+    PSQ_L(3, 3, 40),
+    PS_MUL(4, 2, 0),
+    PSQ_ST(12, 5, 4, true),
+    PS_MADD(5, 3, 1, 4),
+    PS_SUM0(6, 5, 6, 5),
+    PSQ_ST(6, 5, 8, true),
+    BLR,
+};
+
+// Single precision values
+constexpr u32 ZERO = 0x00000000;
+constexpr u32 NEGATIVE_ZERO = 0x80000000;
+constexpr u32 ONE = 0x3f800000;
+constexpr u32 MINUS_ONE = 0xbf800000;
+constexpr u32 TWO = 0x40000000;
+constexpr u32 HALF = 0x3f000000;
+constexpr u32 THREE_HALVES = 0x3fc00000;
+constexpr u32 MINUS_FIVE_HALVES = 0xc0200000;
+constexpr u32 THIRD = 0x3eaaaaab;
+constexpr u32 PI = 0x40490fdb;
+constexpr u32 TENTH = 0x3dcccccd;
+constexpr u32 TEN = 0x41200000;
+constexpr u32 HUNDRED = 0x42c80000;
+constexpr u32 LARGE = 0x7f000000;
+constexpr u32 SMALLEST_NORMAL = 0x00800000;
+constexpr u32 DENORMAL = 0x00000001;
+constexpr u32 NEGATIVE_DENORMAL = 0x807fffff;
+constexpr u32 INFINITE = 0x7f800000;
+constexpr u32 QUIET_NAN = 0x7fc00001;
+constexpr u32 SIGNALING_NAN = 0xff800001;
+
+using Matrix = std::array<u32, 12>;
+
+// Three rows of four, as the MTX library stores them.
+constexpr Matrix MATRIX_A{
+    ONE,          THIRD,         TWO,   HALF,               //
+    THREE_HALVES, NEGATIVE_ZERO, THIRD, MINUS_FIVE_HALVES,  //
+    HALF,         TWO,           ONE,   TEN,                //
+};
+constexpr Matrix MATRIX_B{
+    THIRD,     PI,    HALF,    ONE,   //
+    TWO,       THIRD, TEN,     ONE,   //
+    MINUS_ONE, TENTH, HUNDRED, HALF,  //
+};
+// NaNs, denormals, infinities, and products which overflow or underflow.
+constexpr Matrix SPECIAL_MATRIX{
+    QUIET_NAN, SIGNALING_NAN, DENORMAL, NEGATIVE_DENORMAL,  //
+    INFINITE,  NEGATIVE_ZERO, LARGE,    SMALLEST_NORMAL,    //
+    ONE,       THIRD,         ZERO,     HALF,               //
+};
+constexpr Matrix DENORMAL_MATRIX{
+    DENORMAL, NEGATIVE_DENORMAL, SMALLEST_NORMAL, DENORMAL,           //
+    HALF,     DENORMAL,          ONE,             NEGATIVE_DENORMAL,  //
+    DENORMAL, TWO,               DENORMAL,        SMALLEST_NORMAL,    //
+};
+
+// GQR0 set up to transfer signed 16-bit integers, which the MTX routines can't be replaced for.
+constexpr u32 GQR_S16 = QUANTIZE_S16 << 16 | QUANTIZE_S16;
+
+struct State
+{
+  std::array<u32, 32> gpr;
+  std::array<u64, 32> ps0;
+  u32 fpscr;
+  u32 pc;
+  u32 srr0;
+  std::vector<u8> buffer;
+};
+
+using HookFunction = void (*)(const Core::CPUThreadGuard& guard);
+
+class HLELibTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_profile_path = File::CreateTempDir();
+    ASSERT_FALSE(m_profile_path.empty());
+    Core::DeclareAsCPUThread();
+    UICommon::SetUserDirectory(m_profile_path);
+    Config::Init();
+    SConfig::Init();
+    // Memory registers the MMIO handlers of the EXI channels, so they have to exist.
+    Config::SetCurrent(Config::MAIN_SLOT_A, ExpansionInterface::EXIDeviceType::None);
+    Config::SetCurrent(Config::MAIN_SLOT_B, ExpansionInterface::EXIDeviceType::None);
+    Config::SetCurrent(Config::MAIN_SERIAL_PORT_1, ExpansionInterface::EXIDeviceType::None);
+
+    auto& system = Core::System::GetInstance();
+    system.GetCoreTiming().Init();
+    system.GetExpansionInterface().Init(&m_sram);
+    system.GetMemory().Init();
+    system.GetCPU().Init(PowerPC::CPUCore::Interpreter);
+
+    WriteWords(CONSTANTS_ADDRESS, {ZERO, ONE, ZERO, ONE});
+    std::vector<u8> buffer(BUFFER_SIZE);
+    for (u32 i = 0; i < BUFFER_SIZE; i++)
+      buffer[i] = static_cast<u8>(i * 7 + 3);
+    system.GetMemory().CopyToEmu(BUFFER_ADDRESS, buffer.data(), buffer.size());
+  }
+
+  void TearDown() override
+  {
+    if (m_profile_path.empty())
+      return;
+    auto& system = Core::System::GetInstance();
+    system.GetCPU().Shutdown();
+    system.GetMemory().Shutdown();
+    system.GetExpansionInterface().Shutdown();
+    system.GetCoreTiming().Shutdown();
+    SConfig::Shutdown();
+    Config::Shutdown();
+    Core::UndeclareAsCPUThread();
+    File::DeleteDirRecursively(m_profile_path);
+  }
+
+  void WriteCode(const std::vector<u32>& code)
+  {
+    auto& memory = Core::System::GetInstance().GetMemory();
+    for (size_t i = 0; i < code.size(); i++)
+      memory.Write_U32(code[i], FUNCTION_ADDRESS + static_cast<u32>(i * 4));
+    m_code_end = FUNCTION_ADDRESS + static_cast<u32>(code.size() * 4);
+  }
+
+  static void WriteWords(u32 address, std::initializer_list<u32> words)
+  {
+    auto& memory = Core::System::GetInstance().GetMemory();
+    for (const u32 word : words)
+    {
+      memory.Write_U32(word, address);
+      address += 4;
+    }
+  }
+
+  static void WriteMatrix(u32 address, const Matrix& matrix)
+  {
+    auto& memory = Core::System::GetInstance().GetMemory();
+    for (const u32 word : matrix)
+    {
+      memory.Write_U32(word, address);
+      address += 4;
+    }
+  }
+
+  static void WriteString(u32 address, const std::string& string)
+  {
+    Core::System::GetInstance().GetMemory().CopyToEmu(address, string.c_str(), string.size() + 1);
+  }
+
+  // Calls the code at FUNCTION_ADDRESS once through the interpreter and once through the
+  // replacement, each time starting out from the same registers and memory, and compares the
+  // results.
+  void ExpectSameResult(HookFunction replacement, u32 r3, u32 r4 = 0, u32 r5 = 0)
+  {
+    auto& memory = Core::System::GetInstance().GetMemory();
+    std::vector<u8> buffer(BUFFER_SIZE);
+    memory.CopyFromEmu(buffer.data(), BUFFER_ADDRESS, buffer.size());
+
+    ResetRegisters(r3, r4, r5);
+    const State expected = RunOriginalCode();
+    memory.CopyToEmu(BUFFER_ADDRESS, buffer.data(), buffer.size());
+    ResetRegisters(r3, r4, r5);
+    const State actual = RunReplacement(replacement);
+    memory.CopyToEmu(BUFFER_ADDRESS, buffer.data(), buffer.size());
+
+    // The return value, and the registers which the ABI preserves across calls. Of the FPRs, that
+    // is only ps0.
+    for (const u32 i : {1, 2, 3})
+      EXPECT_EQ(actual.gpr[i], expected.gpr[i]) << "r" << i;
+    for (u32 i = 13; i < 32; i++)
+      EXPECT_EQ(actual.gpr[i], expected.gpr[i]) << "r" << i;
+    for (u32 i = 14; i < 32; i++)
+      EXPECT_EQ(actual.ps0[i], expected.ps0[i]) << "f" << i;
+    EXPECT_EQ(actual.fpscr, expected.fpscr);
+    EXPECT_EQ(actual.pc, expected.pc);
+    EXPECT_EQ(actual.srr0, expected.srr0);
+    EXPECT_TRUE(actual.buffer == expected.buffer);
+  }
+
+  UReg_FPSCR m_fpscr{};
+  u32 m_gqr0 = 0;
+  bool m_fp_enabled = true;
+
+private:
+  void ResetRegisters(u32 r3, u32 r4, u32 r5)
+  {
+    auto& ppc_state = Core::System::GetInstance().GetPPCState();
+    ppc_state.msr.Hex = 0;
+    ppc_state.msr.FP = m_fp_enabled;
+    PowerPC::MSRUpdated(ppc_state);
+    ppc_state.pc = FUNCTION_ADDRESS;
+    ppc_state.npc = FUNCTION_ADDRESS;
+    for (u32 i = 0; i < 32; i++)
+    {
+      ppc_state.gpr[i] = 0x100 + i * 0x11;
+      ppc_state.ps[i].SetBoth(static_cast<double>(i), -static_cast<double>(i));
+    }
+    ppc_state.gpr[1] = STACK_ADDRESS;
+    ppc_state.gpr[2] = CONSTANTS_ADDRESS;
+    ppc_state.gpr[3] = r3;
+    ppc_state.gpr[4] = r4;
+    ppc_state.gpr[5] = r5;
+    LR(ppc_state) = RETURN_ADDRESS;
+    ppc_state.fpscr.Hex = m_fpscr.Hex;
+    GQR(ppc_state, 0) = m_gqr0;
+    HID2(ppc_state).PSE = 1;
+    HID2(ppc_state).LSQE = 1;
+    ppc_state.spr[SPR_SRR0] = 0;
+    ppc_state.Exceptions = 0;
+  }
+
+  State RunOriginalCode()
+  {
+    auto& system = Core::System::GetInstance();
+    auto& ppc_state = system.GetPPCState();
+    auto& interpreter = system.GetInterpreter();
+    // Until the code returns or takes an exception.
+    for (u32 i = 0; i < MAX_STEPS && ppc_state.pc >= FUNCTION_ADDRESS && ppc_state.pc < m_code_end;
+         i++)
+    {
+      interpreter.SingleStepInner();
+    }
+    return GetState();
+  }
+
+  State RunReplacement(HookFunction replacement)
+  {
+    auto& system = Core::System::GetInstance();
+    auto& ppc_state = system.GetPPCState();
+    {
+      Core::CPUThreadGuard guard(system);
+      replacement(guard);
+    }
+    // Like the CPU cores do after a replacement.
+    ppc_state.pc = ppc_state.npc;
+    return GetState();
+  }
+
+  static State GetState()
+  {
+    auto& system = Core::System::GetInstance();
+    auto& ppc_state = system.GetPPCState();
+    State state;
+    std::copy(std::begin(ppc_state.gpr), std::end(ppc_state.gpr), state.gpr.begin());
+    for (u32 i = 0; i < 32; i++)
+      state.ps0[i] = ppc_state.ps[i].PS0AsU64();
+    state.fpscr = ppc_state.fpscr.Hex;
+    state.pc = ppc_state.pc;
+    state.srr0 = ppc_state.spr[SPR_SRR0];
+    state.buffer.resize(BUFFER_SIZE);
+    system.GetMemory().CopyFromEmu(state.buffer.data(), BUFFER_ADDRESS, state.buffer.size());
+    return state;
+  }
+
+  std::string m_profile_path;
+  Sram m_sram{};
+  u32 m_code_end = FUNCTION_ADDRESS;
+};
+}  // namespace
+
+TEST_F(HLELibTest, Memcpy)
+{
+  WriteCode(MEMCPY_CODE);
+  // memmove only differs from memcpy in that the C standard allows overlapping buffers.
+  for (const HookFunction replacement : {HLE_Lib::Memcpy, HLE_Lib::Memmove})
+  {
+    ExpectSameResult(replacement, BUFFER_ADDRESS + 0x800, BUFFER_ADDRESS, 0x100);
+    ExpectSameResult(replacement, BUFFER_ADDRESS + 0x800, BUFFER_ADDRESS + 0x801, 0);
+    // Across a page boundary
+    ExpectSameResult(replacement, BUFFER_ADDRESS + PAGE_SIZE - 0x33, BUFFER_ADDRESS + 0x100, 0x99);
+    ExpectSameResult(replacement, BUFFER_ADDRESS + 0x100, BUFFER_ADDRESS + PAGE_SIZE - 0x33, 0x99);
+    // Overlapping, with the destination after and before the source
+    ExpectSameResult(replacement, BUFFER_ADDRESS + 0x13, BUFFER_ADDRESS, 0x100);
+    ExpectSameResult(replacement, BUFFER_ADDRESS, BUFFER_ADDRESS + 0x13, 0x100);
+    ExpectSameResult(replacement, BUFFER_ADDRESS + 1, BUFFER_ADDRESS, PAGE_SIZE);
+  }
+}
+
+TEST_F(HLELibTest, Memset)
+{
+  WriteCode(MEMSET_CODE);
+  // Only the low byte of the value is used.
+  ExpectSameResult(HLE_Lib::Memset, BUFFER_ADDRESS + 3, 0x1AB, 0x100);
+  ExpectSameResult(HLE_Lib::Memset, BUFFER_ADDRESS + 3, 0, 0);
+  ExpectSameResult(HLE_Lib::Memset, BUFFER_ADDRESS + PAGE_SIZE - 0x21, 0xFF, 0x42);
+}
+
+TEST_F(HLELibTest, Strlen)
+{
+  WriteCode(STRLEN_CODE);
+  WriteString(BUFFER_ADDRESS, "");
+  ExpectSameResult(HLE_Lib::Strlen, BUFFER_ADDRESS);
+  WriteString(BUFFER_ADDRESS + 0x11, "Dolphin");
+  ExpectSameResult(HLE_Lib::Strlen, BUFFER_ADDRESS + 0x11);
+  // Across a page boundary
+  WriteString(BUFFER_ADDRESS + PAGE_SIZE - 5, "\xff\x80 GameCube");
+  ExpectSameResult(HLE_Lib::Strlen, BUFFER_ADDRESS + PAGE_SIZE - 5);
+}
+
+TEST_F(HLELibTest, Strcmp)
+{
+  WriteCode(STRCMP_CODE);
+  WriteString(BUFFER_ADDRESS, "Dolphin");
+  WriteString(BUFFER_ADDRESS + 0x10, "Dolphin");
+  WriteString(BUFFER_ADDRESS + 0x20, "Dolphins");
+  WriteString(BUFFER_ADDRESS + 0x30, "Dolph\xefn");
+  WriteString(BUFFER_ADDRESS + 0x40, "");
+  ExpectSameResult(HLE_Lib::Strcmp, BUFFER_ADDRESS, BUFFER_ADDRESS + 0x10);
+  ExpectSameResult(HLE_Lib::Strcmp, BUFFER_ADDRESS, BUFFER_ADDRESS + 0x20);
+  ExpectSameResult(HLE_Lib::Strcmp, BUFFER_ADDRESS + 0x20, BUFFER_ADDRESS);
+  // The bytes are compared unsigned.
+  ExpectSameResult(HLE_Lib::Strcmp, BUFFER_ADDRESS, BUFFER_ADDRESS + 0x30);
+  ExpectSameResult(HLE_Lib::Strcmp, BUFFER_ADDRESS + 0x30, BUFFER_ADDRESS);
+  ExpectSameResult(HLE_Lib::Strcmp, BUFFER_ADDRESS + 0x40, BUFFER_ADDRESS);
+  // The same string, with one copy across a page boundary
+  WriteString(BUFFER_ADDRESS + PAGE_SIZE - 3, "Dolphin");
+  ExpectSameResult(HLE_Lib::Strcmp, BUFFER_ADDRESS + PAGE_SIZE - 3, BUFFER_ADDRESS);
+}
+
+TEST_F(HLELibTest, PSMTXIdentity)
+{
+  WriteCode(PSMTX_IDENTITY_CODE);
+  ExpectSameResult(HLE_Lib::PSMTXIdentity, BUFFER_ADDRESS + 0x10);
+}
+
+TEST_F(HLELibTest, PSMTXCopy)
+{
+  WriteCode(PSMTX_COPY_CODE);
+  WriteMatrix(BUFFER_ADDRESS, MATRIX_A);
+  ExpectSameResult(HLE_Lib::PSMTXCopy, BUFFER_ADDRESS, BUFFER_ADDRESS + 0x100);
+  // Denormals get flushed on the way through the FPRs.
+  WriteMatrix(BUFFER_ADDRESS, SPECIAL_MATRIX);
+  ExpectSameResult(HLE_Lib::PSMTXCopy, BUFFER_ADDRESS, BUFFER_ADDRESS + 0x100);
+  WriteMatrix(BUFFER_ADDRESS, DENORMAL_MATRIX);
+  ExpectSameResult(HLE_Lib::PSMTXCopy, BUFFER_ADDRESS, BUFFER_ADDRESS + 0x100);
+  ExpectSameResult(HLE_Lib::PSMTXCopy, BUFFER_ADDRESS, BUFFER_ADDRESS);
+}
+
+TEST_F(HLELibTest, PSMTXConcat)
+{
+  WriteCode(PSMTX_CONCAT_CODE);
+  constexpr u32 A = BUFFER_ADDRESS;
+  constexpr u32 B = BUFFER_ADDRESS + 0x40;
+  constexpr u32 AB = BUFFER_ADDRESS + 0x80;
+
+  const auto expect_same_results = [&] {
+    for (const Matrix* a : {&MATRIX_A, &SPECIAL_MATRIX, &DENORMAL_MATRIX})
+    {
+      for (const Matrix* b : {&MATRIX_B, &SPECIAL_MATRIX, &DENORMAL_MATRIX})
+      {
+        WriteMatrix(A, *a);
+        WriteMatrix(B, *b);
+        ExpectSameResult(HLE_Lib::PSMTXConcat, A, B, AB);
+        // The result may overwrite either input.
+        ExpectSameResult(HLE_Lib::PSMTXConcat, A, B, A);
+        ExpectSameResult(HLE_Lib::PSMTXConcat, A, B, B);
+        ExpectSameResult(HLE_Lib::PSMTXConcat, A, A, A);
+      }
+    }
+  };
+
+  expect_same_results();
+  // With denormal results flushed to zero
+  m_fpscr.NI = 1;
+  expect_same_results();
+  // With invalid operation exceptions enabled
+  m_fpscr.NI = 0;
+  m_fpscr.VE = 1;
+  expect_same_results();
+}
+
+TEST_F(HLELibTest, PSMTXMultVec)
+{
+  WriteCode(PSMTX_MULT_VEC_CODE);
+  constexpr u32 M = BUFFER_ADDRESS;
+  constexpr u32 SRC = BUFFER_ADDRESS + 0x40;
+  constexpr u32 DST = BUFFER_ADDRESS + 0x80;
+
+  const auto expect_same_results = [&] {
+    for (const Matrix* m : {&MATRIX_A, &SPECIAL_MATRIX, &DENORMAL_MATRIX})
+    {
+      WriteMatrix(M, *m);
+      for (const std::array<u32, 3>& vector :
+           {std::array<u32, 3>{ONE, THIRD, MINUS_ONE}, std::array<u32, 3>{QUIET_NAN, ZERO, PI},
+            std::array<u32, 3>{DENORMAL, INFINITE, NEGATIVE_ZERO},
+            std::array<u32, 3>{LARGE, SIGNALING_NAN, SMALLEST_NORMAL}})
+      {
+        WriteWords(SRC, {vector[0], vector[1], vector[2]});
+        ExpectSameResult(HLE_Lib::PSMTXMultVec, M, SRC, DST);
+        ExpectSameResult(HLE_Lib::PSMTXMultVec, M, SRC, SRC);
+        // The result overwrites the matrix while it's being read.
+        ExpectSameResult(HLE_Lib::PSMTXMultVec, M, SRC, M + 4);
+      }
+    }
+  };
+
+  expect_same_results();
+  m_fpscr.NI = 1;
+  expect_same_results();
+  m_fpscr.NI = 0;
+  m_fpscr.VE = 1;
+  expect_same_results();
+}
+
+TEST_F(HLELibTest, MatrixRoutinesFallBackToOriginalCode)
+{
+  constexpr u32 A = BUFFER_ADDRESS;
+  constexpr u32 B = BUFFER_ADDRESS + 0x40;
+  constexpr u32 AB = BUFFER_ADDRESS + 0x80;
+  WriteMatrix(A, MATRIX_A);
+  WriteMatrix(B, MATRIX_B);
+
+  const auto expect_same_results = [&] {
+    WriteCode(PSMTX_IDENTITY_CODE);
+    ExpectSameResult(HLE_Lib::PSMTXIdentity, AB);
+    WriteCode(PSMTX_COPY_CODE);
+    ExpectSameResult(HLE_Lib::PSMTXCopy, A, AB);
+    WriteCode(PSMTX_CONCAT_CODE);
+    ExpectSameResult(HLE_Lib::PSMTXConcat, A, B, AB);
+    WriteCode(PSMTX_MULT_VEC_CODE);
+    ExpectSameResult(HLE_Lib::PSMTXMultVec, A, B, AB);
+  };
+
+  // psq_l and psq_st quantize through GQR0, so the replacements would store different values.
+  m_gqr0 = GQR_S16;
+  expect_same_results();
+
+  // The original code takes an FPU unavailable exception.
+  m_gqr0 = 0;
+  m_fp_enabled = false;
+  expect_same_results();
+}
@@ -2,16 +2,30 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #include <chrono>
+#include <memory>
+#include <string>
 #include <fmt/format.h>
 
 #include "Common/CommonTypes.h"
+#include "Common/Config/Config.h"
+#include "Common/FileUtil.h"
+#include "Common/MemoryUtil.h"
 #include "Common/ScopeGuard.h"
 #include "Common/Timer.h"
+#include "Core/Config/MainSettings.h"
+#include "Core/ConfigManager.h"
 #include "Core/Core.h"
+#include "Core/HW/EXI/EXI.h"
+#include "Core/HW/EXI/EXI_Device.h"
+#include "Core/HW/Memmap.h"
+#include "Core/HW/Sram.h"
 #include "Core/MemTools.h"
+#include "Core/PowerPC/BreakPoints.h"
 #include "Core/PowerPC/JitCommon/JitBase.h"
 #include "Core/PowerPC/JitInterface.h"
+#include "Core/PowerPC/PowerPC.h"
 #include "Core/System.h"
+#include "UICommon/UICommon.h"
 
 // include order is important
 #include <gtest/gtest.h>  // NOLINT
@@ -105,3 +119,94 @@ TEST(PageFault, PageFault)
 
   system.GetJitInterface().SetJit(nullptr);
 }
+
+// Counts the faults instead of timing them, and makes the faulting page accessible so that the
+// access can complete.
+class WatchedMemoryFakeJit : public PageFaultFakeJit
+{
+public:
+  using PageFaultFakeJit::PageFaultFakeJit;
+
+  bool HandleFault(uintptr_t access_address, SContext* ctx) override
+  {
+    const uintptr_t page_size = Common::GetPageSize();
+    Common::UnReadProtectMemory(reinterpret_cast<void*>(access_address & ~(page_size - 1)),
+                                page_size);
+    m_faults++;
+    return true;
+  }
+
+  int m_faults = 0;
+};
+
+TEST(PageFault, WatchedMemoryIsRestored)
+{
+  if (!EMM::IsExceptionHandlerSupported())
+    GTEST_SKIP() << "Skipping WatchedMemory test because exception handler is unsupported.";
+
+  const std::string profile_path = File::CreateTempDir();
+  ASSERT_FALSE(profile_path.empty());
+  Core::DeclareAsCPUThread();
+  UICommon::SetUserDirectory(profile_path);
+  Config::Init();
+  SConfig::Init();
+  // Memory registers the MMIO handlers of the EXI channels, so they have to exist.
+  Config::SetCurrent(Config::MAIN_SLOT_A, ExpansionInterface::EXIDeviceType::None);
+  Config::SetCurrent(Config::MAIN_SLOT_B, ExpansionInterface::EXIDeviceType::None);
+  Config::SetCurrent(Config::MAIN_SERIAL_PORT_1, ExpansionInterface::EXIDeviceType::None);
+
+  auto& system = Core::System::GetInstance();
+  auto& memory = system.GetMemory();
+  Sram sram{};
+  system.GetExpansionInterface().Init(&sram);
+  memory.Init();
+  ASSERT_TRUE(memory.InitFastmemArena());
+  EMM::InstallExceptionHandler();
+
+  Common::ScopeGuard shutdown_guard([&] {
+    EMM::UninstallExceptionHandler();
+    memory.ShutdownFastmemArena();
+    memory.Shutdown();
+    system.GetExpansionInterface().Shutdown();
+    SConfig::Shutdown();
+    Config::Shutdown();
+    Core::UndeclareAsCPUThread();
+    File::DeleteDirRecursively(profile_path);
+  });
+
+  // Accessed through the physical view of the fastmem arena, as with address translation off.
+  constexpr u32 WATCHED_ADDRESS = 0x00100000;
+  u8* const watched = memory.GetPhysicalBase() + WATCHED_ADDRESS;
+
+  const auto add_mem_check = [&] {
+    TMemCheck mem_check;
+    mem_check.start_address = WATCHED_ADDRESS;
+    mem_check.end_address = WATCHED_ADDRESS + 3;
+    mem_check.is_break_on_read = true;
+    mem_check.is_break_on_write = true;
+    system.GetPowerPC().GetMemChecks().Add(std::move(mem_check));
+  };
+  const auto remove_mem_check = [&] {
+    system.GetPowerPC().GetMemChecks().Remove(WATCHED_ADDRESS);
+  };
+  // The fake JIT is only set while accessing memory, as it has no block cache for memchecks to
+  // clear.
+  const auto count_faults = [&] {
+    auto unique_jit = std::make_unique<WatchedMemoryFakeJit>(system);
+    const WatchedMemoryFakeJit& jit = *unique_jit;
+    system.GetJitInterface().SetJit(std::move(unique_jit));
+    perform_invalid_access(watched);
+    const int faults = jit.m_faults;
+    system.GetJitInterface().SetJit(nullptr);
+    return faults;
+  };
+
+  add_mem_check();
+  EXPECT_EQ(count_faults(), 1);
+  remove_mem_check();
+
+  // Once the memcheck is gone, its page must be accessible again.
+  add_mem_check();
+  remove_mem_check();
+  EXPECT_EQ(count_faults(), 0);
+}
@@ -0,0 +1,411 @@
+// Copyright 2026 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <chrono>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/Config/Config.h"
+#include "Common/FileUtil.h"
+#include "Common/MemArena.h"
+#include "Core/Config/MainSettings.h"
+#include "Core/ConfigManager.h"
+#include "Core/Core.h"
+#include "Core/CoreTiming.h"
+#include "Core/HW/CPU.h"
+#include "Core/HW/EXI/EXI.h"
+#include "Core/HW/EXI/EXI_Device.h"
+#include "Core/HW/Memmap.h"
+#include "Core/HW/Sram.h"
+#include "Core/MemTools.h"
+#include "Core/PowerPC/MMU.h"
+#include "Core/PowerPC/PowerPC.h"
+#include "Core/System.h"
+#include "UICommon/UICommon.h"
+
+#include <gtest/gtest.h>
+
+// Runs small hand-assembled guest loops through each CPU core and reports the host time spent per
+// guest instruction and per guest basic block. The loops run with the BAT mapping games use, but
+// without any of the emulated hardware that would schedule events, so the numbers only reflect the
+// cost of the CPU core itself.
+//
+// This is a benchmark rather than a test. CMake builds it as its own CPUCoreBenchmark target, and
+// it's disabled so that it doesn't run along with the unit tests in the Visual Studio build. Run
+// it with --gtest_also_run_disabled_tests.
+
+namespace
+{
+// Physical addresses, which the loops access through the cached MEM1 mirror at 0x80000000.
+constexpr u32 CODE_ADDRESS = 0x00010000;
+constexpr u32 CODE_STRIDE = 0x1000;
+constexpr u32 DATA_ADDRESS = 0x00100000;
+constexpr u32 CACHED_MEM1 = 0x80000000;
+
+constexpr u32 DATA_REGISTER = 20;
+constexpr u32 MEM1_REGISTER = 21;
+constexpr u32 COUNTER_REGISTER = 31;
+
+constexpr s64 WARMUP_CYCLES = 200'000;
+constexpr s64 MEASURED_CYCLES = 8'000'000;
+
+constexpr u32 DForm(u32 opcode, u32 rd, u32 ra, u32 imm)
+{
+  return opcode << 26 | rd << 21 | ra << 16 | (imm & 0xFFFF);
+}
+
+constexpr u32 XForm(u32 opcode, u32 rd, u32 ra, u32 rb, u32 xo, bool rc = false)
+{
+  return opcode << 26 | rd << 21 | ra << 16 | rb << 11 | xo << 1 | u32(rc);
+}
+
+// frd = fra * frc + frb, for whichever of the operands the instruction uses.
+constexpr u32 AForm(u32 opcode, u32 frd, u32 fra, u32 frb, u32 frc, u32 xo)
+{
+  return opcode << 26 | frd << 21 | fra << 16 | frb << 11 | frc << 6 | xo << 1;
+}
+
+constexpr u32 RLWINM(u32 ra, u32 rs, u32 sh, u32 mb, u32 me)
+{
+  return 21u << 26 | rs << 21 | ra << 16 | sh << 11 | mb << 6 | me << 1;
+}
+
+constexpr u32 PSQForm(u32 opcode, u32 frd, u32 ra, u32 offset)
+{
+  // W = 0, I = GQR0
+  return opcode << 26 | frd << 21 | ra << 16 | (offset & 0xFFF);
+}
+
+constexpr u32 B(s32 offset, bool link = false)
+{
+  return 18u << 26 | (static_cast<u32>(offset) & 0x03FFFFFC) | u32(link);
+}
+
+constexpr u32 BEQ(s32 offset)
+{
+  // BO = 12 (branch if true), BI = 2 (cr0[EQ])
+  return 16u << 26 | 12u << 21 | 2u << 16 | (static_cast<u32>(offset) & 0xFFFC);
+}
+
+constexpr u32 BLR = 0x4E800020;
+
+struct Sequence
+{
+  std::string name;
+  std::vector<u32> code;
+  u32 instructions_per_iteration;
+  u32 blocks_per_iteration;
+};
+
+// Appends the loop counter increment and the branch back to the start of the sequence.
+Sequence StraightLineSequence(std::string name, std::vector<u32> body)
+{
+  body.push_back(DForm(14, COUNTER_REGISTER, COUNTER_REGISTER, 1));  // addi r31, r31, 1
+  body.push_back(B(-4 * static_cast<s32>(body.size())));
+  const u32 size = static_cast<u32>(body.size());
+  return {std::move(name), std::move(body), size, 1};
+}
+
+std::vector<Sequence> CreateSequences()
+{
+  std::vector<Sequence> sequences;
+
+  const std::vector<u32> integer_alu{
+      XForm(31, 3, 4, 5, 266),        // add r3, r4, r5
+      XForm(31, 6, 3, 7, 40),         // subf r6, r3, r7
+      XForm(31, 4, 8, 6, 28),         // and r8, r4, r6
+      XForm(31, 5, 9, 8, 444),        // or r9, r5, r8
+      XForm(31, 3, 10, 9, 316),       // xor r10, r3, r9
+      RLWINM(3, 10, 3, 0, 28),        // rlwinm r3, r10, 3, 0, 28
+      XForm(31, 7, 3, 5, 235),        // mullw r7, r3, r5
+      DForm(14, 5, 5, 7),             // addi r5, r5, 7
+      XForm(31, 0, 3, 7, 0),          // cmpw r3, r7
+      XForm(31, 7, 9, 8, 536),        // srw r9, r7, r8
+      DForm(15, 6, 6, 1),             // addis r6, r6, 1
+      XForm(31, 4, 4, 9, 266, true),  // add. r4, r4, r9
+  };
+  sequences.push_back(StraightLineSequence("integer ALU", integer_alu));
+
+  const std::vector<u32> floating_point{
+      AForm(63, 1, 1, 3, 2, 29),    // fmadd f1, f1, f2, f3
+      AForm(63, 4, 4, 5, 0, 21),    // fadd f4, f4, f5
+      AForm(63, 4, 4, 5, 0, 20),    // fsub f4, f4, f5
+      AForm(63, 6, 2, 0, 7, 25),    // fmul f6, f2, f7
+      XForm(63, 9, 0, 1, 12),       // frsp f9, f1
+      AForm(63, 10, 3, 7, 0, 18),   // fdiv f10, f3, f7
+      AForm(59, 12, 9, 2, 0, 21),   // fadds f12, f9, f2
+      AForm(59, 13, 12, 0, 2, 25),  // fmuls f13, f12, f2
+      AForm(59, 8, 8, 3, 2, 29),    // fmadds f8, f8, f2, f3
+      XForm(63, 11, 0, 10, 72),     // fmr f11, f10
+  };
+  sequences.push_back(StraightLineSequence("floating point", floating_point));
+
+  const std::vector<u32> paired_single{
+      AForm(4, 1, 1, 3, 2, 29),    // ps_madd f1, f1, f2, f3
+      AForm(4, 4, 4, 5, 0, 21),    // ps_add f4, f4, f5
+      AForm(4, 4, 4, 5, 0, 20),    // ps_sub f4, f4, f5
+      AForm(4, 6, 2, 0, 7, 25),    // ps_mul f6, f2, f7
+      XForm(4, 8, 1, 6, 528),      // ps_merge00 f8, f1, f6
+      AForm(4, 9, 8, 11, 10, 10),  // ps_sum0 f9, f8, f10, f11
+      AForm(4, 12, 2, 0, 7, 12),   // ps_muls0 f12, f2, f7
+  };
+  sequences.push_back(StraightLineSequence("paired single", paired_single));
+
+  const std::vector<u32> load_store{
+      DForm(32, 3, DATA_REGISTER, 0),     // lwz r3, 0(r20)
+      DForm(36, 3, DATA_REGISTER, 4),     // stw r3, 4(r20)
+      DForm(32, 4, DATA_REGISTER, 8),     // lwz r4, 8(r20)
+      DForm(14, 4, 4, 1),                 // addi r4, r4, 1
+      DForm(36, 4, DATA_REGISTER, 8),     // stw r4, 8(r20)
+      DForm(50, 1, DATA_REGISTER, 16),    // lfd f1, 16(r20)
+      DForm(54, 1, DATA_REGISTER, 24),    // stfd f1, 24(r20)
+      DForm(48, 2, DATA_REGISTER, 32),    // lfs f2, 32(r20)
+      DForm(52, 2, DATA_REGISTER, 36),    // stfs f2, 36(r20)
+      PSQForm(56, 3, DATA_REGISTER, 40),  // psq_l f3, 40(r20), 0, 0
+      PSQForm(60, 3, DATA_REGISTER, 48),  // psq_st f3, 48(r20), 0, 0
+  };
+  sequences.push_back(StraightLineSequence("load/store", load_store));
+
+  // Loads from pseudo-random addresses spread over the first 16 MiB of MEM1, which touch far more
+  // host pages than the TLB can hold. This only reads, as it would overwrite the code otherwise.
+  // r21 holds the address of MEM1.
+  const std::vector<u32> random_loads{
+      DForm(7, 3, 3, 0x4E6D),   // mulli r3, r3, 0x4E6D
+      DForm(14, 3, 3, 0x3039),  // addi r3, r3, 0x3039
+      RLWINM(4, 3, 16, 8, 29),  // rlwinm r4, r3, 16, 8, 29
+      XForm(31, 6, 21, 4, 23),  // lwzx r6, r21, r4
+      XForm(31, 7, 7, 6, 266),  // add r7, r7, r6
+      DForm(7, 3, 3, 0x4E6D),   // mulli r3, r3, 0x4E6D
+      DForm(14, 3, 3, 0x3039),  // addi r3, r3, 0x3039
+      RLWINM(4, 3, 16, 8, 29),  // rlwinm r4, r3, 16, 8, 29
+      XForm(31, 8, 21, 4, 23),  // lwzx r8, r21, r4
+      XForm(31, 7, 7, 8, 266),  // add r7, r7, r8
+  };
+  sequences.push_back(StraightLineSequence("random loads", random_loads));
+
+  // Both sides of the conditional branch execute the same number of instructions, so the
+  // instruction count per iteration doesn't depend on the branch pattern.
+  std::vector<u32> branches{
+      DForm(14, COUNTER_REGISTER, COUNTER_REGISTER, 1),  // 0: addi r31, r31, 1
+      DForm(28, COUNTER_REGISTER, 3, 1),                 // 1: andi. r3, r31, 1
+      BEQ(12),                                           // 2: beq 5
+      DForm(14, 4, 4, 1),                                // 3: addi r4, r4, 1
+      B(12),                                             // 4: b 7
+      DForm(14, 5, 5, 1),                                // 5: addi r5, r5, 1
+      DForm(14, 6, 6, 1),                                // 6: addi r6, r6, 1
+      DForm(11, 4, 4, 0),                                // 7: cmpwi cr1, r4, 0
+      B(12, true),                                       // 8: bl 11
+      DForm(14, 7, 7, 1),                                // 9: addi r7, r7, 1
+      B(-40),                                            // 10: b 0
+      DForm(14, 8, 8, 1),                                // 11: addi r8, r8, 1
+      BLR,                                               // 12: blr
+  };
+  sequences.push_back({"branches", std::move(branches), 11, 5});
+
+  return sequences;
+}
+
+struct Configuration
+{
+  std::string name;
+  PowerPC::CPUCore core;
+  bool fastmem;
+  bool fprf;
+  bool huge_pages = false;
+};
+
+std::vector<Configuration> CreateConfigurations()
+{
+  std::vector<Configuration> configurations{
+      {"Interpreter", PowerPC::CPUCore::Interpreter, false, false},
+      {"CachedInterpreter", PowerPC::CPUCore::CachedInterpreter, false, false},
+  };
+
+  const PowerPC::CPUCore jit = PowerPC::DefaultCPUCore();
+  if (jit == PowerPC::CPUCore::JIT64 || jit == PowerPC::CPUCore::JITARM64)
+  {
+    const std::string name = jit == PowerPC::CPUCore::JIT64 ? "JIT64" : "JITARM64";
+    configurations.push_back({name, jit, true, false});
+    configurations.push_back({name + " (no fastmem)", jit, false, false});
+    configurations.push_back({name + " (FPRF)", jit, true, true});
+    if (Common::MemArena::GetHugePageSize() != 0)
+      configurations.push_back({name + " (huge pages)", jit, true, false, true});
+  }
+
+  return configurations;
+}
+
+void StopCallback(Core::System& system, u64 userdata, s64 cycles_late)
+{
+  system.GetCPU().Break();
+}
+
+// Brings up the subset of the emulated system that the CPU cores need to run guest code.
+class ScopedCPUCore final
+{
+public:
+  ScopedCPUCore(Core::System& system, const Configuration& configuration) : m_system(system)
+  {
+    Config::SetCurrent(Config::MAIN_FASTMEM, configuration.fastmem);
+    Config::SetCurrent(Config::MAIN_FPRF, configuration.fprf);
+    Config::SetCurrent(Config::MAIN_HUGE_PAGES, configuration.huge_pages);
+
+    system.GetCoreTiming().Init();
+    m_stop_event = system.GetCoreTiming().RegisterEvent("CPUCoreBenchmarkStop", StopCallback);
+    // Memory registers the MMIO handlers of the EXI channels, so they have to exist.
+    system.GetExpansionInterface().Init(&m_sram);
+    system.GetMemory().Init();
+    system.GetCPU().Init(configuration.core);
+
+    // Map the first 256 MiB of physical memory to 0x80000000, like the BAT setup of games.
+    auto& ppc_state = system.GetPPCState();
+    ppc_state.spr[SPR_IBAT0U] = 0x80001fff;
+    ppc_state.spr[SPR_IBAT0L] = 0x00000002;
+    ppc_state.spr[SPR_DBAT0U] = 0x80001fff;
+    ppc_state.spr[SPR_DBAT0L] = 0x00000002;
+    system.GetMMU().DBATUpdated();
+    system.GetMMU().IBATUpdated();
+  }
+  ~ScopedCPUCore()
+  {
+    m_system.GetCPU().Shutdown();
+    m_system.GetMemory().Shutdown();
+    m_system.GetExpansionInterface().Shutdown();
+    m_system.GetCoreTiming().Shutdown();
+  }
+
+  void LoadSequence(const Sequence& sequence, u32 address)
+  {
+    auto& memory = m_system.GetMemory();
+    for (size_t i = 0; i < sequence.code.size(); i++)
+      memory.Write_U32(sequence.code[i], address + static_cast<u32>(i * 4));
+  }
+
+  // Returns the number of loop iterations executed.
+  u64 Run(u32 address, s64 cycles)
+  {
+    ResetState(address);
+
+    m_system.GetCoreTiming().ScheduleEvent(cycles, m_stop_event);
+    m_system.GetCPU().EnableStepping(false);
+    m_system.GetPowerPC().RunLoop();
+
+    return m_system.GetPPCState().gpr[COUNTER_REGISTER];
+  }
+
+private:
+  void ResetState(u32 address)
+  {
+    auto& ppc_state = m_system.GetPPCState();
+    ppc_state.msr.Hex = 0;
+    ppc_state.msr.FP = 1;
+    // Without data translation, the JITs fall back to the interpreter for quantized accesses.
+    ppc_state.msr.DR = 1;
+    ppc_state.msr.IR = 1;
+    PowerPC::MSRUpdated(ppc_state);
+    HID2(ppc_state).PSE = 1;
+    HID2(ppc_state).LSQE = 1;
+    ppc_state.pc = CACHED_MEM1 | address;
+    ppc_state.npc = CACHED_MEM1 | address;
+
+    for (u32 i = 0; i < 32; i++)
+    {
+      ppc_state.gpr[i] = 0x100 + i * 0x11;
+      ppc_state.ps[i].SetBoth(1.0 + i * 0.25, 2.0 - i * 0.125);
+    }
+    // Keeps fmadd f1 = f1 * f2 + f3 converging.
+    ppc_state.ps[2].SetBoth(0.5, 0.5);
+    ppc_state.gpr[DATA_REGISTER] = CACHED_MEM1 | DATA_ADDRESS;
+    ppc_state.gpr[MEM1_REGISTER] = CACHED_MEM1;
+    ppc_state.gpr[COUNTER_REGISTER] = 0;
+
+    auto& memory = m_system.GetMemory();
+    memory.Write_U32(0x12345678, DATA_ADDRESS);
+    memory.Write_U32(0x00000010, DATA_ADDRESS + 8);
+    memory.Write_U64(0x3FF8000000000000, DATA_ADDRESS + 16);  // 1.5
+    memory.Write_U32(0x3FC00000, DATA_ADDRESS + 32);          // 1.5f
+    memory.Write_U32(0x40000000, DATA_ADDRESS + 40);          // 2.0f
+    memory.Write_U32(0x40400000, DATA_ADDRESS + 44);          // 3.0f
+  }
+
+  Core::System& m_system;
+  Sram m_sram{};
+  CoreTiming::EventType* m_stop_event = nullptr;
+};
+
+class ScopeInit final
+{
+public:
+  ScopeInit() : m_profile_path(File::CreateTempDir())
+  {
+    if (!UserDirectoryExists())
+      return;
+    Core::DeclareAsCPUThread();
+    UICommon::SetUserDirectory(m_profile_path);
+    Config::Init();
+    SConfig::Init();
+    Config::SetCurrent(Config::MAIN_EMULATION_SPEED, 0.0f);
+    Config::SetCurrent(Config::MAIN_SLOT_A, ExpansionInterface::EXIDeviceType::None);
+    Config::SetCurrent(Config::MAIN_SLOT_B, ExpansionInterface::EXIDeviceType::None);
+    Config::SetCurrent(Config::MAIN_SERIAL_PORT_1, ExpansionInterface::EXIDeviceType::None);
+    EMM::InstallExceptionHandler();
+  }
+  ~ScopeInit()
+  {
+    if (!UserDirectoryExists())
+      return;
+    EMM::UninstallExceptionHandler();
+    SConfig::Shutdown();
+    Config::Shutdown();
+    Core::UndeclareAsCPUThread();
+    File::DeleteDirRecursively(m_profile_path);
+  }
+  bool UserDirectoryExists() const { return !m_profile_path.empty(); }
+
+private:
+  std::string m_profile_path;
+};
+}  // namespace
+
+TEST(CPUCoreBenchmark, DISABLED_GuestSequences)
+{
+  ScopeInit guard;
+  ASSERT_TRUE(guard.UserDirectoryExists());
+
+  auto& system = Core::System::GetInstance();
+  const std::vector<Sequence> sequences = CreateSequences();
+
+  fmt::print("{:<28} {:<16} {:>16} {:>16}\n", "core", "sequence", "ns/instruction", "ns/block");
+  for (const Configuration& configuration : CreateConfigurations())
+  {
+    ScopedCPUCore cpu_core(system, configuration);
+
+    for (size_t i = 0; i < sequences.size(); i++)
+    {
+      const Sequence& sequence = sequences[i];
+      const u32 address = CODE_ADDRESS + static_cast<u32>(i) * CODE_STRIDE;
+      cpu_core.LoadSequence(sequence, address);
+
+      // Lets the JITs compile everything before measuring.
+      EXPECT_NE(cpu_core.Run(address, WARMUP_CYCLES), 0u);
+
+      const auto start = std::chrono::high_resolution_clock::now();
+      const u64 iterations = cpu_core.Run(address, MEASURED_CYCLES);
+      const auto end = std::chrono::high_resolution_clock::now();
+      ASSERT_NE(iterations, 0u);
+
+      const double nanoseconds = static_cast<double>(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+      const double instructions = static_cast<double>(iterations) *
+                                  static_cast<double>(sequence.instructions_per_iteration);
+      const double blocks =
+          static_cast<double>(iterations) * static_cast<double>(sequence.blocks_per_iteration);
+      fmt::print("{:<28} {:<16} {:>16.3f} {:>16.3f}\n", configuration.name, sequence.name,
+                 nanoseconds / instructions, nanoseconds / blocks);
+    }
+  }
+}
@@ -0,0 +1,371 @@
+// Copyright 2026 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/Config/Config.h"
+#include "Common/FileUtil.h"
+#include "Core/Config/MainSettings.h"
+#include "Core/ConfigManager.h"
+#include "Core/Core.h"
+#include "Core/CoreTiming.h"
+#include "Core/HW/CPU.h"
+#include "Core/HW/EXI/EXI.h"
+#include "Core/HW/EXI/EXI_Device.h"
+#include "Core/HW/Memmap.h"
+#include "Core/HW/Sram.h"
+#include "Core/PowerPC/MMU.h"
+#include "Core/PowerPC/PowerPC.h"
+#include "Core/System.h"
+#include "UICommon/UICommon.h"
+
+#include <gtest/gtest.h>
+
+// The cached interpreter fuses some common instruction sequences into superinstructions. Runs such
+// sequences, and similar ones which must not be fused, through both the interpreter and the cached
+// interpreter, and checks that they end up in the same state.
+
+namespace
+{
+// Physical addresses, which the code accesses through the cached MEM1 mirror at 0x80000000.
+constexpr u32 CODE_ADDRESS = 0x00010000;
+constexpr u32 DATA_ADDRESS = 0x00100000;
+constexpr u32 CACHED_MEM1 = 0x80000000;
+// Exception vectors, which run untranslated.
+constexpr std::array<u32, 4> EXCEPTION_VECTORS{0x300, 0x400, 0x700, 0x800};
+
+constexpr u32 DATA_REGISTER = 20;
+
+constexpr s64 RUN_CYCLES = 1000;
+
+constexpr u32 DForm(u32 opcode, u32 rd, u32 ra, u32 imm)
+{
+  return opcode << 26 | rd << 21 | ra << 16 | (imm & 0xFFFF);
+}
+
+constexpr u32 XForm(u32 opcode, u32 rd, u32 ra, u32 rb, u32 xo, bool rc = false)
+{
+  return opcode << 26 | rd << 21 | ra << 16 | rb << 11 | xo << 1 | u32(rc);
+}
+
+constexpr u32 RLWINM(u32 ra, u32 rs, u32 sh, u32 mb, u32 me, bool rc = false)
+{
+  return 21u << 26 | rs << 21 | ra << 16 | sh << 11 | mb << 6 | me << 1 | u32(rc);
+}
+
+constexpr u32 LI(u32 rd, u32 imm)
+{
+  return DForm(14, rd, 0, imm);
+}
+
+constexpr u32 B(s32 offset)
+{
+  return 18u << 26 | (static_cast<u32>(offset) & 0x03FFFFFC);
+}
+
+constexpr u32 BC(u32 bo, u32 bi, s32 offset)
+{
+  return 16u << 26 | bo << 21 | bi << 16 | (static_cast<u32>(offset) & 0xFFFC);
+}
+
+// BO values
+constexpr u32 BRANCH_IF_TRUE = 12;
+constexpr u32 BRANCH_IF_FALSE = 4;
+constexpr u32 DECREMENT_AND_BRANCH_IF_TRUE = 8;
+
+// BI values within a CR field
+constexpr u32 LT = 0;
+constexpr u32 GT = 1;
+constexpr u32 EQ = 2;
+
+constexpr u32 CMPWI(u32 crf, u32 ra, s16 imm)
+{
+  return DForm(11, crf << 2, ra, static_cast<u16>(imm));
+}
+
+constexpr u32 CMPLWI(u32 crf, u32 ra, u16 imm)
+{
+  return DForm(10, crf << 2, ra, imm);
+}
+
+constexpr u32 CMPW(u32 crf, u32 ra, u32 rb)
+{
+  return XForm(31, crf << 2, ra, rb, 0);
+}
+
+constexpr u32 CMPLW(u32 crf, u32 ra, u32 rb)
+{
+  return XForm(31, crf << 2, ra, rb, 32);
+}
+
+// Ends the code with a branch to itself, which the analyzer detects as an idle loop.
+constexpr u32 END = B(0);
+
+struct TestCase
+{
+  std::string name;
+  std::vector<u32> code;
+  u32 r4;
+  bool xer_so = false;
+  bool fp_enabled = true;
+};
+
+// A compare, and a conditional branch setting r6 to 1 if it's taken, or to 2 if it isn't.
+std::vector<u32> CompareAndBranch(u32 compare, u32 bo, u32 bi)
+{
+  return {
+      compare,         // 0
+      BC(bo, bi, 12),  // 4: bc 16
+      LI(6, 2),        // 8: li r6, 2
+      B(8),            // 12: b 20
+      LI(6, 1),        // 16: li r6, 1
+      END,             // 20
+  };
+}
+
+std::vector<TestCase> CreateTestCases()
+{
+  std::vector<TestCase> test_cases;
+
+  // rlwinm, and chains of two of them.
+  test_cases.push_back(
+      {"RotateAndMaskPair", {RLWINM(3, 4, 3, 0, 28), RLWINM(5, 3, 16, 8, 29), END}, 0x87654321});
+  test_cases.push_back({"RotateAndMaskUnrelatedPair",
+                        {RLWINM(3, 4, 3, 0, 28), RLWINM(5, 6, 16, 8, 29), END},
+                        0x87654321});
+  test_cases.push_back({"RotateAndMaskOverwritingPair",
+                        {RLWINM(4, 4, 31, 1, 31), RLWINM(4, 4, 4, 0, 27), END},
+                        0x87654321});
+  // rlwinm. sets CR0, so it's not fused.
+  test_cases.push_back({"RotateAndMaskFirstRc",
+                        {RLWINM(3, 4, 3, 0, 28, true), RLWINM(5, 3, 16, 8, 29), END},
+                        0x87654321,
+                        true});
+  test_cases.push_back({"RotateAndMaskSecondRc",
+                        {RLWINM(3, 4, 0, 0, 0), RLWINM(5, 3, 16, 8, 29, true), END},
+                        0x87654321,
+                        true});
+
+  // A compare followed by a conditional branch on its result.
+  test_cases.push_back(
+      {"CmpwiTaken", CompareAndBranch(CMPWI(2, 4, -5), BRANCH_IF_TRUE, 8 + LT), u32(-6)});
+  test_cases.push_back(
+      {"CmpwiNotTaken", CompareAndBranch(CMPWI(2, 4, -5), BRANCH_IF_TRUE, 8 + LT), 4});
+  test_cases.push_back(
+      {"CmplwiTaken", CompareAndBranch(CMPLWI(0, 4, 5), BRANCH_IF_TRUE, GT), 0x80000000});
+  test_cases.push_back(
+      {"CmplwiNotTaken", CompareAndBranch(CMPLWI(0, 4, 5), BRANCH_IF_FALSE, EQ), 5});
+  // r5 starts out as 0x155.
+  test_cases.push_back(
+      {"CmpwEqual", CompareAndBranch(CMPW(0, 4, 5), BRANCH_IF_FALSE, EQ), 0x155, true});
+  test_cases.push_back(
+      {"CmplwNotEqual", CompareAndBranch(CMPLW(7, 4, 5), BRANCH_IF_FALSE, 28 + LT), u32(-1)});
+  test_cases.push_back({"CmpwSummaryOverflow",
+                        CompareAndBranch(CMPW(1, 4, 5), BRANCH_IF_TRUE, 4 + 3), 0x155, true});
+  // Branches on another CR field, or which decrement the CTR, are not fused with the compare.
+  test_cases.push_back(
+      {"CompareOtherField", CompareAndBranch(CMPWI(1, 4, 0), BRANCH_IF_TRUE, EQ), 0});
+  test_cases.push_back({"CompareDecrementCTR",
+                        CompareAndBranch(CMPWI(0, 4, 0), DECREMENT_AND_BRANCH_IF_TRUE, EQ), 0});
+
+  // lwz followed by an instruction using the loaded value.
+  test_cases.push_back(
+      {"LoadAndAdd", {DForm(32, 3, DATA_REGISTER, 0), DForm(14, 4, 3, 1), END}, 0});
+  test_cases.push_back({"LoadAndAddRc",
+                        {DForm(32, 3, DATA_REGISTER, 4), XForm(31, 4, 3, 5, 266, true), END},
+                        0,
+                        true});
+  test_cases.push_back({"LoadAndAddOverflow",
+                        {DForm(32, 3, DATA_REGISTER, 4), XForm(31, 4, 3, 3, 266 | 512, true), END},
+                        0});
+  test_cases.push_back(
+      {"LoadAndAddToBase",
+       {DForm(32, DATA_REGISTER, DATA_REGISTER, 8), XForm(31, 4, DATA_REGISTER, 4, 266), END},
+       3});
+  // The FPU unavailable check for the first floating point instruction comes in between.
+  test_cases.push_back({"LoadAndFPUUnavailable",
+                        {DForm(32, 3, DATA_REGISTER, 8), XForm(31, 1, 3, DATA_REGISTER, 535), END},
+                        0,
+                        false,
+                        false});
+
+  return test_cases;
+}
+
+struct State
+{
+  std::array<u32, 32> gpr;
+  u64 f1;
+  u32 cr;
+  u32 xer;
+  u32 ctr;
+  u32 pc;
+  u32 msr;
+  u32 srr0;
+  u32 srr1;
+};
+
+void StopCallback(Core::System& system, u64 userdata, s64 cycles_late)
+{
+  system.GetCPU().Break();
+}
+
+// Brings up the subset of the emulated system that the CPU cores need to run guest code.
+class ScopedCPUCore final
+{
+public:
+  ScopedCPUCore(Core::System& system, PowerPC::CPUCore core) : m_system(system)
+  {
+    system.GetCoreTiming().Init();
+    m_stop_event = system.GetCoreTiming().RegisterEvent("CachedInterpreterTestStop", StopCallback);
+    // Memory registers the MMIO handlers of the EXI channels, so they have to exist.
+    system.GetExpansionInterface().Init(&m_sram);
+    system.GetMemory().Init();
+    system.GetCPU().Init(core);
+
+    // Map the first 256 MiB of physical memory to 0x80000000, like the BAT setup of games.
+    auto& ppc_state = system.GetPPCState();
+    ppc_state.spr[SPR_IBAT0U] = 0x80001fff;
+    ppc_state.spr[SPR_IBAT0L] = 0x00000002;
+    ppc_state.spr[SPR_DBAT0U] = 0x80001fff;
+    ppc_state.spr[SPR_DBAT0L] = 0x00000002;
+    system.GetMMU().DBATUpdated();
+    system.GetMMU().IBATUpdated();
+  }
+  ~ScopedCPUCore()
+  {
+    m_system.GetCPU().Shutdown();
+    m_system.GetMemory().Shutdown();
+    m_system.GetExpansionInterface().Shutdown();
+    m_system.GetCoreTiming().Shutdown();
+  }
+
+  State Run(const TestCase& test_case)
+  {
+    auto& memory = m_system.GetMemory();
+    for (size_t i = 0; i < test_case.code.size(); i++)
+      memory.Write_U32(test_case.code[i], CODE_ADDRESS + static_cast<u32>(i * 4));
+    for (const u32 vector : EXCEPTION_VECTORS)
+      memory.Write_U32(END, vector);
+    memory.Write_U32(0x80000001, DATA_ADDRESS);
+    memory.Write_U32(0x7FFFFFFF, DATA_ADDRESS + 4);
+    memory.Write_U32(0x00000010, DATA_ADDRESS + 8);
+
+    auto& ppc_state = m_system.GetPPCState();
+    ppc_state.msr.Hex = 0;
+    ppc_state.msr.FP = test_case.fp_enabled;
+    ppc_state.msr.DR = 1;
+    ppc_state.msr.IR = 1;
+    PowerPC::MSRUpdated(ppc_state);
+    ppc_state.pc = CACHED_MEM1 | CODE_ADDRESS;
+    ppc_state.npc = CACHED_MEM1 | CODE_ADDRESS;
+    for (u32 i = 0; i < 32; i++)
+      ppc_state.gpr[i] = 0x100 + i * 0x11;
+    ppc_state.gpr[4] = test_case.r4;
+    ppc_state.gpr[DATA_REGISTER] = CACHED_MEM1 | DATA_ADDRESS;
+    ppc_state.ps[1].SetBoth(1.0, 1.0);
+    ppc_state.cr.Set(0);
+    ppc_state.SetXER(UReg_XER{0});
+    ppc_state.SetXER_SO(test_case.xer_so);
+    ppc_state.spr[SPR_CTR] = 2;
+    ppc_state.spr[SPR_SRR0] = 0;
+    ppc_state.spr[SPR_SRR1] = 0;
+
+    m_system.GetCoreTiming().ScheduleEvent(RUN_CYCLES, m_stop_event);
+    m_system.GetCPU().EnableStepping(false);
+    m_system.GetPowerPC().RunLoop();
+
+    State state;
+    std::copy(std::begin(ppc_state.gpr), std::end(ppc_state.gpr), state.gpr.begin());
+    state.f1 = ppc_state.ps[1].PS0AsU64();
+    state.cr = ppc_state.cr.Get();
+    state.xer = ppc_state.GetXER().Hex;
+    state.ctr = ppc_state.spr[SPR_CTR];
+    state.pc = ppc_state.pc;
+    state.msr = ppc_state.msr.Hex;
+    state.srr0 = ppc_state.spr[SPR_SRR0];
+    state.srr1 = ppc_state.spr[SPR_SRR1];
+    return state;
+  }
+
+private:
+  Core::System& m_system;
+  Sram m_sram{};
+  CoreTiming::EventType* m_stop_event = nullptr;
+};
+
+class ScopeInit final
+{
+public:
+  ScopeInit() : m_profile_path(File::CreateTempDir())
+  {
+    if (!UserDirectoryExists())
+      return;
+    Core::DeclareAsCPUThread();
+    UICommon::SetUserDirectory(m_profile_path);
+    Config::Init();
+    SConfig::Init();
+    Config::SetCurrent(Config::MAIN_SLOT_A, ExpansionInterface::EXIDeviceType::None);
+    Config::SetCurrent(Config::MAIN_SLOT_B, ExpansionInterface::EXIDeviceType::None);
+    Config::SetCurrent(Config::MAIN_SERIAL_PORT_1, ExpansionInterface::EXIDeviceType::None);
+  }
+  ~ScopeInit()
+  {
+    if (!UserDirectoryExists())
+      return;
+    SConfig::Shutdown();
+    Config::Shutdown();
+    Core::UndeclareAsCPUThread();
+    File::DeleteDirRecursively(m_profile_path);
+  }
+  bool UserDirectoryExists() const { return !m_profile_path.empty(); }
+
+private:
+  std::string m_profile_path;
+};
+}  // namespace
+
+class SuperinstructionTest : public ::testing::TestWithParam<TestCase>
+{
+};
+
+TEST_P(SuperinstructionTest, MatchesInterpreter)
+{
+  ScopeInit guard;
+  ASSERT_TRUE(guard.UserDirectoryExists());
+
+  auto& system = Core::System::GetInstance();
+  const TestCase& test_case = GetParam();
+
+  State expected, actual;
+  {
+    ScopedCPUCore interpreter(system, PowerPC::CPUCore::Interpreter);
+    expected = interpreter.Run(test_case);
+  }
+  {
+    ScopedCPUCore cached_interpreter(system, PowerPC::CPUCore::CachedInterpreter);
+    actual = cached_interpreter.Run(test_case);
+  }
+
+  for (u32 i = 0; i < 32; i++)
+    EXPECT_EQ(actual.gpr[i], expected.gpr[i]) << "r" << i;
+  EXPECT_EQ(actual.f1, expected.f1);
+  EXPECT_EQ(actual.cr, expected.cr);
+  EXPECT_EQ(actual.xer, expected.xer);
+  EXPECT_EQ(actual.ctr, expected.ctr);
+  EXPECT_EQ(actual.pc, expected.pc);
+  EXPECT_EQ(actual.msr, expected.msr);
+  EXPECT_EQ(actual.srr0, expected.srr0);
+  EXPECT_EQ(actual.srr1, expected.srr1);
+}
+
+INSTANTIATE_TEST_SUITE_P(CachedInterpreter, SuperinstructionTest,
+                         ::testing::ValuesIn(CreateTestCases()),
+                         [](const ::testing::TestParamInfo<TestCase>& info) {
+                           return info.param.name;
+                         });
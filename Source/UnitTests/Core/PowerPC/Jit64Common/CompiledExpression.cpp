@@ -0,0 +1,180 @@
+// Copyright 2026 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <optional>
+#include <string_view>
+
+#include <expr.h>
+
+#include "Common/BitUtils.h"
+#include "Common/CommonTypes.h"
+#include "Core/PowerPC/Expression.h"
+#include "Core/PowerPC/Gekko.h"
+#include "Core/PowerPC/PowerPC.h"
+#include "Core/System.h"
+
+#include <fmt/format.h>
+#include <gtest/gtest.h>
+
+namespace
+{
+template <typename T, typename U = T>
+double CastFunc(expr_func* f, vec_expr_t* args, void* c)
+{
+  if (vec_len(args) != 1)
+    return 0;
+  return Common::BitCast<T>(static_cast<U>(expr_eval(&vec_nth(args, 0))));
+}
+
+// The functions of Expression which compiled expressions may call, except for the memory reads.
+std::array<expr_func, 7> s_funcs{{
+    {"u8", CastFunc<u8>},
+    {"s8", CastFunc<s8, u8>},
+    {"u16", CastFunc<u16>},
+    {"s16", CastFunc<s16, u16>},
+    {"u32", CastFunc<u32>},
+    {"s32", CastFunc<s32, u32>},
+    {},
+}};
+
+double VariableValue(const PowerPC::PowerPCState& ppc_state, std::string_view name)
+{
+  if (name == "lr")
+    return static_cast<double>(ppc_state.spr[SPR_LR]);
+  if (name == "ctr")
+    return static_cast<double>(ppc_state.spr[SPR_CTR]);
+  if (name == "pc")
+    return static_cast<double>(ppc_state.pc);
+  if (name.length() >= 2 && name.length() <= 3 && (name[0] == 'r' || name[0] == 'f'))
+  {
+    const int index = std::atoi(name.data() + 1);
+    return name[0] == 'r' ? static_cast<double>(ppc_state.gpr[index]) :
+                            ppc_state.ps[index].PS0AsDouble();
+  }
+  return 0;
+}
+
+// Evaluates the expression with expr's interpreter, binding the variables like Expression does.
+double Interpret(const PowerPC::PowerPCState& ppc_state, std::string_view text)
+{
+  ExprVarListPointer vars{new expr_var_list{}};
+  ExprPointer e{expr_create(text.data(), text.length(), vars.get(), s_funcs.data())};
+  if (!e)
+    return std::numeric_limits<double>::quiet_NaN();
+
+  for (expr_var* v = vars->head; v != nullptr; v = v->next)
+    v->value = VariableValue(ppc_state, v->name);
+  return expr_eval(e.get());
+}
+
+void SetUpState(PowerPC::PowerPCState& ppc_state)
+{
+  ppc_state.gpr[0] = 0;
+  ppc_state.gpr[3] = 300;
+  ppc_state.gpr[4] = 7;
+  ppc_state.gpr[5] = 200;
+  ppc_state.gpr[6] = 40000;
+  ppc_state.gpr[7] = 3000000000;
+  ppc_state.gpr[31] = 12;
+  ppc_state.ps[1].SetPS0(2.5);
+  ppc_state.ps[2].SetPS0(-1.25);
+  ppc_state.ps[3].SetPS0(std::numeric_limits<double>::quiet_NaN());
+  ppc_state.ps[31].SetPS0(0.5);
+  ppc_state.spr[SPR_LR] = 0x80003100;
+  ppc_state.spr[SPR_CTR] = 5;
+  ppc_state.pc = 0x80004000;
+}
+}  // namespace
+
+TEST(CompiledExpression, MatchesInterpreter)
+{
+  static constexpr std::string_view expressions[]{
+      // Constants and variables
+      "42",
+      "-1.5",
+      "r3",
+      "f2",
+      "lr",
+      "ctr",
+      "pc",
+      "unknown + 1",
+      // Arithmetic
+      "1 + 2 * 3",
+      "r3 + r4",
+      "r3 - r4",
+      "r4 - r3",
+      "r3 * f1",
+      "r3 / r4",
+      "f1 / r0",
+      "r3 % r4",
+      "r4 ** 3",
+      "-r3",
+      "-f2",
+      // Comparisons
+      "r3 < r4",
+      "r3 <= r3",
+      "r3 > r4",
+      "r4 >= r3",
+      "r3 == 300",
+      "r3 != r4",
+      "f3 == f3",
+      "f3 != f3",
+      "f3 < 1",
+      // Integer operators
+      "~r3",
+      "r3 << r4",
+      "r3 >> 2",
+      "r3 & r4",
+      "r3 | r4",
+      "r3 ^ r6",
+      // Logical operators
+      "!r3",
+      "!r0",
+      "r3 && r0",
+      "r0 || r4",
+      "r3 && f2 < 0 || pc == 0",
+      "(r3, r4)",
+      // Casts
+      "u8(r5) + s8(r5)",
+      "u16(r6) + s16(r6)",
+      "u32(r7) + s32(r7)",
+      // Nesting
+      "((r3 + 1) * (r4 - 2)) / ((f1 + f2) * (r5 - r6)) + f31 * r31",
+      "lr == 2147496192 && ctr > 0 && (r3 & 1) == 0",
+  };
+
+  auto& ppc_state = Core::System::GetInstance().GetPPCState();
+  SetUpState(ppc_state);
+
+  for (const std::string_view text : expressions)
+  {
+    const std::optional<Expression> expression = Expression::TryParse(text);
+    ASSERT_TRUE(expression.has_value()) << text;
+    const Expression::CompiledFunction function = expression->GetCompiledFunction();
+    ASSERT_NE(function, nullptr) << text;
+
+    const double expected = Interpret(ppc_state, text);
+    const double actual = function(&ppc_state);
+
+    fmt::print("{} -> {} == {}\n", text, actual, expected);
+
+    if (std::isnan(expected))
+      EXPECT_TRUE(std::isnan(actual)) << text;
+    else
+      EXPECT_EQ(expected, actual) << text;
+  }
+}
+
+TEST(CompiledExpression, SideEffectsAreNotCompiled)
+{
+  for (const std::string_view text : {"r3 = 5", "write_u32(r3, r4)", "streq(r3, r4)"})
+  {
+    const std::optional<Expression> expression = Expression::TryParse(text);
+    ASSERT_TRUE(expression.has_value()) << text;
+    EXPECT_EQ(expression->GetCompiledFunction(), nullptr) << text;
+  }
+}
@@ -0,0 +1,188 @@
+// Copyright 2026 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <string>
+
+#include "Common/CommonTypes.h"
+#include "Common/Config/Config.h"
+#include "Common/FileUtil.h"
+#include "Core/Config/MainSettings.h"
+#include "Core/ConfigManager.h"
+#include "Core/Core.h"
+#include "Core/CoreTiming.h"
+#include "Core/HW/CPU.h"
+#include "Core/HW/EXI/EXI.h"
+#include "Core/HW/EXI/EXI_Device.h"
+#include "Core/HW/Memmap.h"
+#include "Core/HW/Sram.h"
+#include "Core/MemTools.h"
+#include "Core/PowerPC/Jit64/Jit.h"
+#include "Core/PowerPC/JitInterface.h"
+#include "Core/PowerPC/PowerPC.h"
+#include "Core/System.h"
+#include "UICommon/UICommon.h"
+
+#include <gtest/gtest.h>
+
+// With deferred compilation, Jit64 runs blocks through the interpreter the first few times they
+// are reached, and only compiles them once they keep getting reached.
+
+namespace
+{
+// Physical addresses. The code runs untranslated, as MSR.IR is off.
+constexpr u32 BLOCK_ADDRESS = 0x00010000;
+constexpr u32 OTHER_BLOCKS_ADDRESS = 0x00100000;
+
+constexpr u32 COUNTER_REGISTER = 31;
+
+constexpr u32 ADDI(u32 rd, u32 ra, u32 imm)
+{
+  return 14u << 26 | rd << 21 | ra << 16 | (imm & 0xFFFF);
+}
+
+constexpr u32 B(s32 offset)
+{
+  return 18u << 26 | (static_cast<u32>(offset) & 0x03FFFFFC);
+}
+
+// Brings up the subset of the emulated system that Jit64 needs to compile and interpret blocks.
+class ScopedJit64 final
+{
+public:
+  explicit ScopedJit64(Core::System& system) : m_system(system)
+  {
+    Config::SetCurrent(Config::MAIN_JIT_DEFERRED_COMPILATION, true);
+    system.Initialize();
+
+    system.GetCoreTiming().Init();
+    // Memory registers the MMIO handlers of the EXI channels, so they have to exist.
+    system.GetExpansionInterface().Init(&m_sram);
+    system.GetMemory().Init();
+    system.GetCPU().Init(PowerPC::CPUCore::JIT64);
+
+    auto& memory = system.GetMemory();
+    memory.Write_U32(ADDI(COUNTER_REGISTER, COUNTER_REGISTER, 1), BLOCK_ADDRESS);
+    memory.Write_U32(B(-4), BLOCK_ADDRESS + 4);
+    // Enough blocks which branch to themselves to fill up the interpreted run counts.
+    for (u32 i = 0; i < Jit64::DEFERRED_COMPILATION_MAX_TRACKED_BLOCKS; i++)
+      memory.Write_U32(B(0), OTHER_BLOCKS_ADDRESS + i * 4);
+
+    auto& ppc_state = system.GetPPCState();
+    ppc_state.msr.Hex = 0;
+    PowerPC::MSRUpdated(ppc_state);
+    ppc_state.gpr[COUNTER_REGISTER] = 0;
+  }
+  ~ScopedJit64()
+  {
+    m_system.GetCPU().Shutdown();
+    m_system.GetMemory().Shutdown();
+    m_system.GetExpansionInterface().Shutdown();
+    m_system.GetCoreTiming().Shutdown();
+
+    Config::SetCurrent(Config::MAIN_JIT_DEFERRED_COMPILATION, false);
+    m_system.Initialize();
+  }
+
+  // Does what the dispatcher does when it reaches a block which hasn't been compiled.
+  void Reach(u32 address)
+  {
+    auto& ppc_state = m_system.GetPPCState();
+    ppc_state.pc = address;
+    ppc_state.npc = address;
+    GetJit().Jit(address);
+  }
+
+  bool IsCompiled(u32 address)
+  {
+    const auto feature_flags = m_system.GetPPCState().feature_flags;
+    return GetJit().GetBlockCache()->GetBlockFromStartAddress(address, feature_flags) != nullptr;
+  }
+
+private:
+  Jit64& GetJit() { return static_cast<Jit64&>(*m_system.GetJitInterface().GetCore()); }
+
+  Core::System& m_system;
+  Sram m_sram{};
+};
+
+class ScopeInit final
+{
+public:
+  ScopeInit() : m_profile_path(File::CreateTempDir())
+  {
+    if (!UserDirectoryExists())
+      return;
+    Core::DeclareAsCPUThread();
+    UICommon::SetUserDirectory(m_profile_path);
+    Config::Init();
+    SConfig::Init();
+    Config::SetCurrent(Config::MAIN_SLOT_A, ExpansionInterface::EXIDeviceType::None);
+    Config::SetCurrent(Config::MAIN_SLOT_B, ExpansionInterface::EXIDeviceType::None);
+    Config::SetCurrent(Config::MAIN_SERIAL_PORT_1, ExpansionInterface::EXIDeviceType::None);
+    EMM::InstallExceptionHandler();
+  }
+  ~ScopeInit()
+  {
+    if (!UserDirectoryExists())
+      return;
+    EMM::UninstallExceptionHandler();
+    SConfig::Shutdown();
+    Config::Shutdown();
+    Core::UndeclareAsCPUThread();
+    File::DeleteDirRecursively(m_profile_path);
+  }
+  bool UserDirectoryExists() const { return !m_profile_path.empty(); }
+
+private:
+  std::string m_profile_path;
+};
+}  // namespace
+
+TEST(DeferredCompilation, CompiledAfterInterpretedRuns)
+{
+  ScopeInit guard;
+  ASSERT_TRUE(guard.UserDirectoryExists());
+
+  auto& system = Core::System::GetInstance();
+  auto& ppc_state = system.GetPPCState();
+  ScopedJit64 jit(system);
+
+  for (u32 i = 1; i <= Jit64::DEFERRED_COMPILATION_INTERPRETER_RUNS; i++)
+  {
+    jit.Reach(BLOCK_ADDRESS);
+    EXPECT_FALSE(jit.IsCompiled(BLOCK_ADDRESS));
+    EXPECT_EQ(ppc_state.gpr[COUNTER_REGISTER], i);
+    EXPECT_EQ(ppc_state.pc, BLOCK_ADDRESS);
+  }
+
+  // Compiling the block doesn't run it.
+  jit.Reach(BLOCK_ADDRESS);
+  EXPECT_TRUE(jit.IsCompiled(BLOCK_ADDRESS));
+  EXPECT_EQ(ppc_state.gpr[COUNTER_REGISTER], Jit64::DEFERRED_COMPILATION_INTERPRETER_RUNS);
+}
+
+TEST(DeferredCompilation, CountsResetWhenTooManyBlocksAreTracked)
+{
+  ScopeInit guard;
+  ASSERT_TRUE(guard.UserDirectoryExists());
+
+  auto& system = Core::System::GetInstance();
+  ScopedJit64 jit(system);
+
+  jit.Reach(BLOCK_ADDRESS);
+  // Together with the block above, this is the maximum number of tracked blocks.
+  for (u32 i = 0; i < Jit64::DEFERRED_COMPILATION_MAX_TRACKED_BLOCKS - 1; i++)
+    jit.Reach(OTHER_BLOCKS_ADDRESS + i * 4);
+  // One more block, and the counts start over.
+  jit.Reach(OTHER_BLOCKS_ADDRESS + (Jit64::DEFERRED_COMPILATION_MAX_TRACKED_BLOCKS - 1) * 4);
+  EXPECT_FALSE(jit.IsCompiled(BLOCK_ADDRESS));
+
+  // So the block gets all of its interpreted runs again.
+  for (u32 i = 0; i < Jit64::DEFERRED_COMPILATION_INTERPRETER_RUNS; i++)
+  {
+    jit.Reach(BLOCK_ADDRESS);
+    EXPECT_FALSE(jit.IsCompiled(BLOCK_ADDRESS));
+  }
+  jit.Reach(BLOCK_ADDRESS);
+  EXPECT_TRUE(jit.IsCompiled(BLOCK_ADDRESS));
+}
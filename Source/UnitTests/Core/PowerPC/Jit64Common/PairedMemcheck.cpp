@@ -0,0 +1,245 @@
+// Copyright 2026 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <iterator>
+#include <string>
+
+#include "Common/CommonTypes.h"
+#include "Common/Config/Config.h"
+#include "Common/FileUtil.h"
+#include "Core/Config/MainSettings.h"
+#include "Core/ConfigManager.h"
+#include "Core/Core.h"
+#include "Core/CoreTiming.h"
+#include "Core/HW/CPU.h"
+#include "Core/HW/EXI/EXI.h"
+#include "Core/HW/EXI/EXI_Device.h"
+#include "Core/HW/Memmap.h"
+#include "Core/HW/Sram.h"
+#include "Core/MemTools.h"
+#include "Core/PowerPC/MMU.h"
+#include "Core/PowerPC/PowerPC.h"
+#include "Core/System.h"
+#include "UICommon/UICommon.h"
+
+#include <gtest/gtest.h>
+
+// Jit64 specializes paired loads and stores for the value a GQR has when the block gets compiled,
+// if it can't assume the GQR to be constant for the whole block, and falls back to the generic
+// routines when the GQR has changed since. In MMU mode, DSIs raised by either path must be taken
+// before the instruction commits anything.
+
+namespace
+{
+// Physical addresses, which the code accesses through the cached MEM1 mirror at 0x80000000.
+constexpr u32 CODE_ADDRESS = 0x00010000;
+constexpr u32 DATA_ADDRESS = 0x00100000;
+constexpr u32 DSI_VECTOR = 0x00000300;
+constexpr u32 CACHED_MEM1 = 0x80000000;
+// Neither covered by the BATs nor by the (empty) page table.
+constexpr u32 UNMAPPED_ADDRESS = 0x40000000;
+
+constexpr u32 GQR_REGISTER = 4;
+constexpr u32 LOAD_REGISTER = 3;
+constexpr u32 STORE_REGISTER = 5;
+constexpr u32 COUNTER_REGISTER = 31;
+
+constexpr s64 RUN_CYCLES = 2000;
+
+// Loads and stores a pair of u8 values instead of floats.
+constexpr u32 GQR_U8 = 0x00040004;
+
+constexpr u32 MTSPR(u32 spr, u32 rs)
+{
+  return 31u << 26 | rs << 21 | (spr & 0x1F) << 16 | (spr >> 5) << 11 | 467u << 1;
+}
+
+// psq_lu and psq_stu, with W = 0 and I = 1.
+constexpr u32 PSQUpdateForm(u32 opcode, u32 frd, u32 ra, u32 offset)
+{
+  return opcode << 26 | frd << 21 | ra << 16 | 1u << 12 | (offset & 0xFFF);
+}
+
+constexpr u32 ADDI(u32 rd, u32 ra, u32 imm)
+{
+  return 14u << 26 | rd << 21 | ra << 16 | (imm & 0xFFFF);
+}
+
+constexpr u32 B(s32 offset)
+{
+  return 18u << 26 | (static_cast<u32>(offset) & 0x03FFFFFC);
+}
+
+// As GQR1 is written within the block, the JIT can't treat it as constant.
+constexpr u32 CODE[]{
+    MTSPR(SPR_GQR0 + 1, GQR_REGISTER),            // mtspr GQR1, r4
+    PSQUpdateForm(57, 1, LOAD_REGISTER, 8),       // psq_lu f1, 8(r3), 0, 1
+    PSQUpdateForm(61, 1, STORE_REGISTER, 8),      // psq_stu f1, 8(r5), 0, 1
+    ADDI(COUNTER_REGISTER, COUNTER_REGISTER, 1),  // addi r31, r31, 1
+    B(-16),                                       // b 0
+};
+
+void StopCallback(Core::System& system, u64 userdata, s64 cycles_late)
+{
+  system.GetCPU().Break();
+}
+
+// Brings up the subset of the emulated system that Jit64 needs to run guest code in MMU mode.
+class ScopedJit64 final
+{
+public:
+  ScopedJit64(Core::System& system, bool fastmem) : m_system(system)
+  {
+    Config::SetCurrent(Config::MAIN_FASTMEM, fastmem);
+    Config::SetCurrent(Config::MAIN_MMU, true);
+    system.Initialize();
+
+    system.GetCoreTiming().Init();
+    m_stop_event = system.GetCoreTiming().RegisterEvent("PairedMemcheckStop", StopCallback);
+    // Memory registers the MMIO handlers of the EXI channels, so they have to exist.
+    system.GetExpansionInterface().Init(&m_sram);
+    system.GetMemory().Init();
+    system.GetCPU().Init(PowerPC::CPUCore::JIT64);
+
+    // Map the first 256 MiB of physical memory to 0x80000000, like the BAT setup of games.
+    auto& ppc_state = system.GetPPCState();
+    ppc_state.spr[SPR_IBAT0U] = 0x80001fff;
+    ppc_state.spr[SPR_IBAT0L] = 0x00000002;
+    ppc_state.spr[SPR_DBAT0U] = 0x80001fff;
+    ppc_state.spr[SPR_DBAT0L] = 0x00000002;
+    ppc_state.spr[SPR_SDR] = 0;
+    system.GetMMU().DBATUpdated();
+    system.GetMMU().IBATUpdated();
+
+    auto& memory = system.GetMemory();
+    for (u32 i = 0; i < std::size(CODE); i++)
+      memory.Write_U32(CODE[i], CODE_ADDRESS + i * 4);
+    memory.Write_U32(B(0), DSI_VECTOR);
+    memory.Write_U32(0x40000000, DATA_ADDRESS);      // 2.0f
+    memory.Write_U32(0x40400000, DATA_ADDRESS + 4);  // 3.0f
+  }
+  ~ScopedJit64()
+  {
+    m_system.GetCPU().Shutdown();
+    m_system.GetMemory().Shutdown();
+    m_system.GetExpansionInterface().Shutdown();
+    m_system.GetCoreTiming().Shutdown();
+
+    Config::SetCurrent(Config::MAIN_MMU, false);
+    m_system.Initialize();
+  }
+
+  void Run(u32 gqr, u32 load_address, u32 store_address)
+  {
+    auto& ppc_state = m_system.GetPPCState();
+    ppc_state.msr.Hex = 0;
+    ppc_state.msr.FP = 1;
+    ppc_state.msr.DR = 1;
+    ppc_state.msr.IR = 1;
+    PowerPC::MSRUpdated(ppc_state);
+    HID2(ppc_state).PSE = 1;
+    HID2(ppc_state).LSQE = 1;
+    ppc_state.pc = CACHED_MEM1 | CODE_ADDRESS;
+    ppc_state.npc = CACHED_MEM1 | CODE_ADDRESS;
+    ppc_state.spr[SPR_SRR0] = 0;
+    ppc_state.spr[SPR_DAR] = 0;
+
+    ppc_state.gpr[GQR_REGISTER] = gqr;
+    ppc_state.gpr[LOAD_REGISTER] = load_address;
+    ppc_state.gpr[STORE_REGISTER] = store_address;
+    ppc_state.gpr[COUNTER_REGISTER] = 0;
+
+    m_system.GetCoreTiming().ScheduleEvent(RUN_CYCLES, m_stop_event);
+    m_system.GetCPU().EnableStepping(false);
+    m_system.GetPowerPC().RunLoop();
+  }
+
+private:
+  Core::System& m_system;
+  Sram m_sram{};
+  CoreTiming::EventType* m_stop_event = nullptr;
+};
+
+class ScopeInit final
+{
+public:
+  ScopeInit() : m_profile_path(File::CreateTempDir())
+  {
+    if (!UserDirectoryExists())
+      return;
+    Core::DeclareAsCPUThread();
+    UICommon::SetUserDirectory(m_profile_path);
+    Config::Init();
+    SConfig::Init();
+    Config::SetCurrent(Config::MAIN_SLOT_A, ExpansionInterface::EXIDeviceType::None);
+    Config::SetCurrent(Config::MAIN_SLOT_B, ExpansionInterface::EXIDeviceType::None);
+    Config::SetCurrent(Config::MAIN_SERIAL_PORT_1, ExpansionInterface::EXIDeviceType::None);
+    EMM::InstallExceptionHandler();
+  }
+  ~ScopeInit()
+  {
+    if (!UserDirectoryExists())
+      return;
+    EMM::UninstallExceptionHandler();
+    SConfig::Shutdown();
+    Config::Shutdown();
+    Core::UndeclareAsCPUThread();
+    File::DeleteDirRecursively(m_profile_path);
+  }
+  bool UserDirectoryExists() const { return !m_profile_path.empty(); }
+
+private:
+  std::string m_profile_path;
+};
+}  // namespace
+
+class PairedMemcheckTest : public ::testing::TestWithParam<bool>
+{
+};
+
+TEST_P(PairedMemcheckTest, GQRChangedAfterCompilation)
+{
+  ScopeInit guard;
+  ASSERT_TRUE(guard.UserDirectoryExists());
+
+  auto& system = Core::System::GetInstance();
+  auto& ppc_state = system.GetPPCState();
+  ScopedJit64 jit(system, GetParam());
+
+  constexpr u32 data = CACHED_MEM1 | DATA_ADDRESS;
+  constexpr u32 code = CACHED_MEM1 | CODE_ADDRESS;
+
+  // Compiles the block while GQR1 is zero, so that it gets specialized for float pairs.
+  jit.Run(0, data - 8, data);
+  ASSERT_NE(ppc_state.gpr[COUNTER_REGISTER], 0u);
+
+  // The load raises a DSI through the generic routines.
+  jit.Run(GQR_U8, UNMAPPED_ADDRESS, data);
+  EXPECT_EQ(ppc_state.pc, DSI_VECTOR);
+  EXPECT_EQ(ppc_state.spr[SPR_SRR0], code + 4);
+  EXPECT_EQ(ppc_state.spr[SPR_DAR], UNMAPPED_ADDRESS + 8);
+  EXPECT_EQ(ppc_state.gpr[LOAD_REGISTER], UNMAPPED_ADDRESS);
+  EXPECT_EQ(ppc_state.gpr[STORE_REGISTER], data);
+  EXPECT_EQ(ppc_state.gpr[COUNTER_REGISTER], 0u);
+
+  // The store raises a DSI through the generic routines.
+  jit.Run(GQR_U8, data - 8, UNMAPPED_ADDRESS);
+  EXPECT_EQ(ppc_state.pc, DSI_VECTOR);
+  EXPECT_EQ(ppc_state.spr[SPR_SRR0], code + 8);
+  EXPECT_EQ(ppc_state.spr[SPR_DAR], UNMAPPED_ADDRESS + 8);
+  EXPECT_EQ(ppc_state.gpr[LOAD_REGISTER], data);
+  EXPECT_EQ(ppc_state.gpr[STORE_REGISTER], UNMAPPED_ADDRESS);
+  EXPECT_EQ(ppc_state.gpr[COUNTER_REGISTER], 0u);
+
+  // The specialized code still raises DSIs once GQR1 is back to the value it was compiled for.
+  jit.Run(0, UNMAPPED_ADDRESS, data);
+  EXPECT_EQ(ppc_state.pc, DSI_VECTOR);
+  EXPECT_EQ(ppc_state.spr[SPR_SRR0], code + 4);
+  EXPECT_EQ(ppc_state.gpr[LOAD_REGISTER], UNMAPPED_ADDRESS);
+  EXPECT_EQ(ppc_state.gpr[COUNTER_REGISTER], 0u);
+}
+
+INSTANTIATE_TEST_SUITE_P(Jit64, PairedMemcheckTest, ::testing::Bool(),
+                         [](const ::testing::TestParamInfo<bool>& info) {
+                           return info.param ? "Fastmem" : "NoFastmem";
+                         });
@@ -0,0 +1,178 @@
+// Copyright 2026 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <chrono>
+#include <memory>
+#include <set>
+
+#include <fmt/format.h>
+
+#include "Common/CommonTypes.h"
+#include "Core/PowerPC/JitCommon/JitBase.h"
+#include "Core/PowerPC/JitCommon/JitCache.h"
+#include "Core/PowerPC/PowerPC.h"
+#include "Core/System.h"
+
+#include <gtest/gtest.h>
+
+namespace
+{
+class BlockCacheFakeJit : public JitBase
+{
+public:
+  explicit BlockCacheFakeJit(Core::System& system) : JitBase(system) {}
+
+  // CPUCoreBase methods
+  void Init() override {}
+  void Shutdown() override {}
+  void ClearCache() override {}
+  void Run() override {}
+  void SingleStep() override {}
+  const char* GetName() const override { return nullptr; }
+  // JitBase methods
+  JitBaseBlockCache* GetBlockCache() override { return nullptr; }
+  void Jit(u32 em_address) override {}
+  const CommonAsmRoutinesBase* GetAsmRoutines() override { return nullptr; }
+  bool HandleFault(uintptr_t access_address, SContext* ctx) override { return false; }
+};
+
+class TestBlockCache final : public JitBaseBlockCache
+{
+public:
+  explicit TestBlockCache(JitBase& jit) : JitBaseBlockCache(jit) {}
+
+  JitBlock* AddBlock(u32 address, u32 num_instructions, u32 exit_address)
+  {
+    JitBlock* block = AllocateBlock(address);
+
+    JitBlock::LinkData link_data{};
+    link_data.exitAddress = exit_address;
+    block->linkData.push_back(link_data);
+
+    std::set<u32> physical_addresses;
+    for (u32 i = 0; i < num_instructions; i++)
+      physical_addresses.insert(address + i * 4);
+    FinalizeBlock(*block, true, physical_addresses);
+    return block;
+  }
+
+  int linked_exits = 0;
+
+private:
+  void WriteLinkBlock(const JitBlock::LinkData& source, const JitBlock* dest) override
+  {
+    if (dest && !source.linkStatus)
+      linked_exits++;
+    else if (!dest && source.linkStatus)
+      linked_exits--;
+  }
+};
+
+// Blocks of 0x60 bytes, so that some of them span two ranges of the block range map.
+constexpr u32 BLOCK_INSTRUCTIONS = 0x18;
+constexpr u32 BLOCK_SIZE = BLOCK_INSTRUCTIONS * 4;
+constexpr u32 BASE_ADDRESS = 0x00100000;
+
+u32 BlockAddress(u32 index)
+{
+  return BASE_ADDRESS + index * BLOCK_SIZE;
+}
+}  // namespace
+
+TEST(JitBlockCache, LookupLinkAndErase)
+{
+  auto& system = Core::System::GetInstance();
+  BlockCacheFakeJit jit(system);
+  TestBlockCache cache(jit);
+  cache.Clear();
+
+  constexpr u32 NUM_BLOCKS = 64;
+  for (u32 i = 0; i < NUM_BLOCKS; i++)
+    cache.AddBlock(BlockAddress(i), BLOCK_INSTRUCTIONS, BlockAddress((i + 1) % NUM_BLOCKS));
+
+  // Every block links to the next one, and the last one back to the first.
+  EXPECT_EQ(cache.linked_exits, static_cast<int>(NUM_BLOCKS));
+
+  const CPUEmuFeatureFlags feature_flags = jit.m_ppc_state.feature_flags;
+  for (u32 i = 0; i < NUM_BLOCKS; i++)
+  {
+    const JitBlock* block = cache.GetBlockFromStartAddress(BlockAddress(i), feature_flags);
+    ASSERT_NE(block, nullptr);
+    EXPECT_EQ(block->effectiveAddress, BlockAddress(i));
+  }
+  EXPECT_EQ(cache.GetBlockFromStartAddress(BlockAddress(0) + 4, feature_flags), nullptr);
+
+  int visited_blocks = 0;
+  cache.RunOnBlocks([&visited_blocks](const JitBlock&) { visited_blocks++; });
+  EXPECT_EQ(visited_blocks, static_cast<int>(NUM_BLOCKS));
+
+  // Erase a single instruction in the middle of block 10, and the first instruction of block 20.
+  cache.ErasePhysicalRange(BlockAddress(10) + 0x20, 4);
+  cache.ErasePhysicalRange(BlockAddress(20), 4);
+  EXPECT_EQ(cache.GetBlockFromStartAddress(BlockAddress(10), feature_flags), nullptr);
+  EXPECT_EQ(cache.GetBlockFromStartAddress(BlockAddress(20), feature_flags), nullptr);
+  EXPECT_NE(cache.GetBlockFromStartAddress(BlockAddress(11), feature_flags), nullptr);
+  EXPECT_NE(cache.GetBlockFromStartAddress(BlockAddress(19), feature_flags), nullptr);
+
+  // The exits of the erased blocks, and the exits of blocks 9 and 19 pointing to them, are gone.
+  EXPECT_EQ(cache.linked_exits, static_cast<int>(NUM_BLOCKS - 4));
+
+  // Recompiling a block relinks the exits pointing to it.
+  cache.AddBlock(BlockAddress(10), BLOCK_INSTRUCTIONS, BlockAddress(11));
+  EXPECT_EQ(cache.linked_exits, static_cast<int>(NUM_BLOCKS - 2));
+
+  // Erase a range covering blocks 30 to 39 partially or fully.
+  cache.ErasePhysicalRange(BlockAddress(30) + 4, BLOCK_SIZE * 9);
+  for (u32 i = 30; i < 40; i++)
+    EXPECT_EQ(cache.GetBlockFromStartAddress(BlockAddress(i), feature_flags), nullptr);
+  EXPECT_NE(cache.GetBlockFromStartAddress(BlockAddress(40), feature_flags), nullptr);
+
+  visited_blocks = 0;
+  cache.RunOnBlocks([&visited_blocks](const JitBlock&) { visited_blocks++; });
+  EXPECT_EQ(visited_blocks, static_cast<int>(NUM_BLOCKS - 11));
+
+  cache.Clear();
+  visited_blocks = 0;
+  cache.RunOnBlocks([&visited_blocks](const JitBlock&) { visited_blocks++; });
+  EXPECT_EQ(visited_blocks, 0);
+  EXPECT_EQ(cache.linked_exits, 0);
+}
+
+// Simulates a title streaming code overlays: a large number of blocks gets invalidated cache line
+// by cache line and compiled again.
+TEST(JitBlockCache, InvalidateBenchmark)
+{
+  auto& system = Core::System::GetInstance();
+  BlockCacheFakeJit jit(system);
+  TestBlockCache cache(jit);
+  cache.Clear();
+
+  constexpr u32 NUM_BLOCKS = 0x4000;
+  constexpr int NUM_ROUNDS = 8;
+  for (u32 i = 0; i < NUM_BLOCKS; i++)
+    cache.AddBlock(BlockAddress(i), BLOCK_INSTRUCTIONS, BlockAddress((i + 1) % NUM_BLOCKS));
+
+  const CPUEmuFeatureFlags feature_flags = jit.m_ppc_state.feature_flags;
+  const auto start = std::chrono::high_resolution_clock::now();
+  for (int round = 0; round < NUM_ROUNDS; round++)
+  {
+    for (u32 address = BlockAddress(0); address < BlockAddress(NUM_BLOCKS); address += 32)
+      cache.ErasePhysicalRange(address, 32);
+    for (u32 i = 0; i < NUM_BLOCKS; i++)
+      cache.AddBlock(BlockAddress(i), BLOCK_INSTRUCTIONS, BlockAddress((i + 1) % NUM_BLOCKS));
+  }
+  const auto end = std::chrono::high_resolution_clock::now();
+
+  for (u32 i = 0; i < NUM_BLOCKS; i++)
+    EXPECT_NE(cache.GetBlockFromStartAddress(BlockAddress(i), feature_flags), nullptr);
+  EXPECT_EQ(cache.linked_exits, static_cast<int>(NUM_BLOCKS));
+
+  const auto nanoseconds =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+  fmt::print("block cache invalidation timing:\n");
+  fmt::print("{} blocks invalidated and recompiled per round, {} rounds\n", NUM_BLOCKS, NUM_ROUNDS);
+  fmt::print("per block              {} ns\n", nanoseconds / (NUM_BLOCKS * NUM_ROUNDS));
+  fmt::print("total                  {} ns\n", nanoseconds);
+
+  cache.Clear();
+}
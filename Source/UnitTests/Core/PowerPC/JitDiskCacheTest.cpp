@@ -0,0 +1,145 @@
+// Copyright 2026 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <string>
+
+#include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "Core/PowerPC/JitCommon/JitDiskCache.h"
+#include "Core/PowerPC/PPCAnalyst.h"
+#include "UICommon/UICommon.h"
+
+#include <gtest/gtest.h>
+
+namespace
+{
+constexpr char GAME_ID[] = "GTEST1";
+constexpr u32 FEATURE_FLAGS = 0;
+
+constexpr u32 BLOCK_ADDRESS = 0x80003100;
+constexpr u32 OTHER_BLOCK_ADDRESS = 0x80003180;
+
+class JitDiskCacheTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_profile_path = File::CreateTempDir();
+    ASSERT_FALSE(m_profile_path.empty());
+    UICommon::SetUserDirectory(m_profile_path);
+    File::CreateFullPath(File::GetUserPath(D_CACHE_IDX));
+
+    m_code_block.m_num_instructions = 2;
+    m_code_buffer.resize(2);
+    SetCode(BLOCK_ADDRESS, 0x38600000);  // li r3, 0
+  }
+
+  void TearDown() override
+  {
+    if (!m_profile_path.empty())
+      File::DeleteDirRecursively(m_profile_path);
+  }
+
+  // A block made of the given instruction and a blr.
+  void SetCode(u32 address, u32 inst)
+  {
+    m_code_buffer[0].address = address;
+    m_code_buffer[0].inst.hex = inst;
+    m_code_buffer[1].address = address + 4;
+    m_code_buffer[1].inst.hex = 0x4e800020;
+  }
+
+  u64 Hash(JitDiskCache& cache)
+  {
+    return cache.HashCodeBlock(m_code_block, m_code_buffer, FEATURE_FLAGS);
+  }
+
+  PPCAnalyst::CodeBlock m_code_block;
+  PPCAnalyst::CodeBuffer m_code_buffer;
+
+private:
+  std::string m_profile_path;
+};
+}  // namespace
+
+TEST_F(JitDiskCacheTest, HashDependsOnCode)
+{
+  JitDiskCache cache;
+  const u64 hash = Hash(cache);
+  EXPECT_EQ(Hash(cache), hash);
+
+  SetCode(BLOCK_ADDRESS, 0x38600001);  // li r3, 1
+  EXPECT_NE(Hash(cache), hash);
+  SetCode(OTHER_BLOCK_ADDRESS, 0x38600000);  // li r3, 0
+  EXPECT_NE(Hash(cache), hash);
+  SetCode(BLOCK_ADDRESS, 0x38600000);
+  EXPECT_EQ(Hash(cache), hash);
+  EXPECT_NE(cache.HashCodeBlock(m_code_block, m_code_buffer, FEATURE_FLAGS + 1), hash);
+}
+
+TEST_F(JitDiskCacheTest, RoundTrip)
+{
+  u64 hash, other_hash;
+  {
+    JitDiskCache cache;
+    cache.SetGameID(GAME_ID);
+    ASSERT_TRUE(cache.IsOpen());
+
+    hash = Hash(cache);
+    cache.RecordBlock(BLOCK_ADDRESS, FEATURE_FLAGS, hash);
+    SetCode(OTHER_BLOCK_ADDRESS, 0x38600001);
+    other_hash = Hash(cache);
+    cache.RecordBlock(OTHER_BLOCK_ADDRESS, FEATURE_FLAGS, other_hash);
+
+    // Blocks recorded in this session aren't prefetched in it.
+    EXPECT_FALSE(cache.HasEntry(BLOCK_ADDRESS, FEATURE_FLAGS));
+  }
+
+  JitDiskCache cache;
+  cache.SetGameID(GAME_ID);
+  EXPECT_TRUE(cache.HasEntry(BLOCK_ADDRESS, FEATURE_FLAGS));
+  EXPECT_TRUE(cache.HasEntry(OTHER_BLOCK_ADDRESS, FEATURE_FLAGS));
+  EXPECT_FALSE(cache.HasEntry(BLOCK_ADDRESS, FEATURE_FLAGS + 1));
+  EXPECT_FALSE(cache.HasEntry(BLOCK_ADDRESS + 4, FEATURE_FLAGS));
+
+  EXPECT_TRUE(cache.TakeEntry(BLOCK_ADDRESS, FEATURE_FLAGS, hash));
+  EXPECT_FALSE(cache.HasEntry(BLOCK_ADDRESS, FEATURE_FLAGS));
+  EXPECT_TRUE(cache.HasEntry(OTHER_BLOCK_ADDRESS, FEATURE_FLAGS));
+  EXPECT_TRUE(cache.TakeEntry(OTHER_BLOCK_ADDRESS, FEATURE_FLAGS, other_hash));
+
+  // Closing the cache without anything new to record keeps the entries in the file.
+  cache.Close();
+  cache.SetGameID(GAME_ID);
+  EXPECT_TRUE(cache.HasEntry(BLOCK_ADDRESS, FEATURE_FLAGS));
+}
+
+TEST_F(JitDiskCacheTest, RejectsChangedCode)
+{
+  u64 hash;
+  {
+    JitDiskCache cache;
+    cache.SetGameID(GAME_ID);
+    hash = Hash(cache);
+    cache.RecordBlock(BLOCK_ADDRESS, FEATURE_FLAGS, hash);
+  }
+
+  JitDiskCache cache;
+  cache.SetGameID(GAME_ID);
+  ASSERT_TRUE(cache.HasEntry(BLOCK_ADDRESS, FEATURE_FLAGS));
+
+  // Different code at the same address, e.g. from an overlay.
+  SetCode(BLOCK_ADDRESS, 0x38600001);
+  EXPECT_FALSE(cache.TakeEntry(BLOCK_ADDRESS, FEATURE_FLAGS, Hash(cache)));
+  // The stale entry is gone, so the block isn't analyzed just to be rejected again.
+  EXPECT_FALSE(cache.HasEntry(BLOCK_ADDRESS, FEATURE_FLAGS));
+
+  // The new code gets recorded next to the old entry.
+  const u64 new_hash = Hash(cache);
+  cache.RecordBlock(BLOCK_ADDRESS, FEATURE_FLAGS, new_hash);
+  cache.Close();
+  cache.SetGameID(GAME_ID);
+  EXPECT_TRUE(cache.TakeEntry(BLOCK_ADDRESS, FEATURE_FLAGS, new_hash));
+  cache.Close();
+  cache.SetGameID(GAME_ID);
+  EXPECT_TRUE(cache.TakeEntry(BLOCK_ADDRESS, FEATURE_FLAGS, hash));
+}
@@ -0,0 +1,238 @@
+// Copyright 2026 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <initializer_list>
+#include <string>
+
+#include "Common/CommonTypes.h"
+#include "Common/Config/Config.h"
+#include "Common/FileUtil.h"
+#include "Core/Config/MainSettings.h"
+#include "Core/ConfigManager.h"
+#include "Core/Core.h"
+#include "Core/HW/EXI/EXI.h"
+#include "Core/HW/EXI/EXI_Device.h"
+#include "Core/HW/Memmap.h"
+#include "Core/HW/Sram.h"
+#include "Core/PowerPC/Gekko.h"
+#include "Core/PowerPC/PPCAnalyst.h"
+#include "Core/System.h"
+#include "UICommon/UICommon.h"
+
+#include <gtest/gtest.h>
+
+namespace
+{
+// Physical addresses. Instructions are fetched untranslated, as MSR.IR is off.
+constexpr u32 LOOP_ADDRESS = 0x00010000;
+constexpr u32 FUNCTION_ADDRESS = 0x00010100;
+
+constexpr u32 BLR = 0x4e800020;
+constexpr u32 BCTR = 0x4e800420;
+constexpr u32 BEQLR = 0x4d820020;
+constexpr u32 NOP = 0x60000000;
+
+constexpr u32 LWZ(u32 rd, u32 ra, u32 offset)
+{
+  return 32u << 26 | rd << 21 | ra << 16 | (offset & 0xFFFF);
+}
+
+constexpr u32 STW(u32 rs, u32 ra, u32 offset)
+{
+  return 36u << 26 | rs << 21 | ra << 16 | (offset & 0xFFFF);
+}
+
+constexpr u32 MTSPR(u32 spr, u32 rs)
+{
+  return 31u << 26 | rs << 21 | (spr & 0x1F) << 16 | (spr >> 5) << 11 | 467u << 1;
+}
+
+constexpr u32 MFTBL(u32 rd)
+{
+  return 31u << 26 | rd << 21 | (SPR_TL & 0x1F) << 16 | (SPR_TL >> 5) << 11 | 371u << 1;
+}
+
+constexpr u32 CMPWI(u32 ra, u32 imm)
+{
+  return 11u << 26 | ra << 16 | (imm & 0xFFFF);
+}
+
+constexpr u32 B(s32 offset, bool link = false)
+{
+  return 18u << 26 | (static_cast<u32>(offset) & 0x03FFFFFC) | (link ? 1 : 0);
+}
+
+constexpr u32 BL(s32 offset)
+{
+  return B(offset, true);
+}
+
+// beq cr0, with BO = 12 (branch if the condition is true) and BI = 2 (cr0.eq).
+constexpr u32 BEQ(s32 offset)
+{
+  return 16u << 26 | 12u << 21 | 2u << 16 | (static_cast<u32>(offset) & 0xFFFC);
+}
+
+class PPCAnalystTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_profile_path = File::CreateTempDir();
+    ASSERT_FALSE(m_profile_path.empty());
+    Core::DeclareAsCPUThread();
+    UICommon::SetUserDirectory(m_profile_path);
+    Config::Init();
+    SConfig::Init();
+    // Memory registers the MMIO handlers of the EXI channels, so they have to exist.
+    Config::SetCurrent(Config::MAIN_SLOT_A, ExpansionInterface::EXIDeviceType::None);
+    Config::SetCurrent(Config::MAIN_SLOT_B, ExpansionInterface::EXIDeviceType::None);
+    Config::SetCurrent(Config::MAIN_SERIAL_PORT_1, ExpansionInterface::EXIDeviceType::None);
+
+    auto& system = Core::System::GetInstance();
+    system.GetExpansionInterface().Init(&m_sram);
+    system.GetMemory().Init();
+
+    m_code_block.m_stats = &m_stats;
+    m_code_block.m_gpa = &m_gpa;
+    m_code_block.m_fpa = &m_fpa;
+    m_code_buffer.resize(32);
+
+    m_analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_LEAF_FUNCTION_INLINE);
+    m_analyzer.SetLeafFunctionInliningEnabled(true);
+  }
+
+  void TearDown() override
+  {
+    if (m_profile_path.empty())
+      return;
+    auto& system = Core::System::GetInstance();
+    system.GetMemory().Shutdown();
+    system.GetExpansionInterface().Shutdown();
+    SConfig::Shutdown();
+    Config::Shutdown();
+    Core::UndeclareAsCPUThread();
+    File::DeleteDirRecursively(m_profile_path);
+  }
+
+  static void WriteCode(u32 address, std::initializer_list<u32> code)
+  {
+    auto& memory = Core::System::GetInstance().GetMemory();
+    for (const u32 inst : code)
+    {
+      memory.Write_U32(inst, address);
+      address += 4;
+    }
+  }
+
+  // Polls the value returned by the function at FUNCTION_ADDRESS until it isn't zero.
+  static void WritePollingLoop()
+  {
+    WriteCode(LOOP_ADDRESS, {
+                                BL(FUNCTION_ADDRESS - LOOP_ADDRESS),  // bl function
+                                CMPWI(3, 0),                          // cmpwi r3, 0
+                                BEQ(-8),                              // beq loop
+                            });
+  }
+
+  const PPCAnalyst::CodeOp& AnalyzeLoop()
+  {
+    m_analyzer.Analyze(LOOP_ADDRESS, &m_code_block, &m_code_buffer, m_code_buffer.size());
+    return m_code_buffer[m_code_block.m_num_instructions - 1];
+  }
+
+  PPCAnalyst::PPCAnalyzer m_analyzer;
+  PPCAnalyst::CodeBlock m_code_block;
+  PPCAnalyst::CodeBuffer m_code_buffer;
+
+private:
+  std::string m_profile_path;
+  Sram m_sram{};
+  PPCAnalyst::BlockStats m_stats;
+  PPCAnalyst::BlockRegStats m_gpa;
+  PPCAnalyst::BlockRegStats m_fpa;
+};
+}  // namespace
+
+TEST_F(PPCAnalystTest, SideEffectFreeLeafFunction)
+{
+  WriteCode(FUNCTION_ADDRESS, {LWZ(3, 4, 0), MFTBL(5), BLR});
+  EXPECT_TRUE(m_analyzer.IsSideEffectFreeLeafFunction(FUNCTION_ADDRESS));
+
+  // The blr has to be within the first MAX_INLINED_LEAF_FUNCTION_SIZE instructions.
+  for (u32 i = 0; i < PPCAnalyst::PPCAnalyzer::MAX_INLINED_LEAF_FUNCTION_SIZE - 1; i++)
+    WriteCode(FUNCTION_ADDRESS + i * 4, {NOP});
+  WriteCode(FUNCTION_ADDRESS + (PPCAnalyst::PPCAnalyzer::MAX_INLINED_LEAF_FUNCTION_SIZE - 1) * 4,
+            {BLR});
+  EXPECT_TRUE(m_analyzer.IsSideEffectFreeLeafFunction(FUNCTION_ADDRESS));
+  WriteCode(FUNCTION_ADDRESS + (PPCAnalyst::PPCAnalyzer::MAX_INLINED_LEAF_FUNCTION_SIZE - 1) * 4,
+            {NOP, BLR});
+  EXPECT_FALSE(m_analyzer.IsSideEffectFreeLeafFunction(FUNCTION_ADDRESS));
+}
+
+TEST_F(PPCAnalystTest, LeafFunctionWithSideEffects)
+{
+  // Stores
+  WriteCode(FUNCTION_ADDRESS, {LWZ(3, 4, 0), STW(3, 4, 4), BLR});
+  EXPECT_FALSE(m_analyzer.IsSideEffectFreeLeafFunction(FUNCTION_ADDRESS));
+
+  // SPR writes
+  WriteCode(FUNCTION_ADDRESS, {LWZ(3, 4, 0), MTSPR(SPR_SRR0, 3), BLR});
+  EXPECT_FALSE(m_analyzer.IsSideEffectFreeLeafFunction(FUNCTION_ADDRESS));
+  WriteCode(FUNCTION_ADDRESS, {LWZ(3, 4, 0), MTSPR(SPR_LR, 3), BLR});
+  EXPECT_FALSE(m_analyzer.IsSideEffectFreeLeafFunction(FUNCTION_ADDRESS));
+}
+
+TEST_F(PPCAnalystTest, NonLeafFunction)
+{
+  // Nested call
+  WriteCode(FUNCTION_ADDRESS, {LWZ(3, 4, 0), BL(0x100), BLR});
+  EXPECT_FALSE(m_analyzer.IsSideEffectFreeLeafFunction(FUNCTION_ADDRESS));
+
+  // Exits other than a plain blr
+  WriteCode(FUNCTION_ADDRESS, {LWZ(3, 4, 0), B(0x100), BLR});
+  EXPECT_FALSE(m_analyzer.IsSideEffectFreeLeafFunction(FUNCTION_ADDRESS));
+  WriteCode(FUNCTION_ADDRESS, {LWZ(3, 4, 0), BCTR});
+  EXPECT_FALSE(m_analyzer.IsSideEffectFreeLeafFunction(FUNCTION_ADDRESS));
+  WriteCode(FUNCTION_ADDRESS, {CMPWI(3, 0), BEQLR, BLR});
+  EXPECT_FALSE(m_analyzer.IsSideEffectFreeLeafFunction(FUNCTION_ADDRESS));
+}
+
+TEST_F(PPCAnalystTest, InlinedPollingLoopIsIdleLoop)
+{
+  WritePollingLoop();
+  WriteCode(FUNCTION_ADDRESS, {LWZ(3, 4, 0), BLR});
+
+  const PPCAnalyst::CodeOp& branch = AnalyzeLoop();
+  // bl, lwz, blr, cmpwi, beq
+  EXPECT_EQ(m_code_block.m_num_instructions, 5u);
+  EXPECT_EQ(branch.address, LOOP_ADDRESS + 8);
+  EXPECT_TRUE(branch.branchIsIdleLoop);
+}
+
+TEST_F(PPCAnalystTest, PollingLoopWithStoreIsNotInlined)
+{
+  WritePollingLoop();
+  WriteCode(FUNCTION_ADDRESS, {LWZ(3, 4, 0), STW(3, 4, 4), BLR});
+
+  const PPCAnalyst::CodeOp& branch = AnalyzeLoop();
+  EXPECT_EQ(m_code_block.m_num_instructions, 1u);
+  EXPECT_FALSE(branch.branchIsIdleLoop);
+}
+
+TEST_F(PPCAnalystTest, LeafFunctionInliningDisabled)
+{
+  WritePollingLoop();
+  WriteCode(FUNCTION_ADDRESS, {LWZ(3, 4, 0), BLR});
+
+  // Without the setting, the block formation doesn't change.
+  m_analyzer.SetLeafFunctionInliningEnabled(false);
+  EXPECT_EQ(AnalyzeLoop().address, LOOP_ADDRESS);
+  EXPECT_EQ(m_code_block.m_num_instructions, 1u);
+
+  // Nor does it for CPU cores which can't continue blocks after a call.
+  m_analyzer.SetLeafFunctionInliningEnabled(true);
+  m_analyzer.ClearOption(PPCAnalyst::PPCAnalyzer::OPTION_LEAF_FUNCTION_INLINE);
+  EXPECT_EQ(AnalyzeLoop().address, LOOP_ADDRESS);
+  EXPECT_EQ(m_code_block.m_num_instructions, 1u);
+}